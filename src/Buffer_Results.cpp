@@ -0,0 +1,105 @@
+#include "Buffer_Results.h"
+
+#include <minwindef.h>
+
+#include <cstddef>
+#include <iterator>
+#include <utility>
+
+namespace Linter
+{
+
+Buffer_Results::~Buffer_Results() = default;
+
+Buffer_Results::Results const *Buffer_Results::find(
+    Buffer_ID buffer, LRESULT length, unsigned int settings_generation
+)
+{
+    auto const pos = index_.find(buffer);
+    if (pos == index_.end())
+    {
+        return nullptr;
+    }
+    auto const entry = pos->second;
+    if (entry->results.length != length
+        or entry->results.settings_generation != settings_generation)
+    {
+        erase(entry);
+        return nullptr;
+    }
+    // Move it to the front so it's the last thing to be evicted.
+    entries_.splice(entries_.begin(), entries_, entry);
+    return &entry->results;
+}
+
+bool Buffer_Results::contains(Buffer_ID buffer) const noexcept
+{
+    return index_.contains(buffer);
+}
+
+void Buffer_Results::store(Buffer_ID buffer, Results results)
+{
+    erase(buffer);
+    std::size_t const bytes = size_of(results);
+    if (bytes > budget_)
+    {
+        // This would push everything else out and then get evicted itself.
+        return;
+    }
+    entries_.push_front(
+        Entry{.buffer = buffer, .results = std::move(results), .bytes = bytes}
+    );
+    index_.emplace(buffer, entries_.begin());
+    bytes_ += bytes;
+    evict();
+}
+
+void Buffer_Results::erase(Buffer_ID buffer) noexcept
+{
+    if (auto const pos = index_.find(buffer); pos != index_.end())
+    {
+        erase(pos->second);
+    }
+}
+
+void Buffer_Results::set_budget(std::size_t bytes) noexcept
+{
+    budget_ = bytes;
+    evict();
+}
+
+void Buffer_Results::clear() noexcept
+{
+    index_.clear();
+    entries_.clear();
+    bytes_ = 0;
+}
+
+std::size_t Buffer_Results::size_of(Results const &results) noexcept
+{
+    // This is an estimate, as it ignores the overhead of the allocations,
+    // but is good enough for keeping the size under control.
+    constexpr std::size_t highlight_bytes =
+        sizeof(Highlights::value_type) + 4 * sizeof(void *);
+    return sizeof(Entry) + results.errors.bytes()
+         + results.system_errors.bytes()
+         + results.highlights.size() * highlight_bytes
+         + results.error_ranges.bytes();
+}
+
+void Buffer_Results::erase(Entries::iterator entry) noexcept
+{
+    bytes_ -= entry->bytes;
+    index_.erase(entry->buffer);
+    entries_.erase(entry);
+}
+
+void Buffer_Results::evict() noexcept
+{
+    while (bytes_ > budget_ and not entries_.empty())
+    {
+        erase(std::prev(entries_.end()));
+    }
+}
+
+}    // namespace Linter
@@ -0,0 +1,128 @@
+#pragma once
+
+#include "Error_Highlights.h"
+#include "Error_Ranges.h"
+#include "Error_Store.h"
+
+#include <basetsd.h>
+#include <minwindef.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <optional>
+#include <unordered_map>
+
+namespace Linter
+{
+
+/** Saves the results of the last lint of each open buffer.
+ *
+ * Without this, switching to another tab would throw away the results and
+ * lint the buffer again, even though it can't have changed. This keeps the
+ * results, the error indicator positions and the contents of the results
+ * window, so they can be shown again straight away.
+ *
+ * Notepad++ keeps the error indicators with the buffer, so they are still in
+ * the editor when we switch back to it, and we only need to remember where
+ * they are.
+ *
+ * The saved results are limited to a given number of bytes. When they get
+ * too big, the least recently used buffers are discarded.
+ *
+ * This is only used from the notepad++ thread.
+ */
+class Buffer_Results
+{
+  public:
+    using Buffer_ID = UINT_PTR;
+
+    using Highlights = Error_Highlights;
+
+    struct Results
+    {
+        /** The lint errors */
+        Error_Store errors;
+
+        /** The system errors shown in the results window */
+        Error_Store system_errors;
+
+        Highlights highlights;
+
+        Error_Ranges error_ranges;
+
+        /** Buffer length, in case it was reloaded without us noticing */
+        LRESULT length;
+
+        /** The generation of the settings used for the lint */
+        unsigned int settings_generation;
+
+        /** Set if the file was linted from disk while it wasn't the current
+         * buffer. The buffer contents have to be checked against this before
+         * the results are used, and the errors haven't been highlighted.
+         */
+        std::optional<std::uint64_t> text_hash;
+    };
+
+    Buffer_Results() = default;
+
+    Buffer_Results(Buffer_Results const &) = delete;
+    Buffer_Results(Buffer_Results &&) = delete;
+    Buffer_Results &operator=(Buffer_Results const &) = delete;
+    Buffer_Results &operator=(Buffer_Results &&) = delete;
+
+    ~Buffer_Results();
+
+    /** Get the results for a buffer, or nullptr if we don't have any or they
+     * are out of date.
+     *
+     * The pointer is valid until the results are next changed.
+     */
+    Results const *find(
+        Buffer_ID, LRESULT length, unsigned int settings_generation
+    );
+
+    /** Returns true if there are results for the buffer */
+    bool contains(Buffer_ID) const noexcept;
+
+    /** Save the results for a buffer */
+    void store(Buffer_ID, Results);
+
+    /** Forget the results for a buffer, because it has been changed or
+     * closed.
+     */
+    void erase(Buffer_ID) noexcept;
+
+    /** Set the maximum number of bytes to use. 0 disables saving results. */
+    void set_budget(std::size_t bytes) noexcept;
+
+    /** Throw everything away */
+    void clear() noexcept;
+
+  private:
+    struct Entry
+    {
+        Buffer_ID buffer;
+        Results results;
+        std::size_t bytes;
+    };
+
+    // Most recently used at the front
+    using Entries = std::list<Entry>;
+
+    static std::size_t size_of(Results const &) noexcept;
+
+    void erase(Entries::iterator) noexcept;
+
+    void evict() noexcept;
+
+    Entries entries_;
+
+    std::unordered_map<Buffer_ID, Entries::iterator> index_;
+
+    std::size_t budget_{0};
+
+    std::size_t bytes_{0};
+};
+
+}    // namespace Linter
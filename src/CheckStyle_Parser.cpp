@@ -1,25 +1,580 @@
 #include "Checkstyle_Parser.h"
 
-#include "Dom_Document.h"
-#include "Dom_Node.h"
-#include "Dom_Node_List.h"
-#include "Error_Info.h"
 #include "Encoding.h"
+#include "Error_Info.h"
+#include "Trace.h"
+#include "XML_Decode_Error.h"
 
+#include <algorithm>
+#include <charconv>
 #include <cstddef>
+#include <cstdint>
 #include <string>
+#include <string_view>
+#include <system_error>
+#include <utility>
 #include <vector>
 
 namespace Linter
 {
 
-std::vector<Error_Info> Checkstyle_Parser::get_errors(std::string const &input)
+namespace
+{
+
+/** A small non-validating xml parser which picks out the <error> elements.
+ *
+ * This works directly on the UTF-8 output from the linter, and only converts
+ * the attributes we actually use, which is a lot quicker than building a DOM
+ * document and querying it, especially when there are a lot of errors.
+ *
+ * It checks that the xml is well formed, so rubbish output is reported as an
+ * error rather than being quietly ignored.
+ */
+class Parser
 {
-    // This is an xml file so first thing we do is to make it into a wide string.
-    // This is a bit of an assumption bit the msxml parser expects UTF-8
-    // input and this is what most linters produce, so it seems reasonable.
-    Dom_Document const document{Encoding::convert(input)};
+  public:
+    Parser(
+        std::string_view input,
+        Checkstyle_Parser::Error_Callback const &callback
+    ) noexcept :
+        input_(input),
+        callback_(callback)
+    {
+    }
+
+    void parse();
+
+  private:
+    struct Attribute
+    {
+        std::string_view name;
+        std::string_view value;
+    };
+
+    [[noreturn]] void fail(std::string const &reason) const
+    {
+        fail_at(pos_, reason);
+    }
+
+    [[noreturn]] void fail_at(std::size_t pos, std::string const &reason) const;
+
+    bool at_end() const noexcept
+    {
+        return pos_ >= input_.size();
+    }
+
+    bool starts_with(std::string_view str) const noexcept
+    {
+        return input_.substr(pos_).starts_with(str);
+    }
+
+    /** Returns true if any whitespace was skipped */
+    bool skip_whitespace() noexcept;
+
+    void skip_past(std::string_view prefix, std::string_view terminator);
+
+    void skip_doctype();
+
+    std::string_view read_name();
+
+    void read_start_tag();
+
+    void read_end_tag();
+
+    void read_text();
+
+    /** Decode the entity reference at pos, appending the value as UTF-8.
+     *
+     * Returns the position after the reference.
+     */
+    std::size_t read_reference(std::size_t pos, std::string &out) const;
+
+    std::wstring decode(std::string_view value) const;
 
+    /** Get the value of a numeric attribute of the element starting at
+     * start. The attribute must be present.
+     */
+    int decode_number(std::size_t start, std::string_view name) const;
+
+    /** Returns nullptr if the current element doesn't have the attribute */
+    Attribute const *find_attribute(std::string_view name) const noexcept;
+
+    std::string_view attribute(std::string_view name) const noexcept;
+
+    void process_error(std::size_t start) const;
+
+    std::string_view input_;
+
+    Checkstyle_Parser::Error_Callback const &callback_;
+
+    std::size_t pos_{0};
+
+    // The names of the currently open elements
+    std::vector<std::string_view> open_elements_;
+
+    // The attributes of the current element
+    std::vector<Attribute> attributes_;
+
+    // Scratch space for checking entity references in text
+    std::string scratch_;
+};
+
+void Parser::parse()
+{
+    if (starts_with("\xEF\xBB\xBF"))
+    {
+        pos_ += 3;
+    }
+
+    bool seen_root = false;
+    for (;;)
+    {
+        if (open_elements_.empty())
+        {
+            skip_whitespace();
+            if (at_end())
+            {
+                break;
+            }
+            if (input_[pos_] != '<')
+            {
+                fail("Text is not allowed outside the root element");
+            }
+        }
+        else if (at_end())
+        {
+            fail(
+                "Unexpected end of output in element '"
+                + std::string(open_elements_.back()) + "'"
+            );
+        }
+
+        if (starts_with("<?"))
+        {
+            skip_past("<?", "?>");
+        }
+        else if (starts_with("<!--"))
+        {
+            skip_past("<!--", "-->");
+        }
+        else if (starts_with("<![CDATA["))
+        {
+            if (open_elements_.empty())
+            {
+                fail("CDATA is not allowed outside the root element");
+            }
+            skip_past("<![CDATA[", "]]>");
+        }
+        else if (starts_with("<!DOCTYPE"))
+        {
+            if (seen_root)
+            {
+                fail("DOCTYPE is only allowed before the root element");
+            }
+            skip_doctype();
+        }
+        else if (starts_with("</"))
+        {
+            read_end_tag();
+        }
+        else if (input_[pos_] == '<')
+        {
+            if (seen_root and open_elements_.empty())
+            {
+                fail("Only one root element is allowed");
+            }
+            read_start_tag();
+            seen_root = true;
+        }
+        else
+        {
+            read_text();
+        }
+    }
+
+    if (not seen_root)
+    {
+        fail("No root element found");
+    }
+}
+
+void Parser::fail_at(std::size_t pos, std::string const &reason) const
+{
+    // Work out the line and column (in characters) for the error message.
+    auto const before = input_.substr(0, pos);
+    auto const line_start = before.rfind('\n');
+    auto const line = std::count(before.begin(), before.end(), '\n') + 1;
+    auto const line_text = before.substr(
+        line_start == std::string_view::npos ? 0 : line_start + 1
+    );
+    auto const column =
+        std::count_if(
+            line_text.begin(),
+            line_text.end(),
+            [](char chr) noexcept
+            { return (static_cast<unsigned char>(chr) & 0xC0) != 0x80; }
+        )
+        + 1;
+    throw XML_Decode_Error(
+        reason, static_cast<long>(line), static_cast<long>(column)
+    );
+}
+
+bool Parser::skip_whitespace() noexcept
+{
+    auto const start = pos_;
+    while (not at_end()
+           and (input_[pos_] == ' ' or input_[pos_] == '\t'
+                or input_[pos_] == '\r' or input_[pos_] == '\n'))
+    {
+        pos_ += 1;
+    }
+    return pos_ != start;
+}
+
+void Parser::skip_past(std::string_view prefix, std::string_view terminator)
+{
+    auto const end = input_.find(terminator, pos_ + prefix.size());
+    if (end == std::string_view::npos)
+    {
+        fail("Couldn't find closing '" + std::string(terminator) + "'");
+    }
+    pos_ = end + terminator.size();
+}
+
+void Parser::skip_doctype()
+{
+    // This can contain an internal subset in []s, and quoted strings, either
+    // of which could contain a '>'.
+    int depth = 0;
+    char quote = 0;
+    for (auto pos = pos_; pos < input_.size(); ++pos)
+    {
+        char const chr = input_[pos];
+        if (quote != 0)
+        {
+            if (chr == quote)
+            {
+                quote = 0;
+            }
+        }
+        else if (chr == '"' or chr == '\'')
+        {
+            quote = chr;
+        }
+        else if (chr == '[')
+        {
+            depth += 1;
+        }
+        else if (chr == ']')
+        {
+            depth -= 1;
+        }
+        else if (chr == '>' and depth == 0)
+        {
+            pos_ = pos + 1;
+            return;
+        }
+    }
+    fail("Unterminated DOCTYPE");
+}
+
+std::string_view Parser::read_name()
+{
+    auto const start = pos_;
+    while (not at_end())
+    {
+        char const chr = input_[pos_];
+        if (chr == ' ' or chr == '\t' or chr == '\r' or chr == '\n'
+            or chr == '/' or chr == '>' or chr == '=' or chr == '<'
+            or chr == '"' or chr == '\'')
+        {
+            break;
+        }
+        pos_ += 1;
+    }
+    if (pos_ == start)
+    {
+        fail("Expected a name");
+    }
+    auto const first = input_[start];
+    if ((first >= '0' and first <= '9') or first == '-' or first == '.')
+    {
+        fail_at(
+            start, "Names can't start with '" + std::string(1, first) + "'"
+        );
+    }
+    return input_.substr(start, pos_ - start);
+}
+
+void Parser::read_start_tag()
+{
+    auto const start = pos_;
+    pos_ += 1;
+    auto const name = read_name();
+
+    attributes_.clear();
+    for (;;)
+    {
+        bool const had_space = skip_whitespace();
+        if (at_end())
+        {
+            fail("Unterminated start tag for '" + std::string(name) + "'");
+        }
+        if (input_[pos_] == '>')
+        {
+            pos_ += 1;
+            open_elements_.push_back(name);
+            break;
+        }
+        if (starts_with("/>"))
+        {
+            pos_ += 2;
+            break;
+        }
+        if (not had_space)
+        {
+            fail("Expected whitespace before attribute name");
+        }
+
+        auto const attribute_name = read_name();
+        skip_whitespace();
+        if (at_end() or input_[pos_] != '=')
+        {
+            fail("Expected '=' after attribute name");
+        }
+        pos_ += 1;
+        skip_whitespace();
+        if (at_end() or (input_[pos_] != '"' and input_[pos_] != '\''))
+        {
+            fail("Expected a quoted attribute value");
+        }
+        char const quote = input_[pos_];
+        pos_ += 1;
+        auto const end = input_.find(quote, pos_);
+        if (end == std::string_view::npos)
+        {
+            fail("Unterminated attribute value");
+        }
+        auto const value = input_.substr(pos_, end - pos_);
+        if (auto const bad = value.find('<'); bad != std::string_view::npos)
+        {
+            fail_at(pos_ + bad, "'<' is not allowed in attribute values");
+        }
+        for (auto const &attribute : attributes_)
+        {
+            if (attribute.name == attribute_name)
+            {
+                fail(
+                    "Duplicate attribute '" + std::string(attribute_name) + "'"
+                );
+            }
+        }
+        attributes_.push_back({.name = attribute_name, .value = value});
+        pos_ = end + 1;
+    }
+
+    if (name == "error")
+    {
+        process_error(start);
+    }
+}
+
+void Parser::read_end_tag()
+{
+    auto const start = pos_;
+    pos_ += 2;
+    auto const name = read_name();
+    skip_whitespace();
+    if (at_end() or input_[pos_] != '>')
+    {
+        fail("Expected '>' at end of end tag");
+    }
+    pos_ += 1;
+    if (open_elements_.empty())
+    {
+        fail_at(start, "Unexpected end tag '" + std::string(name) + "'");
+    }
+    if (open_elements_.back() != name)
+    {
+        fail_at(
+            start,
+            "End tag '" + std::string(name) + "' does not match start tag '"
+                + std::string(open_elements_.back()) + "'"
+        );
+    }
+    open_elements_.pop_back();
+}
+
+void Parser::read_text()
+{
+    // We don't care about the text, but we do check any entities are valid.
+    auto end = input_.find('<', pos_);
+    if (end == std::string_view::npos)
+    {
+        end = input_.size();
+    }
+    for (auto pos = input_.find('&', pos_); pos < end;
+         pos = input_.find('&', pos))
+    {
+        scratch_.clear();
+        pos = read_reference(pos, scratch_);
+    }
+    pos_ = end;
+}
+
+std::size_t Parser::read_reference(std::size_t pos, std::string &out) const
+{
+    auto const end = input_.find(';', pos);
+    if (end == std::string_view::npos)
+    {
+        fail_at(pos, "Unterminated entity reference");
+    }
+    auto const name = input_.substr(pos + 1, end - pos - 1);
+
+    static std::pair<std::string_view, char> const entities[] = {
+        {"lt",   '<' },
+        {"gt",   '>' },
+        {"amp",  '&' },
+        {"quot", '"' },
+        {"apos", '\''}
+    };
+    for (auto const &[entity, chr] : entities)
+    {
+        if (name == entity)
+        {
+            out += chr;
+            return end + 1;
+        }
+    }
+
+    if (not name.starts_with('#'))
+    {
+        fail_at(pos, "Unknown entity '&" + std::string(name) + ";'");
+    }
+
+    // Character reference
+    auto digits = name.substr(1);
+    int base = 10;
+    if (digits.starts_with('x'))
+    {
+        digits.remove_prefix(1);
+        base = 16;
+    }
+    std::uint32_t code = 0;
+    auto const [ptr, errc] = std::from_chars(
+        digits.data(), digits.data() + digits.size(), code, base
+    );
+    if (digits.empty() or errc != std::errc{}
+        or ptr != digits.data() + digits.size() or code == 0 or code > 0x10FFFF
+        or (code >= 0xD800 and code <= 0xDFFF))
+    {
+        fail_at(
+            pos, "Invalid character reference '&" + std::string(name) + ";'"
+        );
+    }
+
+    // Encode as UTF-8
+    if (code < 0x80)
+    {
+        out += static_cast<char>(code);
+    }
+    else if (code < 0x800)
+    {
+        out += static_cast<char>(0xC0 | (code >> 6));
+        out += static_cast<char>(0x80 | (code & 0x3F));
+    }
+    else if (code < 0x10000)
+    {
+        out += static_cast<char>(0xE0 | (code >> 12));
+        out += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (code & 0x3F));
+    }
+    else
+    {
+        out += static_cast<char>(0xF0 | (code >> 18));
+        out += static_cast<char>(0x80 | ((code >> 12) & 0x3F));
+        out += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (code & 0x3F));
+    }
+    return end + 1;
+}
+
+std::wstring Parser::decode(std::string_view value) const
+{
+    if (value.find_first_of("&\t\r\n") == std::string_view::npos)
+    {
+        // The usual case.
+        return Encoding::convert(value);
+    }
+
+    // Attribute values have entities replaced, and each line end or tab
+    // replaced with a space.
+    auto const offset = static_cast<std::size_t>(value.data() - input_.data());
+    std::string decoded;
+    decoded.reserve(value.size());
+    for (std::size_t pos = 0; pos < value.size();)
+    {
+        char const chr = value[pos];
+        if (chr == '&')
+        {
+            pos = read_reference(offset + pos, decoded) - offset;
+            continue;
+        }
+        if (chr == '\r' and pos + 1 < value.size() and value[pos + 1] == '\n')
+        {
+            pos += 1;
+        }
+        decoded += chr == '\t' or chr == '\r' or chr == '\n' ? ' ' : chr;
+        pos += 1;
+    }
+    return Encoding::convert(decoded);
+}
+
+int Parser::decode_number(std::size_t start, std::string_view name) const
+{
+    auto const *const found = find_attribute(name);
+    if (found == nullptr)
+    {
+        fail_at(
+            start, "Missing '" + std::string(name) + "' attribute in 'error'"
+        );
+    }
+    auto const value = found->value;
+    int result = 0;
+    auto const [ptr, errc] =
+        std::from_chars(value.data(), value.data() + value.size(), result);
+    if (errc != std::errc{} or ptr != value.data() + value.size())
+    {
+        fail_at(
+            static_cast<std::size_t>(value.data() - input_.data()),
+            "Invalid number '" + std::string(value) + "'"
+        );
+    }
+    return result;
+}
+
+Parser::Attribute const *Parser::find_attribute(std::string_view name
+) const noexcept
+{
+    for (auto const &attribute : attributes_)
+    {
+        if (attribute.name == name)
+        {
+            return &attribute;
+        }
+    }
+    return nullptr;
+}
+
+std::string_view Parser::attribute(std::string_view name) const noexcept
+{
+    auto const *const found = find_attribute(name);
+    return found == nullptr ? std::string_view{} : found->value;
+}
+
+void Parser::process_error(std::size_t start) const
+{
     // Sample errors:
     //
     // <error line="12" column="19" severity="error" message="Unexpected
@@ -34,30 +589,46 @@ std::vector<Error_Info> Checkstyle_Parser::get_errors(std::string const &input)
     // column="1" line="83" />
     //
     // We use the 1st word in source as the tool.
-
-    std::vector<Error_Info> errors;
-
-    Dom_Node_List const nodes(document.get_node_list("//error"));
-    for (auto const node : nodes)
+    auto source = attribute("source");
+    if (auto const pos = source.find('.'); pos != std::string_view::npos)
     {
-        std::wstring tool{node.get_attribute(L"source")};
-        std::size_t const pos = tool.find_first_of('.');
-        if (pos != std::string::npos)
-        {
-            tool.resize(pos);
-        }
-
-        errors.push_back(Error_Info{
-            .message_ = node.get_attribute(L"message"),
-            .severity_ = node.get_attribute(L"severity"),
-            .tool_ = tool,
-            .mode_ = Error_Info::Standard,
-            .line_ = std::stoi(node.get_attribute(L"line")),
-            .column_ = std::stoi(node.get_attribute(L"column"))
-        });
+        source = source.substr(0, pos);
     }
 
+    callback_(Error_Info{
+        .message_ = decode(attribute("message")),
+        .severity_ = decode(attribute("severity")),
+        .tool_ = decode(source),
+        .command_ = {},
+        .stdout_ = {},
+        .stderr_ = {},
+        .mode_ = Error_Info::Standard,
+        .line_ = decode_number(start, "line"),
+        .column_ = decode_number(start, "column"),
+        .result_ = 0
+    });
+}
+
+}    // namespace
+
+std::vector<Error_Info> Checkstyle_Parser::get_errors(std::string const &input)
+{
+    std::vector<Error_Info> errors;
+    get_errors(
+        input,
+        [&errors](Error_Info &&error) { errors.push_back(std::move(error)); }
+    );
     return errors;
 }
 
+void Checkstyle_Parser::get_errors(
+    std::string const &input, Error_Callback const &callback
+)
+{
+    Trace::Span const span{"Parse linter output"};
+
+    // We assume the output is UTF-8, as this is what most linters produce.
+    Parser{input, callback}.parse();
+}
+
 }    // namespace Linter
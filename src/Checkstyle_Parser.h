@@ -1,5 +1,6 @@
 #pragma once
 
+#include <functional>
 #include <string>
 #include <vector>
 
@@ -11,7 +12,16 @@ struct Error_Info;
 class Checkstyle_Parser
 {
   public:
+    /** Called for each error as it is found */
+    using Error_Callback = std::function<void(Error_Info &&)>;
+
     static std::vector<Error_Info> get_errors(std::string const &);
+
+    /** Parse the checkstyle output, calling the callback for each error.
+     *
+     * Throws XML_Decode_Error if the output isn't valid xml.
+     */
+    static void get_errors(std::string const &, Error_Callback const &);
 };
 
 }    // namespace Linter
@@ -1,20 +1,32 @@
 #include "Child_Pipe.h"
 
 #include "Handle_Wrapper.h"
+#include "Output_Reader.h"
 #include "System_Error.h"
+#include "Trace.h"
 
 #include <errhandlingapi.h>
 #include <fileapi.h>
 #include <handleapi.h>
 #include <intsafe.h>
+#include <ioapiset.h>
 #include <minwinbase.h>
 #include <minwindef.h>
 #include <namedpipeapi.h>
+#include <processthreadsapi.h>
 #include <synchapi.h>
 #include <winbase.h>
 #include <winerror.h>
 #include <winnt.h>
 
+#include <wil/resource.h>
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <format>
+#include <functional>
+#include <stop_token>
 #include <string>
 #include <utility>
 #include <vector>
@@ -31,7 +43,7 @@ Child_Pipe Child_Pipe::create_input_pipe()
 
 Child_Pipe Child_Pipe::create_output_pipe()
 {
-    Child_Pipe pipe;
+    Child_Pipe pipe{create_overlapped_pipes()};
     detach(pipe.pipes_.reader_);
     return pipe;
 }
@@ -39,44 +51,251 @@ Child_Pipe Child_Pipe::create_output_pipe()
 namespace
 {
 
-constexpr DWORD BUFFSIZE = 0x4000;
+constexpr DWORD BUFFSIZE = 0x10000;
+
+/** Create a manual reset event */
+wil::unique_handle create_event()
+{
+    wil::unique_handle event{CreateEvent(nullptr, TRUE, FALSE, nullptr)};
+    if (not event)
+    {
+        throw System_Error();
+    }
+    return event;
+}
 
-DWORD read_data(char * const buff, Handle_Wrapper const &pipe)
+/** Event that gets signalled when a stop is requested */
+class Stop_Event
 {
-    DWORD bytes_avail = 0;
-    if (PeekNamedPipe(pipe, nullptr, 0, nullptr, &bytes_avail, nullptr) == FALSE)
+  public:
+    explicit Stop_Event(std::stop_token const &stop_token) :
+        event_(create_event()),
+        callback_(
+            stop_token, [this]() noexcept { SetEvent(event_.get()); }
+        )
+    {
+    }
+
+    HANDLE get() const noexcept
     {
-        DWORD const err = GetLastError();
-        if (err != ERROR_BROKEN_PIPE)
+        return event_.get();
+    }
+
+  private:
+    // NB: This must be declared before callback_, as the callback can be
+    // invoked immediately.
+    wil::unique_handle event_;
+    std::stop_callback<std::function<void()>> callback_;
+};
+
+/** Manages overlapped reads on one pipe.
+ *
+ * A read is kept outstanding at all times till the pipe is closed by the
+ * other end, so the event is signalled as soon as data arrives.
+ */
+class Pipe_Reader
+{
+  public:
+    Pipe_Reader(HANDLE pipe, std::string &output) :
+        pipe_(pipe),
+        event_(create_event()),
+        buffer_(BUFFSIZE),
+        output_(output)
+    {
+        overlapped_.hEvent = event_.get();
+        start_read();
+    }
+
+    Pipe_Reader(Pipe_Reader const &) = delete;
+    Pipe_Reader(Pipe_Reader &&) = delete;
+    Pipe_Reader &operator=(Pipe_Reader const &) = delete;
+    Pipe_Reader &operator=(Pipe_Reader &&) = delete;
+
+    ~Pipe_Reader()
+    {
+        // We can't let the overlapped structure and buffer go away while the
+        // system might still write to them.
+        if (pending_)
         {
+            CancelIoEx(pipe_, &overlapped_);
+            DWORD bytes_read;    // NOLINT(cppcoreguidelines-init-variables)
+            GetOverlappedResult(pipe_, &overlapped_, &bytes_read, TRUE);
+        }
+    }
+
+    /** Event which is signalled when the outstanding read completes */
+    HANDLE event() const noexcept
+    {
+        return event_.get();
+    }
+
+    /** Returns true if there is a read outstanding */
+    bool pending() const noexcept
+    {
+        return pending_;
+    }
+
+    /** Called when the event is signalled */
+    void read_completed()
+    {
+        pending_ = false;
+        DWORD bytes_read;    // NOLINT(cppcoreguidelines-init-variables)
+        if (GetOverlappedResult(pipe_, &overlapped_, &bytes_read, FALSE)
+            == FALSE)
+        {
+            DWORD const err = GetLastError();
+            if (err == ERROR_BROKEN_PIPE)
+            {
+                // Writer has closed the pipe.
+                return;
+            }
             throw System_Error(err);
         }
+        output_.append(buffer_.data(), bytes_read);
+        start_read();
+    }
+
+  private:
+    /** Start a new read, consuming anything that's already available */
+    void start_read()
+    {
+        for (;;)
+        {
+            if (ReadFile(pipe_, buffer_.data(), BUFFSIZE, nullptr, &overlapped_)
+                == FALSE)
+            {
+                DWORD const err = GetLastError();
+                if (err == ERROR_IO_PENDING)
+                {
+                    pending_ = true;
+                    return;
+                }
+                if (err == ERROR_BROKEN_PIPE)
+                {
+                    return;
+                }
+                throw System_Error(err);
+            }
+            // The read completed immediately, so there may be more data.
+            DWORD bytes_read;    // NOLINT(cppcoreguidelines-init-variables)
+            if (GetOverlappedResult(pipe_, &overlapped_, &bytes_read, FALSE)
+                == FALSE)
+            {
+                throw System_Error();
+            }
+            output_.append(buffer_.data(), bytes_read);
+        }
+    }
+
+    HANDLE pipe_;
+    wil::unique_handle event_;
+    OVERLAPPED overlapped_{};
+    std::vector<char> buffer_;
+    std::string &output_;
+    bool pending_{false};
+};
+
+/** Reads the output pipes of a process, waiting for the pipe reads to
+ * complete, the process to exit or the stop event to be signalled.
+ */
+class Process_Output_Reader : public Output_Reader
+{
+  public:
+    Process_Output_Reader(
+        HANDLE process, Child_Pipe const &pipe1, std::string &output1,
+        Child_Pipe const &pipe2, std::string &output2,
+        std::stop_token const &stop_token
+    ) :
+        process_(process),
+        stop_event_(stop_token),
+        reader1_(pipe1.reader(), output1),
+        reader2_(pipe2.reader(), output2)
+    {
+    }
+
+    Process_Output_Reader(Process_Output_Reader const &) = delete;
+    Process_Output_Reader(Process_Output_Reader &&) = delete;
+    Process_Output_Reader &operator=(Process_Output_Reader const &) = delete;
+    Process_Output_Reader &operator=(Process_Output_Reader &&) = delete;
+
+    ~Process_Output_Reader() override = default;
+
+  private:
+    bool is_open(std::size_t pipe) const override
+    {
+        return reader(pipe).pending();
     }
-    if (bytes_avail != 0)
+
+    Wakeup wait(bool running) override
     {
-        if (ReadFile(
-                pipe,
-                buff,
-                std::min(BUFFSIZE, bytes_avail),
-                &bytes_avail,
-                nullptr
-            ) == FALSE)
+        std::array<HANDLE, 4> handles{};
+        std::array<Wakeup, 4> wakeups{};
+        DWORD count = 0;
+        auto const add = [&](HANDLE handle, Event event, std::size_t pipe)
+        {
+            handles.at(count) = handle;
+            wakeups.at(count) = {.event = event, .pipe = pipe};
+            count += 1;
+        };
+
+        // WaitForMultipleObjects reports the first handle which is signalled,
+        // which gives the order Output_Reader wants.
+        add(stop_event_.get(), Event::Stopped, 0);
+        for (std::size_t pipe = 0; pipe < 2; pipe += 1)
+        {
+            if (reader(pipe).pending())
+            {
+                add(reader(pipe).event(), Event::Output, pipe);
+            }
+        }
+        if (running)
+        {
+            add(process_, Event::Exited, 0);
+        }
+
+        auto const state = WaitForMultipleObjects(
+            count, handles.data(), FALSE, running ? INFINITE : 0
+        );
+        if (state == WAIT_FAILED)
         {
             throw System_Error();
         }
+        if (state == WAIT_TIMEOUT)
+        {
+            return {.event = Event::Timed_Out, .pipe = 0};
+        }
+        return wakeups.at(state - WAIT_OBJECT_0);
     }
-    return bytes_avail;
-}
+
+    void read_pipe(std::size_t pipe) override
+    {
+        reader(pipe).read_completed();
+    }
+
+    Pipe_Reader const &reader(std::size_t pipe) const noexcept
+    {
+        return pipe == 0 ? reader1_ : reader2_;
+    }
+
+    Pipe_Reader &reader(std::size_t pipe) noexcept
+    {
+        return pipe == 0 ? reader1_ : reader2_;
+    }
+
+    HANDLE process_;
+    Stop_Event stop_event_;
+    Pipe_Reader reader1_;
+    Pipe_Reader reader2_;
+};
 
 }    // namespace
 
 std::pair<std::string, std::string> Child_Pipe::read_output_pipes(
-    HANDLE process, Child_Pipe const &pipe1, Child_Pipe const &pipe2
+    HANDLE process, Child_Pipe const &pipe1, Child_Pipe const &pipe2,
+    std::stop_token const &stop_token
 )
 {
-    std::vector<char> buffer;
-    buffer.resize(BUFFSIZE);
-    char * const buff{&*buffer.begin()};
+    Trace::Span const span{"Read linter output"};
 
     std::string res1;
     std::string res2;
@@ -85,27 +304,11 @@ std::pair<std::string, std::string> Child_Pipe::read_output_pipes(
     pipe1.writer().close();
     pipe2.writer().close();
 
-    // Unfortunately, WaitForMultiple object doesn't support anonymous pipes and
-    // will behave as though they'd had an event every time you call the
-    // function. So instead, we call WaitForSingleObject with a short timeout.
-    // If we time out, the called process is still running, so we read any data
-    // that's available on the two pipes. If we don't timeout, then the process
-    // is no longer running, so we consume all the data left on the pipes and
-    // then break out of the loop.
-    bool more_to_read = true;
-    while (more_to_read)
-    {
-        auto const state = WaitForSingleObject(process, 50);
-        if (state == WAIT_FAILED)
-        {
-            throw System_Error();
-        }
-
-        more_to_read = state == WAIT_TIMEOUT;
+    Process_Output_Reader reader{
+        process, pipe1, res1, pipe2, res2, stop_token
+    };
+    reader.read();
 
-        res1.append(buff, read_data(buff, pipe1.reader()));
-        res2.append(buff, read_data(buff, pipe2.reader()));
-    }
     return std::make_pair(res1, res2);
 }
 
@@ -114,6 +317,10 @@ Child_Pipe::Child_Pipe() : pipes_(create_pipes())
 {
 }
 
+Child_Pipe::Child_Pipe(Pipes &&pipes) noexcept : pipes_(std::move(pipes))
+{
+}
+
 Child_Pipe::Pipes Child_Pipe::create_pipes()
 {
     SECURITY_ATTRIBUTES security = {
@@ -132,6 +339,48 @@ Child_Pipe::Pipes Child_Pipe::create_pipes()
     return {.reader_ = Handle_Wrapper(reader), .writer_ = Handle_Wrapper(writer)};
 }
 
+Child_Pipe::Pipes Child_Pipe::create_overlapped_pipes()
+{
+    // Anonymous pipes don't support overlapped I/O, so we have to create a
+    // named pipe with a unique name instead. Only the reading end (which we
+    // keep) is overlapped, as the child process won't be expecting it.
+    static std::atomic<unsigned long> serial_number{0};
+    std::wstring const name = std::format(
+        L"\\\\.\\pipe\\LinterPP.{}.{}",
+        GetCurrentProcessId(),
+        serial_number++
+    );
+
+    SECURITY_ATTRIBUTES security = {
+        .nLength = sizeof(SECURITY_ATTRIBUTES),
+        .lpSecurityDescriptor = nullptr,
+        .bInheritHandle = TRUE,
+    };
+
+    Handle_Wrapper reader{CreateNamedPipe(
+        name.c_str(),
+        PIPE_ACCESS_INBOUND | FILE_FLAG_OVERLAPPED | FILE_FLAG_FIRST_PIPE_INSTANCE,
+        PIPE_TYPE_BYTE | PIPE_WAIT | PIPE_REJECT_REMOTE_CLIENTS,
+        1,
+        BUFFSIZE,
+        BUFFSIZE,
+        0,
+        &security
+    )};
+
+    Handle_Wrapper writer{CreateFile(
+        name.c_str(),
+        GENERIC_WRITE,
+        0,
+        &security,
+        OPEN_EXISTING,
+        FILE_ATTRIBUTE_NORMAL,
+        nullptr
+    )};
+
+    return {.reader_ = std::move(reader), .writer_ = std::move(writer)};
+}
+
 void Child_Pipe::detach(Handle_Wrapper const &handle)
 {
     if (::SetHandleInformation(handle, HANDLE_FLAG_INHERIT, 0) == FALSE)
@@ -4,6 +4,7 @@
 
 #include <winnt.h>
 
+#include <stop_token>
 #include <string>
 #include <utility>
 
@@ -26,8 +27,18 @@ class Child_Pipe
     static Child_Pipe create_output_pipe();
     static Child_Pipe create_input_pipe();
 
+    /** Read the output from the two pipes till the process exits.
+     *
+     * The pipes must have been created with create_output_pipe. Output is
+     * read as soon as it is available, and this returns as soon as the
+     * process has exited and the pipes have been drained.
+     *
+     * If a stop is requested, this returns without waiting for the process
+     * to exit, and the output will be incomplete.
+     */
     static std::pair<std::string, std::string> read_output_pipes(
-        HANDLE process, Child_Pipe const &pipe1, Child_Pipe const &pipe2
+        HANDLE process, Child_Pipe const &pipe1, Child_Pipe const &pipe2,
+        std::stop_token const &stop_token
     );
 
   private:
@@ -38,7 +49,9 @@ class Child_Pipe
     };
 
     Child_Pipe();
+    explicit Child_Pipe(Pipes &&) noexcept;
     static Child_Pipe::Pipes create_pipes();
+    static Child_Pipe::Pipes create_overlapped_pipes();
     static void detach(Handle_Wrapper const &);
 
     Pipes pipes_;
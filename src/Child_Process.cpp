@@ -0,0 +1,172 @@
+#include "Child_Process.h"
+
+#include "Handle_Wrapper.h"
+#include "System_Error.h"
+#include "Trace.h"
+
+#include "Plugin/Casts.h"
+
+#include <comutil.h>
+#include <errhandlingapi.h>
+#include <intsafe.h>
+#include <jobapi2.h>
+#include <minwindef.h>
+#include <processthreadsapi.h>
+#include <winbase.h>
+#include <winnt.h>
+
+#include <wil/resource.h>
+
+#include <cwchar>    // for wcsdup
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace Linter
+{
+
+Child_Process::Child_Process(
+    std::wstring const &program, std::wstring const &command_line,
+    std::wstring const &environment, std::filesystem::path const &directory,
+    HANDLE input, HANDLE output, HANDLE error
+) :
+    Child_Process(create(
+        program, command_line, environment, directory, input, output, error
+    ))
+{
+}
+
+Child_Process::Child_Process(PROCESS_INFORMATION const &proc_info) :
+    process_{proc_info.hProcess}
+{
+    Handle_Wrapper const thread{proc_info.hThread};
+
+    // Put the process in a job, so if we get cancelled we can kill anything it
+    // has started as well. The process is started suspended so it can't start
+    // anything before it's in the job. If we can't create the job, we fall
+    // back to just killing the process.
+    job_.reset(CreateJobObject(nullptr, nullptr));
+    if (job_ and not AssignProcessToJobObject(job_.get(), process_))
+    {
+        job_.reset();
+    }
+
+    if (ResumeThread(thread) == static_cast<DWORD>(-1))
+    {
+        DWORD const error{GetLastError()};
+        TerminateProcess(process_, error);
+        throw System_Error(error);
+    }
+}
+
+Child_Process::~Child_Process() = default;
+
+void Child_Process::terminate(DWORD exit_code) const noexcept
+{
+    if (job_)
+    {
+        TerminateJobObject(job_.get(), exit_code);
+    }
+    else
+    {
+        TerminateProcess(process_, exit_code);
+    }
+}
+
+DWORD Child_Process::exit_code() const
+{
+    DWORD exit_code;    // NOLINT(cppcoreguidelines-init-variables)
+    if (GetExitCodeProcess(process_, &exit_code) == FALSE)
+    {
+        throw System_Error();
+    }
+    return exit_code;
+}
+
+PROCESS_INFORMATION Child_Process::create(
+    std::wstring const &program, std::wstring const &command_line,
+    std::wstring const &environment, std::filesystem::path const &directory,
+    HANDLE input, HANDLE output, HANDLE error
+)
+{
+    Trace::Span const span{"Create process"};
+
+    // As we can be running several linters at once, we have to restrict the
+    // handles each child inherits to the ones intended for it. Otherwise one
+    // child can inherit the other pipes, which then don't get closed when
+    // the process they were intended for exits.
+    HANDLE inherited_handles[] = {input, output, error};
+
+    SIZE_T attribute_list_size = 0;
+    InitializeProcThreadAttributeList(nullptr, 1, 0, &attribute_list_size);
+    std::vector<char> attribute_list_buffer(attribute_list_size);
+    auto *const attribute_list =
+        reinterpret_cast<LPPROC_THREAD_ATTRIBUTE_LIST>(    // NOLINT
+            attribute_list_buffer.data()
+        );
+    if (not InitializeProcThreadAttributeList(
+            attribute_list, 1, 0, &attribute_list_size
+        ))
+    {
+        throw System_Error();
+    }
+    std::unique_ptr<
+        std::remove_pointer_t<LPPROC_THREAD_ATTRIBUTE_LIST>,
+        decltype(&DeleteProcThreadAttributeList)> const
+        attribute_list_deleter{attribute_list, &DeleteProcThreadAttributeList};
+
+    if (not UpdateProcThreadAttribute(
+            attribute_list,
+            0,
+            PROC_THREAD_ATTRIBUTE_HANDLE_LIST,
+            &inherited_handles[0],
+            sizeof(inherited_handles),
+            nullptr,
+            nullptr
+        ))
+    {
+        throw System_Error();
+    }
+
+    STARTUPINFOEX startup_info = {
+        .StartupInfo = {
+            .cb = sizeof(STARTUPINFOEX),
+            .dwFlags = STARTF_USESTDHANDLES,
+            .hStdInput = input,
+            .hStdOutput = output,
+            .hStdError = error
+        },
+        .lpAttributeList = attribute_list
+    };
+
+    // See https://devblogs.microsoft.com/oldnewthing/20090601-00/?p=18083
+    std::unique_ptr<wchar_t[]> const args_copy{wcsdup(command_line.c_str())};
+
+#pragma warning(suppress : 26494)
+    PROCESS_INFORMATION proc_info;
+    if (not CreateProcess(
+            program.empty() ? nullptr : program.c_str(),
+            args_copy.get(),
+            nullptr,             // process security attributes
+            nullptr,             // primary thread security attributes
+            TRUE,    // handles are inherited
+            CREATE_NO_WINDOW | CREATE_SUSPENDED | EXTENDED_STARTUPINFO_PRESENT
+                | CREATE_UNICODE_ENVIRONMENT,
+            windows_const_cast<wchar_t *>(environment.c_str()),
+            directory.c_str(),
+            &startup_info.StartupInfo,
+            &proc_info
+        ))
+    {
+        DWORD const error{GetLastError()};
+        bstr_t const cmd{command_line.c_str()};
+        throw System_Error(
+            error, "Can't execute command: " + static_cast<std::string>(cmd)
+        );
+    }
+    return proc_info;
+}
+
+}    // namespace Linter
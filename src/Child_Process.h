@@ -0,0 +1,73 @@
+#pragma once
+
+#include "Handle_Wrapper.h"
+
+#include <intsafe.h>
+#include <processthreadsapi.h>
+#include <winnt.h>
+
+#include <wil/resource.h>
+
+#include <filesystem>
+#include <string>
+
+namespace Linter
+{
+
+/** A process started by the plugin.
+ *
+ * The process is put in a job, so that when it is terminated, anything it
+ * has started goes with it.
+ */
+class Child_Process
+{
+  public:
+    /** Start a process.
+     *
+     * The program may be empty, in which case the program is taken from the
+     * start of the command line.
+     *
+     * The process only inherits the supplied standard handles.
+     */
+    Child_Process(
+        std::wstring const &program, std::wstring const &command_line,
+        std::wstring const &environment,
+        std::filesystem::path const &directory, HANDLE input, HANDLE output,
+        HANDLE error
+    );
+
+    Child_Process(Child_Process const &) = delete;
+    Child_Process(Child_Process &&) = delete;
+    Child_Process &operator=(Child_Process const &) = delete;
+    Child_Process &operator=(Child_Process &&) = delete;
+
+    ~Child_Process();
+
+    /** The process handle, which is signalled when the process exits */
+    HANDLE handle() const noexcept
+    {
+        return process_;
+    }
+
+    /** Kill the process and anything it has started */
+    void terminate(DWORD exit_code) const noexcept;
+
+    /** Get the exit code of the process */
+    DWORD exit_code() const;
+
+  private:
+    explicit Child_Process(PROCESS_INFORMATION const &);
+
+    static PROCESS_INFORMATION create(
+        std::wstring const &program, std::wstring const &command_line,
+        std::wstring const &environment,
+        std::filesystem::path const &directory, HANDLE input, HANDLE output,
+        HANDLE error
+    );
+
+    Handle_Wrapper process_;
+
+    wil::unique_handle job_;
+};
+
+}    // namespace Linter
@@ -4,6 +4,9 @@
 
 #include <CommCtrl.h>
 
+#include <algorithm>
+#include <vector>
+
 namespace Linter
 {
 
@@ -41,6 +44,39 @@ void Column_Header::set_sort_icon(
     }
 }
 
+void Column_Header::set_sort_icons(
+    std::vector<Sort_Column> const &sort_order
+) const noexcept
+{
+    auto const count = Header_GetItemCount(handle_);
+    for (int column_number = 0; column_number < count; column_number += 1)
+    {
+        HDITEM item{.mask = HDI_FORMAT};
+        Header_GetItem(handle_, column_number, &item);
+        item.fmt &= ~(HDF_SORTDOWN | HDF_SORTUP);
+        auto const sort_column = std::ranges::find(
+            sort_order, column_number, &Sort_Column::column
+        );
+        if (sort_column != sort_order.end())
+        {
+            switch (sort_column->direction)
+            {
+                case Sort_Direction::Ascending:
+                    item.fmt |= HDF_SORTUP;
+                    break;
+
+                case Sort_Direction::Descending:
+                    item.fmt |= HDF_SORTDOWN;
+                    break;
+
+                default:
+                    break;
+            }
+        }
+        Header_SetItem(handle_, column_number, &item);
+    }
+}
+
 int Column_Header::get_num_columns() const noexcept
 {
     return Header_GetItemCount(handle_);
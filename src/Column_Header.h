@@ -4,6 +4,8 @@
 
 #include "List_View_Types.h"
 
+#include <vector>
+
 namespace Linter
 {
 
@@ -23,10 +25,14 @@ class Column_Header
 
     using Data_Column = typename List_View_Types::Data_Column;
     using Sort_Direction = typename List_View_Types::Sort_Direction;
+    using Sort_Column = typename List_View_Types::Sort_Column;
 
     /** Set the sort icon to up arrow, down arrow or off */
     void set_sort_icon(Data_Column, Sort_Direction) const noexcept;
 
+    /** Set the sort icons for every column in the sort order */
+    void set_sort_icons(std::vector<Sort_Column> const &) const noexcept;
+
     /** Get the total number of columns */
     int get_num_columns() const noexcept;
 
@@ -0,0 +1,199 @@
+#include "Command_Statistics.h"
+
+#include "Encoding.h"
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace Linter
+{
+
+namespace
+{
+
+/** Quote a CSV field */
+std::string quote(std::string const &field)
+{
+    std::string quoted{"\""};
+    for (auto const character : field)
+    {
+        if (character == '"')
+        {
+            quoted += '"';
+        }
+        quoted += character;
+    }
+    quoted += '"';
+    return quoted;
+}
+
+}    // namespace
+
+double Command_Statistics::Summary::cache_hit_rate() const noexcept
+{
+    auto const lints = runs + cache_hits;
+    return lints == 0 ? 0.0
+                      : static_cast<double>(cache_hits)
+                            / static_cast<double>(lints);
+}
+
+Command_Statistics::~Command_Statistics() = default;
+
+void Command_Statistics::ran(std::wstring const &command, Run const &run)
+{
+    std::scoped_lock const lock{mutex_};
+    auto &totals = totals_[command];
+    totals.histogram[bucket(run.time)] += 1;
+    totals.runs += 1;
+    totals.max = std::max(totals.max, run.time);
+    totals.stdout_bytes += run.stdout_bytes;
+    totals.stderr_bytes += run.stderr_bytes;
+    totals.errors += run.errors;
+    if (run.failed)
+    {
+        totals.failures += 1;
+    }
+}
+
+void Command_Statistics::cache_hit(std::wstring const &command)
+{
+    std::scoped_lock const lock{mutex_};
+    totals_[command].cache_hits += 1;
+}
+
+void Command_Statistics::cancelled(std::wstring const &command)
+{
+    std::scoped_lock const lock{mutex_};
+    totals_[command].cancelled += 1;
+}
+
+std::vector<Command_Statistics::Summary> Command_Statistics::summaries() const
+{
+    std::scoped_lock const lock{mutex_};
+    std::vector<Summary> summaries;
+    summaries.reserve(totals_.size());
+    for (auto const &[command, totals] : totals_)
+    {
+        summaries.push_back(Summary{
+            .command = command,
+            .runs = totals.runs,
+            .median = percentile(totals, 50),
+            .percentile_95 = percentile(totals, 95),
+            .max = totals.max,
+            .stdout_bytes = totals.stdout_bytes,
+            .stderr_bytes = totals.stderr_bytes,
+            .errors = totals.errors,
+            .failures = totals.failures,
+            .cache_hits = totals.cache_hits,
+            .cancelled = totals.cancelled
+        });
+    }
+    return summaries;
+}
+
+std::string Command_Statistics::to_csv() const
+{
+    std::string csv{
+        "Command,Runs,Median ms,95th percentile ms,Max ms,Stdout bytes,"
+        "Stderr bytes,Errors,Failures,Cache hits,Cache hit rate,Cancelled\r\n"
+    };
+    for (auto const &summary : summaries())
+    {
+        csv += quote(Encoding::convert(summary.command));
+        for (auto const value :
+             {static_cast<std::uint64_t>(summary.runs),
+              static_cast<std::uint64_t>(summary.median.count()),
+              static_cast<std::uint64_t>(summary.percentile_95.count()),
+              static_cast<std::uint64_t>(summary.max.count()),
+              summary.stdout_bytes,
+              summary.stderr_bytes,
+              summary.errors,
+              static_cast<std::uint64_t>(summary.failures),
+              static_cast<std::uint64_t>(summary.cache_hits)})
+        {
+            csv += ',' + std::to_string(value);
+        }
+        csv += ',' + std::to_string(summary.cache_hit_rate());
+        csv += ',' + std::to_string(summary.cancelled);
+        csv += "\r\n";
+    }
+    return csv;
+}
+
+std::size_t Command_Statistics::bucket(Duration duration) noexcept
+{
+    auto const time = static_cast<std::uint64_t>(
+        std::max(duration.count(), Duration::rep{0})
+    );
+    if (time < Exact_Buckets)
+    {
+        return static_cast<std::size_t>(time);
+    }
+    // The top 3 bits pick the power of 2 and which quarter of it the time
+    // is in.
+    auto const power = static_cast<std::size_t>(std::bit_width(time)) - 1;
+    auto const quarter = static_cast<std::size_t>(time >> (power - 2)) & 3U;
+    return Exact_Buckets + (power - 3) * 4 + quarter;
+}
+
+Command_Statistics::Duration Command_Statistics::bucket_limit(
+    std::size_t bucket
+) noexcept
+{
+    if (bucket < Exact_Buckets)
+    {
+        return Duration{bucket};
+    }
+    auto const power = (bucket - Exact_Buckets) / 4 + 3;
+    auto const quarter = (bucket - Exact_Buckets) % 4;
+    auto const start = std::uint64_t{4 + quarter} << (power - 2);
+    return Duration{start + (std::uint64_t{1} << (power - 2)) - 1};
+}
+
+Command_Statistics::Duration Command_Statistics::percentile(
+    Totals const &totals, std::size_t percent
+) noexcept
+{
+    if (totals.runs == 0)
+    {
+        return Duration{0};
+    }
+    // The number of runs which have to be no slower than the result
+    auto const wanted = std::max<std::size_t>(
+        (totals.runs * percent + 99) / 100, 1
+    );
+    if (wanted >= totals.runs)
+    {
+        // That's the slowest run, which we know exactly.
+        return totals.max;
+    }
+    std::size_t seen = 0;
+    for (std::size_t bucket = 0; bucket < Num_Buckets; bucket += 1)
+    {
+        auto const count = totals.histogram[bucket];
+        if (seen + count >= wanted)
+        {
+            // Assume the runs in the bucket are spread evenly across it, and
+            // take the middle of the share of the wanted one. Nothing took
+            // longer than the slowest run, so the bucket ends there if that's
+            // in it.
+            auto const start = bucket == 0
+                                 ? Duration{0}
+                                 : bucket_limit(bucket - 1) + Duration{1};
+            auto const end = std::min(bucket_limit(bucket), totals.max);
+            auto const width = static_cast<double>((end - start).count() + 1);
+            auto const share = static_cast<double>(wanted - seen) - 0.5;
+            auto const offset = width * share / static_cast<double>(count);
+            return start + Duration{static_cast<Duration::rep>(offset)};
+        }
+        seen += count;
+    }
+    return totals.max;
+}
+
+}    // namespace Linter
@@ -0,0 +1,127 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace Linter
+{
+
+/** Keeps track of how each linter command performs, so that it's possible to
+ * find out which linter is making linting slow.
+ *
+ * For each command, this counts the runs and the output, and keeps a
+ * histogram of how long the runs took, from which the percentiles are
+ * estimated. The histogram buckets are exact up to a few milliseconds, and
+ * after that there are four buckets for each power of 2, so a command only
+ * uses a fixed amount of memory however often it is run. The runs in a bucket
+ * are assumed to be spread evenly across it, so an estimate is never out by
+ * more than the width of a bucket (25%), and is much closer than that when
+ * the times are spread out.
+ *
+ * This can be used from several threads at once.
+ */
+class Command_Statistics
+{
+  public:
+    using Duration = std::chrono::milliseconds;
+
+    /** What happened when a command was run */
+    struct Run
+    {
+        Duration time;
+        std::size_t stdout_bytes;
+        std::size_t stderr_bytes;
+        /** Number of errors the linter reported */
+        std::size_t errors;
+        /** Set if the linter wrote to stderr or its output couldn't be read */
+        bool failed;
+    };
+
+    /** Totals for a command */
+    struct Summary
+    {
+        std::wstring command;
+        std::size_t runs;
+        Duration median;
+        Duration percentile_95;
+        Duration max;
+        std::uint64_t stdout_bytes;
+        std::uint64_t stderr_bytes;
+        std::uint64_t errors;
+        std::size_t failures;
+        /** Number of times the results were reused from the cache */
+        std::size_t cache_hits;
+        /** Number of runs abandoned because the lint was stopped */
+        std::size_t cancelled;
+
+        /** Proportion of the lints that were satisfied from the cache */
+        double cache_hit_rate() const noexcept;
+    };
+
+    Command_Statistics() = default;
+
+    Command_Statistics(Command_Statistics const &) = delete;
+    Command_Statistics(Command_Statistics &&) = delete;
+    Command_Statistics &operator=(Command_Statistics const &) = delete;
+    Command_Statistics &operator=(Command_Statistics &&) = delete;
+
+    ~Command_Statistics();
+
+    /** Record a completed run of a command */
+    void ran(std::wstring const &command, Run const &);
+
+    /** Record that the results of a command were found in the cache */
+    void cache_hit(std::wstring const &command);
+
+    /** Record that a command was stopped before it completed */
+    void cancelled(std::wstring const &command);
+
+    /** Get the totals for each command, ordered by command */
+    std::vector<Summary> summaries() const;
+
+    /** Get the totals as UTF-8 CSV, with a header line */
+    std::string to_csv() const;
+
+  private:
+    /** Durations below this each get their own bucket */
+    static constexpr std::size_t Exact_Buckets = 8;
+
+    /** Enough buckets for any number of milliseconds */
+    static constexpr std::size_t Num_Buckets = Exact_Buckets + 61 * 4;
+
+    struct Totals
+    {
+        std::array<std::uint32_t, Num_Buckets> histogram{};
+        std::size_t runs{0};
+        Duration max{0};
+        std::uint64_t stdout_bytes{0};
+        std::uint64_t stderr_bytes{0};
+        std::uint64_t errors{0};
+        std::size_t failures{0};
+        std::size_t cache_hits{0};
+        std::size_t cancelled{0};
+    };
+
+    /** Get the bucket for a duration */
+    static std::size_t bucket(Duration) noexcept;
+
+    /** Get the longest duration which goes in a bucket */
+    static Duration bucket_limit(std::size_t bucket) noexcept;
+
+    /** Estimate the duration which the given percentage of runs took no
+     * longer than
+     */
+    static Duration percentile(Totals const &, std::size_t percent) noexcept;
+
+    mutable std::mutex mutex_;
+
+    std::map<std::wstring, Totals> totals_;
+};
+
+}    // namespace Linter
@@ -6,6 +6,7 @@
 #include "XML_Decode_Error.h"
 
 #include <atlcomcli.h>
+#include <atlsafe.h>
 #include <comutil.h>
 #include <intsafe.h>
 #include <minwindef.h>    //For FALSE
@@ -13,23 +14,19 @@
 #include <msxml6.h>
 #include <winerror.h>
 
+#include <cstring>
 #include <optional>
 #include <string>
 
 namespace Linter
 {
 
-Linter::Dom_Document::Dom_Document(
-    std::filesystem::path const &xml_file,
-    CComPtr<IXMLDOMSchemaCollection2> &schemas
+Dom_Document::Dom_Document(
+    std::string const &contents, IXMLDOMSchemaCollection2 *schemas
 )
 {
     init();
 
-    document_->put_validateOnParse(VARIANT_TRUE);
-    // Not sure what this does but it doesn't seem to be  necessary.
-    // pXD->put_resolveExternals(VARIANT_TRUE);
-
     // Treat whitespace according to the schema.
     HRESULT hres = document_->put_preserveWhiteSpace(FALSE);
     if (not SUCCEEDED(hres))
@@ -37,14 +34,32 @@ Linter::Dom_Document::Dom_Document(
         throw System_Error(hres, "Can't set preserveWhiteSpace");
     }
 
-    // Assign the schema cache to the DOMDocument's schemas collection.
-    hres = document_->putref_schemas(CComVariant(schemas));
-    if (not SUCCEEDED(hres))
+    if (schemas != nullptr)
+    {
+        document_->put_validateOnParse(VARIANT_TRUE);
+        // Not sure what this does but it doesn't seem to be  necessary.
+        // pXD->put_resolveExternals(VARIANT_TRUE);
+
+        // Assign the schema cache to the DOMDocument's schemas collection.
+        hres = document_->putref_schemas(CComVariant(schemas));
+        if (not SUCCEEDED(hres))
+        {
+            throw System_Error(hres, "Can't use schema collection");
+        }
+    }
+    else
     {
-        throw System_Error(hres, "Can't use schema collection");
+        document_->put_validateOnParse(VARIANT_FALSE);
     }
 
-    CComVariant const value{xml_file.c_str()};
+    // Loading from an array of bytes rather than a string means the encoding
+    // is worked out the same way as when loading a file.
+    CComSafeArray<BYTE> bytes{static_cast<ULONG>(contents.size())};
+    if (not contents.empty())
+    {
+        std::memcpy(bytes.m_psa->pvData, contents.data(), contents.size());
+    }
+    CComVariant const value{bytes.m_psa};
     VARIANT_BOOL resultCode = FALSE;
     hres = document_->load(value, &resultCode);
 
@@ -1,6 +1,5 @@
 #pragma once
 
-#include <filesystem>
 #include <optional>
 #include <string>
 
@@ -18,14 +17,20 @@ class Dom_Node_List;
 class Dom_Document
 {
     /** Important note:
-     * The wstring constructor takes a filename.
-     * The string constructor takes an xml string.
+     * The string constructor takes the contents of a file.
+     * The wstring constructor takes an xml string.
      */
 
   public:
-    /** Creates an XML document from the supplied filename and validates against
-     * xsd */
-    Dom_Document(std::filesystem::path const &, CComPtr<IXMLDOMSchemaCollection2> &);
+    /** Creates an XML document from the contents of a file, and validates it
+     * against the schemas, if supplied.
+     *
+     * The contents are parsed as a file would be, so the encoding is taken
+     * from the byte order mark or xml declaration.
+     */
+    Dom_Document(
+        std::string const &contents, IXMLDOMSchemaCollection2 *schemas
+    );
 
     /** Creates an XML document from the supplied UTF8 string */
     explicit Dom_Document(std::wstring const &xml);
@@ -1,5 +1,13 @@
 #include "Encoding.h"
 
+#if defined(_M_X64) || defined(_M_IX86) || defined(__SSE2__)
+#include <emmintrin.h>
+#define LINTER_ENCODING_SSE2 1
+#else
+#define LINTER_ENCODING_SSE2 0
+#endif
+
+#include <bit>
 #include <cstddef>
 #include <string>
 #include <string_view>
@@ -7,125 +15,272 @@
 namespace Linter::Encoding
 {
 
-int utfOffset(std::string const &utf8, int unicode_offset) noexcept
+namespace
 {
-    int result = 0;
-    std::string::const_iterator iter = utf8.begin();
-    std::string::const_iterator const end = utf8.end();
-    while (unicode_offset > 0 && iter != end)
+
+/** Used in place of anything that can't be converted */
+constexpr char32_t Replacement_Character = 0xFFFD;
+
+/** Write code point as UTF-8, returning the updated output pointer */
+char *encode_utf8(char32_t code, char *out) noexcept
+{
+#pragma warning(push)
+#pragma warning(disable : 26472 26481)
+    if (code < 0x80)
     {
-        if ((*iter & 0xC0) == 0xC0 && unicode_offset == 1)
-        {
-            break;
-        }
-        if ((*iter & 0x80) == 0 || (*iter & 0xC0) == 0x80)
-        {
-            unicode_offset -= 1;
-        }
-        iter += 1;
-        if (iter != end && *iter != 0x0D && *iter != 0x0A)
+        // 1-byte UTF-8
+        *out++ = static_cast<char>(code);
+    }
+    else if (code < 0x800)
+    {
+        // 2-byte UTF-8
+        *out++ = static_cast<char>(0xC0 | (code >> 6));
+        *out++ = static_cast<char>(0x80 | (code & 0x3F));
+    }
+    else if (code < 0x10000)
+    {
+        // 3-byte UTF-8
+        *out++ = static_cast<char>(0xE0 | (code >> 12));
+        *out++ = static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+        *out++ = static_cast<char>(0x80 | (code & 0x3F));
+    }
+    else
+    {
+        // 4-byte UTF-8
+        *out++ = static_cast<char>(0xF0 | (code >> 18));
+        *out++ = static_cast<char>(0x80 | ((code >> 12) & 0x3F));
+        *out++ = static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+        *out++ = static_cast<char>(0x80 | (code & 0x3F));
+    }
+#pragma warning(pop)
+    return out;
+}
+
+}    // namespace
+
+std::size_t ascii_prefix_length(std::string_view const str) noexcept
+{
+#pragma warning(push)
+#pragma warning(disable : 26481)
+    std::size_t pos = 0;
+#if LINTER_ENCODING_SSE2
+    while (str.size() - pos >= 16)
+    {
+        int const mask = _mm_movemask_epi8(
+            _mm_loadu_si128(reinterpret_cast<__m128i const *>(str.data() + pos))
+        );
+        if (mask != 0)
         {
-            result += 1;
+            // The first set bit is the first non-ASCII byte.
+            return pos + std::countr_zero(static_cast<unsigned int>(mask));
         }
+        pos += 16;
     }
-
-    return result;
+#endif
+    while (pos < str.size() and static_cast<unsigned char>(str[pos]) < 0x80)
+    {
+        pos += 1;
+    }
+#pragma warning(pop)
+    return pos;
 }
 
 std::string convert(std::wstring const &str)
 {
     // The casts here are safe...
 #pragma warning(push)
-#pragma warning(disable : 26472)
+#pragma warning(disable : 26472 26481)
+    // Each UTF-16 code unit takes at most 3 bytes (a surrogate pair takes 4),
+    // so we can size the output once and trim it at the end. If wchar_t is
+    // UTF-32, each character can take 4 bytes.
     std::string result;
-    for (wchar_t const chr : str)
+    result.resize(str.size() * (sizeof(wchar_t) == 2 ? 3 : 4));
+    char *out = result.data();
+
+    wchar_t const *pos = str.data();
+    wchar_t const *const end = pos + str.size();
+    while (pos != end)
     {
-        if (chr <= 0x7F)
-        {
-            // 1-byte UTF-8
-            result += static_cast<char>(chr);
-        }
-        else if (chr <= 0x7FF)
+#if LINTER_ENCODING_SSE2
+        if constexpr (sizeof(wchar_t) == 2)
         {
-            // 2-byte UTF-8
-            result += static_cast<char>(0xC0 | ((chr >> 6) & 0x1F));
-            result += static_cast<char>(0x80 | (chr & 0x3F));
+            // Convert runs of 8 ASCII characters at a time, which is the vast
+            // majority of text.
+            __m128i const non_ascii =
+                _mm_set1_epi16(static_cast<short>(0xFF80));
+            while (end - pos >= 8)
+            {
+                __m128i const chars =
+                    _mm_loadu_si128(reinterpret_cast<__m128i const *>(pos));
+                if (_mm_movemask_epi8(_mm_cmpeq_epi16(
+                        _mm_and_si128(chars, non_ascii), _mm_setzero_si128()
+                    ))
+                    != 0xFFFF)
+                {
+                    break;
+                }
+                _mm_storel_epi64(
+                    reinterpret_cast<__m128i *>(out),
+                    _mm_packus_epi16(chars, chars)
+                );
+                pos += 8;
+                out += 8;
+            }
+            if (pos == end)
+            {
+                break;
+            }
         }
-        else if (chr <= 0xFFFF)
+#endif
+
+        char32_t code = static_cast<char32_t>(*pos);
+        pos += 1;
+        if (code >= 0xD800 and code <= 0xDFFF)
         {
-            // 3-byte UTF-8
-            result += static_cast<char>(0xE0 | ((chr >> 12) & 0x0F));
-            result += static_cast<char>(0x80 | ((chr >> 6) & 0x3F));
-            result += static_cast<char>(0x80 | (chr & 0x3F));
+            // Surrogates have to come in (high, low) pairs.
+            if (code <= 0xDBFF and pos != end and *pos >= 0xDC00
+                and *pos <= 0xDFFF)
+            {
+                code = 0x10000 + ((code - 0xD800) << 10)
+                     + (static_cast<char32_t>(*pos) - 0xDC00);
+                pos += 1;
+            }
+            else
+            {
+                code = Replacement_Character;
+            }
         }
-        else
+        else if (code > 0x10FFFF)
         {
-            // Out of range for UTF-8 (non-BMP), replace with '?'
-            result += '?';
+            code = Replacement_Character;
         }
+        out = encode_utf8(code, out);
     }
+
+    result.resize(static_cast<std::size_t>(out - result.data()));
 #pragma warning(pop)
     return result;
 }
 
 std::wstring convert(std::string_view const str)
 {
-    // The array references are safe, but we could possibly rewrite this
-    // using iterators insead of indices.
+    // The pointer arithmetic is safe, as we check against the end of the
+    // string.
     // The static casts are safe according to clang tidy, but not windows.
 #pragma warning(push)
-#pragma warning(disable : 26446 26472)
+#pragma warning(disable : 26472 26481)
+    // Each UTF-8 byte produces at most one UTF-16 code unit (4 byte
+    // sequences produce a surrogate pair), so we can size the output once
+    // and trim it at the end.
     std::wstring result;
-    std::size_t pos = 0;
-    while (pos < str.length())
+    result.resize(str.size());
+    wchar_t *out = result.data();
+
+    auto const *pos = reinterpret_cast<unsigned char const *>(str.data());
+    auto const *const end = pos + str.size();
+    while (pos != end)
     {
-        auto const ch1 = static_cast<unsigned char>(str[pos]);
-        if (ch1 < 0x80)
+#if LINTER_ENCODING_SSE2
+        if constexpr (sizeof(wchar_t) == 2)
+        {
+            // Convert runs of 16 ASCII characters at a time.
+            while (end - pos >= 16)
+            {
+                __m128i const chars =
+                    _mm_loadu_si128(reinterpret_cast<__m128i const *>(pos));
+                if (_mm_movemask_epi8(chars) != 0)
+                {
+                    break;
+                }
+                __m128i const zero = _mm_setzero_si128();
+                _mm_storeu_si128(
+                    reinterpret_cast<__m128i *>(out),
+                    _mm_unpacklo_epi8(chars, zero)
+                );
+                _mm_storeu_si128(
+                    reinterpret_cast<__m128i *>(out + 8),
+                    _mm_unpackhi_epi8(chars, zero)
+                );
+                pos += 16;
+                out += 16;
+            }
+            if (pos == end)
+            {
+                break;
+            }
+        }
+#endif
+
+        char32_t code = *pos;
+        if (code < 0x80)
         {
-            // 1-byte ASCII
-            result += ch1;
             pos += 1;
         }
-        else if ((ch1 & 0xE0) == 0xC0 && pos + 1 < str.length())
+        else
         {
-            // 2-byte sequence
-            auto const ch2 = static_cast<unsigned char>(str[pos + 1]);
-            if ((ch2 & 0xC0) == 0x80)
+            // Work out how long the sequence should be, and the range the
+            // second byte must be in. This rejects overlong encodings,
+            // surrogates and anything past U+10FFFF.
+            std::size_t length = 0;
+            unsigned char low = 0x80;
+            unsigned char high = 0xBF;
+            if (code >= 0xC2 and code <= 0xDF)
             {
-                result += static_cast<wchar_t>(((ch1 & 0x1F) << 6) | (ch2 & 0x3F));
-                pos += 2;
+                length = 2;
+                code &= 0x1F;
             }
-            else
+            else if (code >= 0xE0 and code <= 0xEF)
             {
-                result += L'?';
-                pos += 1;
+                length = 3;
+                low = code == 0xE0 ? 0xA0 : 0x80;
+                high = code == 0xED ? 0x9F : 0xBF;
+                code &= 0x0F;
             }
-        }
-        else if ((ch1 & 0xF0) == 0xE0 && pos + 2 < str.length())
-        {
-            // 3-byte sequence
-            auto const ch2 = static_cast<unsigned char>(str[pos + 1]);
-            auto const ch3 = static_cast<unsigned char>(str[pos + 2]);
-            if ((ch2 & 0xC0) == 0x80 && (ch3 & 0xC0) == 0x80)
+            else if (code >= 0xF0 and code <= 0xF4)
             {
-                result += static_cast<wchar_t>(
-                    ((ch1 & 0x0F) << 12) | ((ch2 & 0x3F) << 6) | (ch3 & 0x3F)
-                );
-                pos += 3;
+                length = 4;
+                low = code == 0xF0 ? 0x90 : 0x80;
+                high = code == 0xF4 ? 0x8F : 0xBF;
+                code &= 0x07;
+            }
+
+            bool valid = length != 0
+                     and static_cast<std::size_t>(end - pos) >= length
+                     and pos[1] >= low and pos[1] <= high;
+            for (std::size_t byte = 2; valid and byte < length; ++byte)
+            {
+                valid = (pos[byte] & 0xC0) == 0x80;
+            }
+
+            if (valid)
+            {
+                for (std::size_t byte = 1; byte < length; ++byte)
+                {
+                    code = (code << 6) | (pos[byte] & 0x3F);
+                }
+                pos += length;
             }
             else
             {
-                result += L'?';
+                code = Replacement_Character;
                 pos += 1;
             }
         }
-        else
+
+        if constexpr (sizeof(wchar_t) == 2)
         {
-            // Invalid or unsupported sequence (including 4+ byte UTF-8)
-            result += L'?';
-            pos += 1;
+            if (code >= 0x10000)
+            {
+                code -= 0x10000;
+                *out++ = static_cast<wchar_t>(0xD800 + (code >> 10));
+                *out++ = static_cast<wchar_t>(0xDC00 + (code & 0x3FF));
+                continue;
+            }
         }
+        *out++ = static_cast<wchar_t>(code);
     }
+
+    result.resize(static_cast<std::size_t>(out - result.data()));
 #pragma warning(pop)
     return result;
 }
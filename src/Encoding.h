@@ -1,12 +1,18 @@
 #pragma once
+#include <cstddef>
 #include <string>
 #include <string_view>
 
 namespace Linter::Encoding
 {
 
-int utfOffset(std::string const &utf8, int unicode_offset) noexcept;
+/** Get the number of bytes at the start of the string that are ASCII */
+std::size_t ascii_prefix_length(std::string_view str) noexcept;
+
+/** Convert UTF-16 to UTF-8. Unpaired surrogates are replaced with U+FFFD */
 std::string convert(std::wstring const &str);
+
+/** Convert UTF-8 to UTF-16. Invalid UTF-8 is replaced with U+FFFD */
 std::wstring convert(std::string_view str);
 
 }    // namespace Linter::Encoding
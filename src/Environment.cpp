@@ -0,0 +1,131 @@
+#include "Environment.h"
+
+#include "System_Error.h"
+
+#include <processenv.h>
+#include <stringapiset.h>
+#include <winnls.h>
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <string_view>
+
+namespace Linter
+{
+
+Environment Environment::from_process()
+{
+    // Reading the process environment is quite expensive, so we do it once
+    // and copy the result.
+    static Environment const process_environment = []()
+    {
+        std::unique_ptr<wchar_t, decltype(&FreeEnvironmentStrings)> const
+            strings{GetEnvironmentStrings(), &FreeEnvironmentStrings};
+        if (not strings)
+        {
+            throw System_Error();
+        }
+
+        Environment env;
+        for (wchar_t const *entry = strings.get(); *entry != 0;)
+        {
+            std::wstring_view const str{entry};
+            // Names may start with an '=' (for instance the current directory
+            // for each drive), so we start searching from the 2nd character.
+            auto const separator = str.find(L'=', 1);
+            if (separator != std::wstring_view::npos)
+            {
+                env.variables_.insert_or_assign(
+                    std::wstring{str.substr(0, separator)},
+                    std::wstring{str.substr(separator + 1)}
+                );
+            }
+            entry += str.size() + 1;
+        }
+        return env;
+    }();
+    return process_environment;
+}
+
+void Environment::set(std::wstring const &name, std::wstring const &value)
+{
+    variables_.insert_or_assign(name, value);
+    block_valid_ = false;
+}
+
+std::wstring Environment::expand(std::wstring const &text) const
+{
+    std::wstring result;
+    result.reserve(text.size());
+
+    std::size_t pos = 0;
+    for (;;)
+    {
+        auto const start = text.find(L'%', pos);
+        if (start == std::wstring::npos)
+        {
+            break;
+        }
+        auto const end = text.find(L'%', start + 1);
+        if (end == std::wstring::npos)
+        {
+            break;
+        }
+
+        auto const variable =
+            variables_.find(text.substr(start + 1, end - start - 1));
+        if (variable == variables_.end())
+        {
+            // Not a variable name, so leave it alone. The closing % might be
+            // the start of a variable name though.
+            result.append(text, pos, end - pos);
+            pos = end;
+        }
+        else
+        {
+            result.append(text, pos, start - pos);
+            result.append(variable->second);
+            pos = end + 1;
+        }
+    }
+    result.append(text, pos);
+    return result;
+}
+
+bool Environment::Name_Less::operator()(
+    std::wstring const &lhs, std::wstring const &rhs
+) const noexcept
+{
+    // This is the ordering that CreateProcess requires.
+    return CompareStringOrdinal(
+               lhs.c_str(),
+               static_cast<int>(lhs.size()),
+               rhs.c_str(),
+               static_cast<int>(rhs.size()),
+               TRUE
+           )
+        == CSTR_LESS_THAN;
+}
+
+void Environment::build_block() const
+{
+    // Each variable is stored as name=value followed by a null, and the whole
+    // thing is terminated by an extra null.
+    std::size_t size = 1;
+    for (auto const &[name, value] : variables_)
+    {
+        size += name.size() + value.size() + 2;
+    }
+
+    block_.clear();
+    block_.reserve(size);
+    for (auto const &[name, value] : variables_)
+    {
+        block_.append(name).append(1, L'=').append(value).append(1, L'\0');
+    }
+    block_.append(1, L'\0');
+    block_valid_ = true;
+}
+
+}    // namespace Linter
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <map>
+#include <string>
+
+namespace Linter
+{
+
+/** A set of environment variables to pass to a child process.
+ *
+ * This allows us to set up the environment for each linter without changing
+ * the environment of notepad++ itself, so several files can be linted at once.
+ */
+class Environment
+{
+  public:
+    /** Get a copy of the notepad++ process environment.
+     *
+     * The process environment is only read the first time this is called.
+     */
+    static Environment from_process();
+
+    /** Add or replace a variable.
+     *
+     * The environment block isn't rebuilt until it is next needed, so
+     * setting several variables only builds it once.
+     */
+    void set(std::wstring const &name, std::wstring const &value);
+
+    /** Replace all the %x% references in the supplied string with the values
+     * of the variables, a-la ExpandEnvironmentStrings.
+     */
+    std::wstring expand(std::wstring const &text) const;
+
+    /** Get the environment block to pass to CreateProcess.
+     *
+     * This is sorted as windows requires, and must be passed with the
+     * CREATE_UNICODE_ENVIRONMENT flag.
+     *
+     * The block is built here if any variables have changed since it was
+     * last built, so this must be called once before the environment is
+     * shared between threads.
+     */
+    std::wstring const &block() const
+    {
+        if (not block_valid_)
+        {
+            build_block();
+        }
+        return block_;
+    }
+
+  private:
+    Environment() = default;
+
+    /** Windows environment variable names are case insensitive */
+    struct Name_Less
+    {
+        bool operator()(
+            std::wstring const &lhs, std::wstring const &rhs
+        ) const noexcept;
+    };
+
+    void build_block() const;
+
+    std::map<std::wstring, std::wstring, Name_Less> variables_;
+
+    mutable std::wstring block_;
+
+    // Set if block_ matches variables_
+    mutable bool block_valid_{false};
+};
+
+}    // namespace Linter
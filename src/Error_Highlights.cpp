@@ -0,0 +1,49 @@
+#include "Error_Highlights.h"
+
+#include <cstdint>
+#include <optional>
+
+namespace Linter
+{
+
+void update_highlights(
+    Highlight_Editor &editor, Error_Highlights const &shown,
+    Error_Highlights const &wanted, bool colour_as_message
+)
+{
+    auto const unchanged = [colour_as_message](
+                               Error_Highlight const &old_highlight,
+                               Error_Highlight const &new_highlight
+                           ) noexcept
+    {
+        return not colour_as_message
+            or old_highlight.colour == new_highlight.colour;
+    };
+
+    for (auto const &[position, highlight] : shown)
+    {
+        auto const match = wanted.find(position);
+        if (match == wanted.end() or not unchanged(highlight, match->second))
+        {
+            editor.clear(position);
+        }
+    }
+
+    std::optional<std::uint32_t> current_colour;
+    for (auto const &[position, highlight] : wanted)
+    {
+        auto const match = shown.find(position);
+        if (match != shown.end() and unchanged(match->second, highlight))
+        {
+            continue;
+        }
+        if (colour_as_message and current_colour != highlight.colour)
+        {
+            editor.set_colour(highlight.colour);
+            current_colour = highlight.colour;
+        }
+        editor.fill(position);
+    }
+}
+
+}    // namespace Linter
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstdint>
+#include <map>
+
+namespace Linter
+{
+
+/** An error indicator in the editor */
+struct Error_Highlight
+{
+    std::uint32_t colour;
+};
+
+/** Error indicators by position in the buffer */
+using Error_Highlights = std::map<std::intptr_t, Error_Highlight>;
+
+/** What update_highlights needs the editor to do */
+class Highlight_Editor
+{
+  public:
+    Highlight_Editor() = default;
+
+    Highlight_Editor(Highlight_Editor const &) = delete;
+    Highlight_Editor(Highlight_Editor &&) = delete;
+    Highlight_Editor &operator=(Highlight_Editor const &) = delete;
+    Highlight_Editor &operator=(Highlight_Editor &&) = delete;
+
+    virtual ~Highlight_Editor() = default;
+
+    /** Remove the error indicator from the character at a position */
+    virtual void clear(std::intptr_t position) = 0;
+
+    /** Set the colour used by fill from now on */
+    virtual void set_colour(std::uint32_t colour) = 0;
+
+    /** Put the error indicator on the character at a position */
+    virtual void fill(std::intptr_t position) = 0;
+};
+
+/** Change the error indicators in the editor from the ones shown to the ones
+ * wanted.
+ *
+ * Only the indicators that have changed are cleared or filled, as there could
+ * be a lot of them and usually only a few change between lints. Unless each
+ * indicator is coloured according to its message, the colours are ignored.
+ */
+void update_highlights(
+    Highlight_Editor &, Error_Highlights const &shown,
+    Error_Highlights const &wanted, bool colour_as_message
+);
+
+}    // namespace Linter
@@ -0,0 +1,90 @@
+#include "Error_Ranges.h"
+
+#include "Moving_Positions.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace Linter
+{
+
+void Error_Ranges::assign(std::vector<Range> ranges)
+{
+    ranges_ = std::move(ranges);
+    std::stable_sort(
+        ranges_.begin(),
+        ranges_.end(),
+        [](Range const &lhs, Range const &rhs) noexcept
+        { return lhs.start < rhs.start; }
+    );
+    max_length_ = 0;
+    std::vector<std::intptr_t> starts;
+    starts.reserve(ranges_.size());
+    for (auto const &range : ranges_)
+    {
+        max_length_ = std::max(max_length_, range.end - range.start);
+        starts.push_back(range.start);
+    }
+    starts_.assign(std::move(starts));
+}
+
+void Error_Ranges::clear() noexcept
+{
+    ranges_.clear();
+    starts_.clear();
+    max_length_ = 0;
+}
+
+void Error_Ranges::insert_text(std::intptr_t position, std::intptr_t length)
+{
+    starts_.insert_text(position, length);
+}
+
+void Error_Ranges::delete_text(std::intptr_t position, std::intptr_t length)
+{
+    starts_.delete_text(position, length);
+}
+
+std::wstring Error_Ranges::find(std::intptr_t position) const
+{
+    // Nothing starting before this can reach the position.
+    std::wstring result;
+    for (auto index = starts_.lower_bound(position - max_length_);
+         index < ranges_.size();
+         index = starts_.next(index + 1))
+    {
+        auto const start = starts_.position(index);
+        if (start > position)
+        {
+            break;
+        }
+        auto const &range = ranges_[index];
+        if (start + (range.end - range.start) >= position)
+        {
+            if (not result.empty())
+            {
+                result += L" | ";
+            }
+            result += range.message;
+        }
+    }
+    return result;
+}
+
+std::size_t Error_Ranges::bytes() const noexcept
+{
+    std::size_t bytes = sizeof(Error_Ranges)
+                      + ranges_.capacity() * sizeof(Range) + starts_.bytes()
+                      - sizeof(Moving_Positions);
+    for (auto const &range : ranges_)
+    {
+        bytes += range.message.capacity() * sizeof(wchar_t);
+    }
+    return bytes;
+}
+
+}    // namespace Linter
@@ -0,0 +1,62 @@
+#pragma once
+
+#include "Moving_Positions.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace Linter
+{
+
+/** Finds the errors at an editor position.
+ *
+ * This is a sorted vector of ranges, so looking up the caret position (which
+ * happens every time the caret moves) is a binary search.
+ *
+ * The ranges follow the text as it is edited, so the right messages are shown
+ * until the file is linted again. A range is removed if the text at its start
+ * is deleted.
+ */
+class Error_Ranges
+{
+  public:
+    struct Range
+    {
+        std::intptr_t start;
+        std::intptr_t end;    // Inclusive, so the caret can be either side
+        std::wstring message;
+    };
+
+    /** Replace the ranges */
+    void assign(std::vector<Range> ranges);
+
+    void clear() noexcept;
+
+    /** Text has been inserted in the editor */
+    void insert_text(std::intptr_t position, std::intptr_t length);
+
+    /** Text has been deleted from the editor */
+    void delete_text(std::intptr_t position, std::intptr_t length);
+
+    /** Get the messages of all the errors overlapping the position, joined
+     * together, in the order they were supplied.
+     */
+    std::wstring find(std::intptr_t position) const;
+
+    /** Approximate number of bytes used */
+    std::size_t bytes() const noexcept;
+
+  private:
+    // The ranges as they were when they were supplied
+    std::vector<Range> ranges_;
+
+    // Where the ranges start now
+    Moving_Positions starts_;
+
+    // Longest range, which limits how far back we need to look
+    std::intptr_t max_length_{0};
+};
+
+}    // namespace Linter
@@ -0,0 +1,145 @@
+#include "Error_Sort_Keys.h"
+
+#include "Error_Store.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <execution>
+#include <numeric>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace Linter
+{
+
+namespace
+{
+
+/** Pack the first 4 UTF-16 code units into an integer which orders the same
+ * way as the string.
+ */
+std::uint64_t message_prefix(std::wstring_view message) noexcept
+{
+    std::uint64_t prefix = 0;
+    for (std::size_t pos = 0; pos < 4; pos += 1)
+    {
+        prefix <<= 16;
+        if (pos < message.size())
+        {
+            prefix |= static_cast<std::uint16_t>(message[pos]);
+        }
+    }
+    return prefix;
+}
+
+}    // namespace
+
+void Error_Sort_Keys::add(Error_Store const &errors, std::size_t row)
+{
+    auto const [tool, inserted] = tool_ids_.try_emplace(
+        errors.tool(row), static_cast<std::uint32_t>(tools_.size())
+    );
+    if (inserted)
+    {
+        tools_.push_back(errors.tool(row));
+    }
+
+    keys_.push_back(Key{
+        .line = errors.line(row),
+        .column = errors.column(row),
+        .tool = tool->second,
+        .message_prefix = message_prefix(errors.message(row))
+    });
+}
+
+void Error_Sort_Keys::clear() noexcept
+{
+    keys_.clear();
+    tools_.clear();
+    tool_ids_.clear();
+}
+
+void Error_Sort_Keys::sort(
+    std::vector<int> &rows, std::vector<Sort_Field> const &fields,
+    Error_Store const &errors
+) const
+{
+    // Work out the alphabetical order of the tools. There are only ever a few
+    // of these.
+    std::vector<std::uint32_t> by_name(tools_.size());
+    std::iota(by_name.begin(), by_name.end(), 0U);
+    std::sort(
+        by_name.begin(),
+        by_name.end(),
+        [this](std::uint32_t lhs, std::uint32_t rhs)
+        { return tools_[lhs] < tools_[rhs]; }
+    );
+    std::vector<std::uint32_t> tool_rank(tools_.size());
+    for (std::size_t rank = 0; rank < by_name.size(); rank += 1)
+    {
+        tool_rank[by_name[rank]] = static_cast<std::uint32_t>(rank);
+    }
+
+    auto const compare = [&](int row1, int row2, Field field) -> int
+    {
+        Key const &key1 = keys_[static_cast<std::size_t>(row1)];
+        Key const &key2 = keys_[static_cast<std::size_t>(row2)];
+        switch (field)
+        {
+            case Field::Line:
+                return (key1.line > key2.line) - (key1.line < key2.line);
+
+            case Field::Column:
+                return (key1.column > key2.column)
+                     - (key1.column < key2.column);
+
+            case Field::Tool:
+            {
+                auto const rank1 = tool_rank[key1.tool];
+                auto const rank2 = tool_rank[key2.tool];
+                return (rank1 > rank2) - (rank1 < rank2);
+            }
+
+            case Field::Message:
+                if (key1.message_prefix != key2.message_prefix)
+                {
+                    return key1.message_prefix < key2.message_prefix ? -1 : 1;
+                }
+                return errors.message(static_cast<std::size_t>(row1))
+                    .compare(errors.message(static_cast<std::size_t>(row2)));
+        }
+        return 0;
+    };
+
+    // The sort is stable, so rows which compare equal stay in the order they
+    // were added.
+    std::stable_sort(
+        std::execution::par,
+        rows.begin(),
+        rows.end(),
+        [&](int row1, int row2)
+        {
+            for (auto const &[field, descending] : fields)
+            {
+                int const res = compare(row1, row2, field);
+                if (res != 0)
+                {
+                    return descending ? res > 0 : res < 0;
+                }
+            }
+            for (auto const field : {Field::Line, Field::Column})
+            {
+                int const res = compare(row1, row2, field);
+                if (res != 0)
+                {
+                    return res < 0;
+                }
+            }
+            return false;
+        }
+    );
+}
+
+}    // namespace Linter
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace Linter
+{
+
+class Error_Store;
+
+/** Compact sort keys for a list of errors.
+ *
+ * The keys are extracted once as the errors are added, so that sorting
+ * compares integers rather than strings as far as possible: Tools are
+ * interned and sorted by rank, and messages are compared by their first few
+ * characters before falling back to comparing the whole message.
+ */
+class Error_Sort_Keys
+{
+  public:
+    /** What to sort by */
+    enum class Field
+    {
+        Line,
+        Column,
+        Tool,
+        Message
+    };
+
+    struct Sort_Field
+    {
+        Field field;
+        bool descending;
+    };
+
+    /** Add the keys for a row of the store. These must be added in the same
+     * order as the rows.
+     */
+    void add(Error_Store const &, std::size_t row);
+
+    void clear() noexcept;
+
+    /** Sort the rows of errors by the fields, in order of priority. Ties
+     * are broken by line and then column, and then by the original order.
+     */
+    void sort(
+        std::vector<int> &rows, std::vector<Sort_Field> const &fields,
+        Error_Store const &errors
+    ) const;
+
+  private:
+    struct Key
+    {
+        int line;
+        int column;
+        std::uint32_t tool;
+        std::uint64_t message_prefix;
+    };
+
+    std::vector<Key> keys_;
+
+    // Tool names by id, and ids by tool name
+    std::vector<std::wstring> tools_;
+    std::unordered_map<std::wstring, std::uint32_t> tool_ids_;
+};
+
+}    // namespace Linter
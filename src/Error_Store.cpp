@@ -0,0 +1,252 @@
+#include "Error_Store.h"
+
+#include "Error_Info.h"
+
+#include <intsafe.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace Linter
+{
+
+namespace
+{
+
+/** Convert a size to a 32 bit id or offset, which keeps the records small */
+std::uint32_t to_id(std::size_t size)
+{
+    if (size > std::numeric_limits<std::uint32_t>::max())
+    {
+        throw std::length_error("Too many errors to store");
+    }
+    return static_cast<std::uint32_t>(size);
+}
+
+}    // namespace
+
+Error_Store::Error_Store() : outputs_{std::make_shared<std::string const>()}
+{
+}
+
+void Error_Store::add(Error_Info const &error)
+{
+    records_.push_back(Record{
+        .message = add_message(error.message_),
+        .message_size = to_id(error.message_.size()),
+        .severity = severities_.intern(error.severity_),
+        .tool = tools_.intern(error.tool_),
+        .command = commands_.intern(error.command_),
+        .output = add_output(error.stdout_),
+        .error_output = add_output(error.stderr_),
+        .mode = error.mode_,
+        .line = error.line_,
+        .column = error.column_,
+        .result = error.result_
+    });
+}
+
+void Error_Store::append(Error_Store const &other)
+{
+    records_.reserve(records_.size() + other.records_.size());
+    for (auto const &record : other.records_)
+    {
+        records_.push_back(Record{
+            .message = add_message(std::wstring_view{
+                other.messages_.data() + record.message, record.message_size
+            }),
+            .message_size = record.message_size,
+            .severity = severities_.intern(other.severities_[record.severity]),
+            .tool = tools_.intern(other.tools_[record.tool]),
+            .command = commands_.intern(other.commands_[record.command]),
+            .output = add_output(other.outputs_[record.output]),
+            .error_output = add_output(other.outputs_[record.error_output]),
+            .mode = record.mode,
+            .line = record.line,
+            .column = record.column,
+            .result = record.result
+        });
+    }
+}
+
+void Error_Store::clear()
+{
+    records_.clear();
+    messages_.clear();
+    severities_.clear();
+    tools_.clear();
+    commands_.clear();
+    outputs_.resize(1);
+}
+
+std::wstring_view Error_Store::message(std::size_t row) const noexcept
+{
+    auto const &record = records_[row];
+    return {messages_.data() + record.message, record.message_size};
+}
+
+std::wstring const &Error_Store::severity(std::size_t row) const noexcept
+{
+    return severities_[records_[row].severity];
+}
+
+std::wstring const &Error_Store::tool(std::size_t row) const noexcept
+{
+    return tools_[records_[row].tool];
+}
+
+std::wstring const &Error_Store::command(std::size_t row) const noexcept
+{
+    return commands_[records_[row].command];
+}
+
+std::string const &Error_Store::output(std::size_t row) const noexcept
+{
+    return *outputs_[records_[row].output];
+}
+
+std::string const &Error_Store::error_output(std::size_t row) const noexcept
+{
+    return *outputs_[records_[row].error_output];
+}
+
+Error_Info::Mode Error_Store::mode(std::size_t row) const noexcept
+{
+    return records_[row].mode;
+}
+
+int Error_Store::line(std::size_t row) const noexcept
+{
+    return records_[row].line;
+}
+
+int Error_Store::column(std::size_t row) const noexcept
+{
+    return records_[row].column;
+}
+
+DWORD Error_Store::result(std::size_t row) const noexcept
+{
+    return records_[row].result;
+}
+
+std::size_t Error_Store::bytes() const noexcept
+{
+    // This ignores the overhead of the allocations, and counts shared output
+    // in full, but is good enough for keeping memory use under control.
+    std::size_t bytes = sizeof(Error_Store)
+                      + records_.capacity() * sizeof(Record)
+                      + messages_.capacity() * sizeof(wchar_t)
+                      + severities_.bytes() + tools_.bytes()
+                      + commands_.bytes();
+    for (auto const &output : outputs_)
+    {
+        bytes += sizeof(Output) + output->size();
+    }
+    return bytes;
+}
+
+std::uint32_t Error_Store::add_message(std::wstring_view message)
+{
+    auto const offset = to_id(messages_.size());
+    messages_.append(message);
+    messages_.push_back(L'\0');
+    return offset;
+}
+
+std::uint32_t Error_Store::add_output(std::string const &output)
+{
+    if (output.empty())
+    {
+        return 0;
+    }
+    for (std::size_t id = 1; id < outputs_.size(); id += 1)
+    {
+        if (*outputs_[id] == output)
+        {
+            return to_id(id);
+        }
+    }
+    outputs_.push_back(std::make_shared<std::string const>(output));
+    return to_id(outputs_.size() - 1);
+}
+
+std::uint32_t Error_Store::add_output(Output const &output)
+{
+    if (output->empty())
+    {
+        return 0;
+    }
+    for (std::size_t id = 1; id < outputs_.size(); id += 1)
+    {
+        if (outputs_[id] == output or *outputs_[id] == *output)
+        {
+            return to_id(id);
+        }
+    }
+    outputs_.push_back(output);
+    return to_id(outputs_.size() - 1);
+}
+
+Error_Store::String_Table::String_Table(String_Table const &other) :
+    strings_(other.strings_)
+{
+    build_index();
+}
+
+Error_Store::String_Table &Error_Store::String_Table::operator=(
+    String_Table const &other
+)
+{
+    if (this != &other)
+    {
+        strings_ = other.strings_;
+        build_index();
+    }
+    return *this;
+}
+
+std::uint32_t Error_Store::String_Table::intern(std::wstring_view string)
+{
+    if (auto const id = ids_.find(string); id != ids_.end())
+    {
+        return id->second;
+    }
+    auto const id = to_id(strings_.size());
+    ids_.emplace(strings_.emplace_back(string), id);
+    return id;
+}
+
+void Error_Store::String_Table::clear() noexcept
+{
+    ids_.clear();
+    strings_.clear();
+}
+
+void Error_Store::String_Table::build_index()
+{
+    ids_.clear();
+    for (std::size_t id = 0; id < strings_.size(); id += 1)
+    {
+        ids_.emplace(strings_[id], to_id(id));
+    }
+}
+
+std::size_t Error_Store::String_Table::bytes() const noexcept
+{
+    std::size_t bytes = 0;
+    for (auto const &string : strings_)
+    {
+        bytes += sizeof(std::wstring) + sizeof(std::wstring_view)
+               + sizeof(std::uint32_t) + string.size() * sizeof(wchar_t);
+    }
+    return bytes;
+}
+
+}    // namespace Linter
@@ -0,0 +1,160 @@
+#pragma once
+
+#include "Error_Info.h"
+
+#include <intsafe.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace Linter
+{
+
+/** A compact list of errors.
+ *
+ * A lint can produce tens of thousands of errors, nearly all of which have
+ * the same severity, tool and command, and an Error_Info carries its own copy
+ * of each of them. This stores each error as a small fixed size record:
+ *
+ * - The severities, tools and command lines are stored once and referred to
+ *   by number.
+ * - The output of a linter (which is only kept for system errors) is shared
+ *   between all the errors from that run, and with any store it is appended
+ *   to.
+ * - The messages are all kept in one string.
+ *
+ * Errors are added and then read by row number. References and views
+ * returned by the accessors are only valid until the store is next changed.
+ */
+class Error_Store
+{
+  public:
+    Error_Store();
+
+    /** Add an error to the end of the store */
+    void add(Error_Info const &);
+
+    /** Add all the errors in another store to the end of this one */
+    void append(Error_Store const &);
+
+    /** Remove all the errors */
+    void clear();
+
+    std::size_t size() const noexcept
+    {
+        return records_.size();
+    }
+
+    bool empty() const noexcept
+    {
+        return records_.empty();
+    }
+
+    /** The message. The character after the end of the view is always a NUL,
+     * so data() can be handed to things that want a C string.
+     */
+    std::wstring_view message(std::size_t row) const noexcept;
+
+    std::wstring const &severity(std::size_t row) const noexcept;
+
+    std::wstring const &tool(std::size_t row) const noexcept;
+
+    std::wstring const &command(std::size_t row) const noexcept;
+
+    /** What the linter wrote to stdout */
+    std::string const &output(std::size_t row) const noexcept;
+
+    /** What the linter wrote to stderr */
+    std::string const &error_output(std::size_t row) const noexcept;
+
+    Error_Info::Mode mode(std::size_t row) const noexcept;
+
+    int line(std::size_t row) const noexcept;
+
+    int column(std::size_t row) const noexcept;
+
+    DWORD result(std::size_t row) const noexcept;
+
+    /** Approximate number of bytes used */
+    std::size_t bytes() const noexcept;
+
+  private:
+    /** A set of strings, each of which is stored once and given a number */
+    class String_Table
+    {
+      public:
+        String_Table() = default;
+
+        // The index refers to the strings, so has to be rebuilt for a copy.
+        // Moving a deque doesn't move the elements, so that's OK.
+        String_Table(String_Table const &);
+        String_Table(String_Table &&) noexcept = default;
+        String_Table &operator=(String_Table const &);
+        String_Table &operator=(String_Table &&) noexcept = default;
+
+        ~String_Table() = default;
+
+        std::uint32_t intern(std::wstring_view);
+
+        std::wstring const &operator[](std::uint32_t id) const noexcept
+        {
+            return strings_[id];
+        }
+
+        void clear() noexcept;
+
+        std::size_t bytes() const noexcept;
+
+      private:
+        void build_index();
+
+        // A deque doesn't move its elements, so the keys in ids_ can refer
+        // to them.
+        std::deque<std::wstring> strings_;
+        std::unordered_map<std::wstring_view, std::uint32_t> ids_;
+    };
+
+    using Output = std::shared_ptr<std::string const>;
+
+    struct Record
+    {
+        std::uint32_t message;    // Offset in messages_
+        std::uint32_t message_size;
+        std::uint32_t severity;
+        std::uint32_t tool;
+        std::uint32_t command;
+        std::uint32_t output;
+        std::uint32_t error_output;
+        Error_Info::Mode mode;
+        int line;
+        int column;
+        DWORD result;
+    };
+
+    std::uint32_t add_message(std::wstring_view);
+
+    std::uint32_t add_output(std::string const &);
+
+    std::uint32_t add_output(Output const &);
+
+    std::vector<Record> records_;
+
+    // All the messages, each followed by a NUL.
+    std::wstring messages_;
+
+    String_Table severities_;
+    String_Table tools_;
+    String_Table commands_;
+
+    // Output 0 is always empty. There's only ever one for each linter run
+    // that fails, so these are searched rather than indexed.
+    std::vector<Output> outputs_;
+};
+
+}    // namespace Linter
@@ -1,127 +1,184 @@
 #include "File_Linter.h"
 
 #include "Child_Pipe.h"
+#include "Child_Process.h"
 #include "Encoding.h"
+#include "Environment.h"
 #include "Handle_Wrapper.h"
+#include "Lint_Scheduler.h"
+#include "Linter_Server.h"
+#include "Linter_Servers.h"
 #include "Settings.h"
 #include "System_Error.h"
+#include "Temp_Files.h"
+#include "Trace.h"
+#include "Variable_Cache.h"
 
-#include <comutil.h>
-#include <errhandlingapi.h>
 #include <fileapi.h>
-#include <handleapi.h>
 #include <intsafe.h>
-#include <minwindef.h>
-#include <processenv.h>
-#include <processthreadsapi.h>
+#include <synchapi.h>
 #include <winbase.h>
+#include <winerror.h>
 #include <winnt.h>
 
-#include <cwchar>    // for wcsdup
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
 #include <filesystem>
-#include <memory>
+#include <future>
+#include <optional>
+#include <stop_token>
 #include <string>
-#include <system_error>
 #include <tuple>
 #include <utility>
+#include <vector>
 
 namespace Linter
 {
 
-class Environment_Wrapper
-{
-  public:
-#pragma warning(suppress : 26455)
-    Environment_Wrapper() : env_{GetEnvironmentStrings()}
-    {
-        if (env_ == nullptr)
-        {
-            throw System_Error();
-        }
-    }
-
-    /** Prevent copying and moving */
-    Environment_Wrapper(Environment_Wrapper const &) = delete;
-    Environment_Wrapper &operator=(Environment_Wrapper const &) = delete;
-    Environment_Wrapper(Environment_Wrapper &&) = delete;
-    Environment_Wrapper &operator=(Environment_Wrapper &&) = delete;
-
-    /** Free the environment strings */
-    ~Environment_Wrapper() noexcept
-    {
-        // Restore environment to original state
-        SetEnvironmentStrings(env_);
-        // And discard the saved buffer.
-        FreeEnvironmentStrings(env_);
-    }
-
-    /** Get the current environment strings */
-    wchar_t const *get() const noexcept
-    {
-        return env_;
-    }
-
-  private:
-    wchar_t *env_;
-};
-
 File_Linter::File_Linter(
     std::filesystem::path target, std::filesystem::path plugin_dir,
     std::filesystem::path settings_dir,
-    std::vector<Settings::Variable> const &variables, std::string text
+    std::vector<Settings::Variable> const &variables,
+    Variable_Cache &variable_cache, std::string text, Temp_Files &temp_files,
+    Linter_Servers &servers, Target linter_target
 ) :
     target_{std::move(target)},
     plugin_dir_{std::move(plugin_dir)},
     settings_dir_{std::move(settings_dir)},
-    temp_file_{get_temp_file_name()},
+    temp_file_{get_lint_target_name(target_, linter_target)},
     variables_{variables},
+    variable_cache_{variable_cache},
     text_{std::move(text)},
-    env_{std::make_unique<Environment_Wrapper>()}
+    temp_files_{temp_files},
+    servers_{servers},
+    linter_target_{linter_target},
+    environment_{Environment::from_process()}
 {
     setup_environment();
 }
 
-File_Linter::~File_Linter()
+// The temporary file is left for the next lint of the buffer, and is deleted
+// when the buffer is closed.
+File_Linter::~File_Linter() = default;
+
+File_Linter::Linter_Result File_Linter::run_linter(
+    Settings::Command const &command, std::stop_token const &stop_token
+)
 {
-    std::error_code errcode;
-    std::filesystem::remove(temp_file_, errcode);
+    Trace::Span const span{"Run linter"};
+
+    if (stop_token.stop_requested())
+    {
+        // No point in starting something we're going to throw away.
+        return std::make_tuple(
+            command.args, ERROR_CANCELLED, "", "", std::chrono::milliseconds{0}
+        );
+    }
+
+    auto const start = std::chrono::steady_clock::now();
+    Linter_Result result;
+    if (command.persistent)
+    {
+        result = run_server(command, stop_token);
+    }
+    else
+    {
+        if (not command.use_stdin)
+        {
+            ensure_temp_file_exists();
+        }
+
+        auto [exit_code, out, err] = execute(
+            command, command.use_stdin ? &text_ : nullptr, stop_token
+        );
+        result = std::make_tuple(
+            command.args, exit_code, std::move(out), std::move(err),
+            std::chrono::milliseconds{0}
+        );
+    }
+    std::get<std::chrono::milliseconds>(result) =
+        std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - start
+        );
+    return result;
 }
 
-std::tuple<std::wstring, DWORD, std::string, std::string>
-File_Linter::run_linter(Settings::Command const &command)
+void File_Linter::run_linters(
+    std::vector<Settings::Command> const &commands, Lint_Scheduler &scheduler,
+    std::stop_token const &stop_token, Linter_Callback const &callback
+)
 {
-    if (not command.use_stdin)
+    // Create the temporary file up front if anything needs it, so that the
+    // workers don't race to create it.
+    if (std::any_of(
+            commands.begin(),
+            commands.end(),
+            [](Settings::Command const &command) noexcept
+            { return not command.use_stdin and not command.persistent; }
+        ))
     {
         ensure_temp_file_exists();
     }
 
-    auto const [exit_code, out, err] =
-        execute(command, command.use_stdin ? &text_ : nullptr);
-    return std::make_tuple(command.args, exit_code, out, err);
-}
+    std::vector<std::packaged_task<Linter_Result()>> tasks;
+    std::vector<std::future<Linter_Result>> results;
+    tasks.reserve(commands.size());
+    results.reserve(commands.size());
+    for (auto const &command : commands)
+    {
+        tasks.emplace_back([this, &command, &stop_token]()
+                           { return run_linter(command, stop_token); });
+        results.emplace_back(tasks.back().get_future());
+    }
 
-std::filesystem::path File_Linter::get_temp_file_name() const
-{
-    // We cannot put these files in temp dir because the tools search for
-    // configuration in the directory the file is being processed. Therefore we
-    // create the file in the same directory but mark it hidden.
-    std::filesystem::path temp = target_;
-    temp.concat(".linter.tmp").concat(target_.extension().c_str());
-    return temp;
+    // Any exception from a linter gets stored in its future.
+    scheduler.run_together(
+        tasks.size(),
+        [&tasks](std::size_t task) { tasks[task](); },
+        stop_token,
+        [&commands, &results, &callback](std::size_t task)
+        { callback(commands[task], results[task]); }
+    );
 }
 
-void File_Linter::ensure_temp_file_exists()
+File_Linter::Linter_Result File_Linter::run_server(
+    Settings::Command const &command, std::stop_token const &stop_token
+)
 {
-    if (created_temp_file_)
+    Trace::Span const span{"Run linter server"};
+
+    // The server is shared by all the files, so it runs in the configuration
+    // directory rather than the directory of whichever file started it.
+    auto const [program, args] = get_command_line(command);
+    auto const server = servers_.get(
+        command, program, args, environment_.block(), settings_dir_
+    );
+    auto reply = server->lint(target_, text_, stop_token);
+    if (not reply.has_value())
     {
-        return;
+        return std::make_tuple(
+            command.args, ERROR_CANCELLED, "", "", std::chrono::milliseconds{0}
+        );
     }
+    return std::make_tuple(
+        command.args, reply->exit_code, std::move(reply->output),
+        std::move(reply->error_output), std::chrono::milliseconds{0}
+    );
+}
 
-    // Ideally we'd make this read-write and dup the handle whenever we needed
-    // to pass as stdin, but it seems some things like to open their input
-    // exclusively
+void File_Linter::write_temp_file(
+    std::filesystem::path const &path, std::string const &text
+)
+{
+    // The file is next to the original, as the tools search for configuration
+    // in the directory of the file they're processing, so it's hidden.
+    //
+    // Ideally we'd make this read-write and dup the handle whenever we
+    // needed to pass as stdin, but it seems some things like to open
+    // their input exclusively
     Handle_Wrapper const handle{CreateFile(
-        temp_file_.c_str(),
+        path.c_str(),
         GENERIC_WRITE,
         0,
         nullptr,
@@ -130,117 +187,100 @@ void File_Linter::ensure_temp_file_exists()
         nullptr
     )};
 
-    handle.write_file(text_);
+    handle.write_file(text);
+}
+
+void File_Linter::ensure_temp_file_exists()
+{
+    if (created_temp_file_ or linter_target_ == Target::File)
+    {
+        return;
+    }
+
+    Trace::Span const span{"Write temp file"};
+    temp_files_.write(temp_file_, text_);
 
     created_temp_file_ = true;
 }
 
 void File_Linter::setup_environment()
 {
-    // Set up the supported environment variables.
-    if (not SetEnvironmentVariable(L"LINTER_TARGET", temp_file_.c_str()))
-    {
-        throw System_Error();
-    }
+    Trace::Span const span{"Set up environment"};
 
-    if (not SetEnvironmentVariable(L"LINTER_PLUGIN_DIR", plugin_dir_.c_str()))
-    {
-        throw System_Error();
-    }
-    if (not SetEnvironmentVariable(L"LINTER_CONFIG_DIR", settings_dir_.c_str()))
-    {
-        throw System_Error();
-    }
+    // Set up the supported environment variables. These are only passed to
+    // the linters, so we don't need to touch the notepad++ environment.
+    environment_.set(L"LINTER_TARGET", temp_file_);
+    environment_.set(L"LINTER_PLUGIN_DIR", plugin_dir_);
+    environment_.set(L"LINTER_CONFIG_DIR", settings_dir_);
 
-    if (not SetEnvironmentVariable(L"TARGET", target_.c_str()))
-    {
-        throw System_Error();
-    }
-    if (not SetEnvironmentVariable(
-            L"TARGET_DIR", target_.parent_path().c_str()
-        ))
-    {
-        throw System_Error();
-    }
-    if (not SetEnvironmentVariable(L"TARGET_EXT", target_.extension().c_str()))
-    {
-        throw System_Error();
-    }
-    if (not SetEnvironmentVariable(
-            L"TARGET_FILENAME", target_.filename().c_str()
-        ))
-    {
-        throw System_Error();
-    }
+    environment_.set(L"TARGET", target_);
+    environment_.set(L"TARGET_DIR", target_.parent_path());
+    environment_.set(L"TARGET_EXT", target_.extension());
+    environment_.set(L"TARGET_FILENAME", target_.filename());
 
-    for (auto const &[name, command] : variables_)
+    auto const target_dir = target_.parent_path();
+    for (auto const &[name, command, cache] : variables_)
     {
-        // This consists of a variable name and a command to run.
-        auto const [res, out, err] = execute(command);
-        if (not err.empty())
-        {
-            // Add a warning
-            warnings_.push_back(
-                "Variable '" + Encoding::convert(name)
-                + "' command produced stderr output " + err
-            );
-        }
-        if (res != 0)
+        // This consists of a variable name and a command to run, unless we
+        // already have the value saved.
+        auto const command_line = get_command_line(command).second;
+        std::optional<std::string> value =
+            variable_cache_.find(name, command_line, cache, target_dir);
+        if (not value.has_value())
         {
-            // Add a warning
-            warnings_.push_back(
-                "Variable '" + Encoding::convert(name)
-                + "' command returned non-zero exit code: "
-                + std::to_string(res)
-            );
-        }
-        std::string output{out};
-        if (not output.empty())
-        {
-            // Remove the trailing newline, if any.
-            if (output.back() == '\n')
+            auto const [res, out, err] = execute(command);
+            if (not err.empty())
             {
-                output.pop_back();
+                // Add a warning
+                warnings_.push_back(
+                    "Variable '" + Encoding::convert(name)
+                    + "' command produced stderr output " + err
+                );
             }
+            if (res != 0)
+            {
+                // Add a warning
+                warnings_.push_back(
+                    "Variable '" + Encoding::convert(name)
+                    + "' command returned non-zero exit code: "
+                    + std::to_string(res)
+                );
+            }
+            std::string output{out};
+            if (not output.empty())
+            {
+                // Remove the trailing newline, if any.
+                if (output.back() == '\n')
+                {
+                    output.pop_back();
+                }
+            }
+            // Don't save the value if it went wrong, so it gets retried.
+            if (res == 0 && err.empty())
+            {
+                variable_cache_.store(
+                    name, command_line, cache, target_dir, output
+                );
+            }
+            value = std::move(output);
         }
-        // FIXME do we care about errors?
-        if (not SetEnvironmentVariable(
-                name.c_str(), Encoding::convert(output).c_str()
-            ))
-        {
-            throw System_Error();
-        }
+        // Later variables can use this one, so we set it now.
+        environment_.set(name, Encoding::convert(*value));
     }
+
+    // The linters may be run from several threads at once, so the block
+    // mustn't be left to be built by whichever of them gets there first.
+    std::ignore = environment_.block();
 }
 
-std::wstring File_Linter::expand_variables(std::wstring const &text)
+std::wstring File_Linter::expand_variables(std::wstring const &text) const
 {
     // Replace all %x% stuff a-la windows command line.
-
-    // First we get the length of the string we'll generate
-    auto const len = ExpandEnvironmentStrings(text.c_str(), nullptr, 0);
-    if (len == 0)
-    {
-        throw System_Error();
-    }
-    std::wstring res;
-    res.resize(len);
-
-    if (ExpandEnvironmentStrings(text.c_str(), &*res.begin(), len) == 0)
-    {
-        throw System_Error();
-    }
-
-    // We do this because the compiler is too dim to work out that there can't
-    // be an overflow because len can't possibly be zero, because of the check
-    // just above.
-    std::size_t const len2 = len;
-    res.resize(len2 - 1);    // Remove the trailing null
-    return res;
+    return environment_.expand(text);
 }
 
-std::tuple<DWORD, std::string, std::string> File_Linter::execute(
-    Settings::Command const &command, std::string const *const input
+std::pair<std::wstring, std::wstring> File_Linter::get_command_line(
+    Settings::Command const &command
 ) const
 {
     std::wstring program;
@@ -265,66 +305,67 @@ std::tuple<DWORD, std::string, std::string> File_Linter::execute(
             args = L"\"" + program + L"\" /c \"" + args + L"\"";
         }
     }
+    return std::make_pair(program, args);
+}
+
+std::tuple<DWORD, std::string, std::string> File_Linter::execute(
+    Settings::Command const &command, std::string const *const input,
+    std::stop_token const &stop_token
+) const
+{
+    auto const [program, args] = get_command_line(command);
 
     auto const stdout_pipe = Child_Pipe::create_output_pipe();
     auto const stderr_pipe = Child_Pipe::create_output_pipe();
     auto const stdin_pipe = Child_Pipe::create_input_pipe();
 
-    STARTUPINFO startup_info = {
-        .cb = sizeof(STARTUPINFO),
-        .dwFlags = STARTF_USESTDHANDLES,
-        .hStdInput = stdin_pipe.reader(),
-        .hStdOutput = stdout_pipe.writer(),
-        .hStdError = stderr_pipe.writer()
+    Child_Process const process{
+        program,
+        args,
+        environment_.block(),
+        target_.parent_path(),
+        stdin_pipe.reader(),
+        stdout_pipe.writer(),
+        stderr_pipe.writer()
     };
 
-    // See https://devblogs.microsoft.com/oldnewthing/20090601-00/?p=18083
-    std::unique_ptr<wchar_t[]> const args_copy{wcsdup(args.c_str())};
-
-#pragma warning(suppress : 26494)
-    PROCESS_INFORMATION proc_info;
-    if (not CreateProcess(
-            program.empty() ? nullptr : program.c_str(),
-            args_copy.get(),
-            nullptr,             // process security attributes
-            nullptr,             // primary thread security attributes
-            TRUE,                // handles are inherited
-            CREATE_NO_WINDOW,    // creation flags
-            nullptr,             // use my environment
-            target_.parent_path().wstring().c_str(),
-            &startup_info,
-            &proc_info
-        ))
-    {
-        DWORD const error{GetLastError()};
-        bstr_t const cmd{args.c_str()};
-        throw System_Error(
-            error, "Can't execute command: " + static_cast<std::string>(cmd)
-        );
-    }
+    // If we get asked to stop while we're writing to stdin, we need to kill
+    // the process as it might be blocked reading.
+    std::stop_callback const terminator{
+        stop_token,
+        [&process]() noexcept { process.terminate(ERROR_CANCELLED); }
+    };
 
     if (input != nullptr)
     {
-        stdin_pipe.writer().write_file(*input);
+        try
+        {
+            stdin_pipe.writer().write_file(*input);
+        }
+        catch (System_Error const &)
+        {
+            // If we've been cancelled, we expect a broken pipe.
+            if (not stop_token.stop_requested())
+            {
+                throw;
+            }
+        }
     }
     stdin_pipe.writer().close();
     stdin_pipe.reader().close();
 
     auto const res = Child_Pipe::read_output_pipes(
-        proc_info.hProcess, stdout_pipe, stderr_pipe
+        process.handle(), stdout_pipe, stderr_pipe, stop_token
     );
 
-    DWORD exit_code;    // NOLINT(cppcoreguidelines-init-variables)
-    if (GetExitCodeProcess(proc_info.hProcess, &exit_code) == FALSE)
+    if (stop_token.stop_requested())
     {
-        throw System_Error();
+        // The terminator will have been called, but the process might not
+        // have finished dying yet.
+        WaitForSingleObject(process.handle(), INFINITE);
     }
 
-    // And finally clean up.
-    CloseHandle(proc_info.hProcess);
-    CloseHandle(proc_info.hThread);
-
-    return std::make_tuple(exit_code, res.first, res.second);
+    return std::make_tuple(process.exit_code(), res.first, res.second);
 }
 
 }    // namespace Linter
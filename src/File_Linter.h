@@ -1,30 +1,44 @@
 #pragma once
 
+#include "Environment.h"
+#include "Lint_Target.h"
 // Fixme do we extract the command substructure somewhere?
 #include "Settings.h"
 
 #include <intsafe.h>
 
+#include <chrono>
 #include <filesystem>
-#include <memory>
+#include <functional>
+#include <future>
+#include <stop_token>
 #include <string>
 #include <tuple>
+#include <utility>
 #include <vector>
 
 namespace Linter
 {
 
-class Environment_Wrapper;
+class Lint_Scheduler;
+class Linter_Servers;
+class Temp_Files;
+class Variable_Cache;
 
 class File_Linter
 {
   public:
+    /** What %LINTER_TARGET% refers to */
+    using Target = Lint_Target;
+
     explicit File_Linter(
         std::filesystem::path target,
         std::filesystem::path plugin_dir,
         std::filesystem::path settings_dir,
         std::vector<Settings::Variable> const &variables,
-        std::string text
+        Variable_Cache &variable_cache, std::string text,
+        Temp_Files &temp_files, Linter_Servers &servers,
+        Target = Target::Temp_File
     );
 
     File_Linter(File_Linter const &) = delete;
@@ -34,10 +48,46 @@ class File_Linter
 
     ~File_Linter();
 
-    std::tuple<std::wstring, DWORD, std::string, std::string>
-    run_linter(Settings::Command const &);
+    /** Results of running a linter: command line, exit code, stdout, stderr
+     * and how long it took
+     */
+    using Linter_Result = std::tuple<
+        std::wstring, DWORD, std::string, std::string,
+        std::chrono::milliseconds>;
+
+    /** Called as each linter completes */
+    using Linter_Callback = std::function<
+        void(Settings::Command const &, std::future<Linter_Result> &)>;
+
+    /** Run a linter.
+     *
+     * If a stop is requested while the linter is running, the linter (and
+     * anything it started) is terminated and the output is incomplete.
+     */
+    Linter_Result run_linter(
+        Settings::Command const &, std::stop_token const & = {}
+    );
 
-    std::filesystem::path get_temp_file_name() const;
+    /** Run all the supplied linters on the scheduler's workers, as tasks for
+     * the current buffer.
+     *
+     * The callback is called on the calling thread as each linter finishes,
+     * so the results are delivered in the order they complete, not the order
+     * in which they were supplied. Calling get() on the future will rethrow
+     * any exception caused by running the linter.
+     *
+     * Once a stop is requested, any running linters are terminated, no
+     * further linters are started, and the callback is no longer called.
+     */
+    void run_linters(
+        std::vector<Settings::Command> const &, Lint_Scheduler &,
+        std::stop_token const &, Linter_Callback const &
+    );
+
+    /** Write the temporary copy of a buffer, for Temp_Files */
+    static void write_temp_file(
+        std::filesystem::path const &, std::string const &text
+    );
 
     void ensure_temp_file_exists();
 
@@ -49,10 +99,21 @@ class File_Linter
   private:
     void setup_environment();
 
-    static std::wstring expand_variables(std::wstring const &);
+    std::wstring expand_variables(std::wstring const &) const;
+
+    /** Get the program and command line to run */
+    std::pair<std::wstring, std::wstring> get_command_line(
+        Settings::Command const &
+    ) const;
+
+    /** Send the file to the server for a persistent command */
+    Linter_Result run_server(
+        Settings::Command const &, std::stop_token const &
+    );
 
     std::tuple<DWORD, std::string, std::string> execute(
-        Settings::Command const &, std::string const * input = nullptr
+        Settings::Command const &, std::string const *input = nullptr,
+        std::stop_token const & = {}
     ) const;
 
     std::filesystem::path target_;
@@ -60,8 +121,12 @@ class File_Linter
     std::filesystem::path settings_dir_;
     std::filesystem::path temp_file_;
     std::vector<Settings::Variable> const &variables_;
+    Variable_Cache &variable_cache_;
     std::string const text_;
-    std::unique_ptr<Environment_Wrapper> env_;
+    Temp_Files &temp_files_;
+    Linter_Servers &servers_;
+    Target const linter_target_;
+    Environment environment_;
 
     std::vector<std::string> warnings_;
 
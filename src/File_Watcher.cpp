@@ -0,0 +1,112 @@
+#include "File_Watcher.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <exception>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <stop_token>
+#include <system_error>
+#include <thread>
+#include <utility>
+
+namespace Linter
+{
+
+namespace
+{
+
+// Editors often write a file in several steps, so wait this long after a
+// change for them to finish before reading it.
+constexpr std::chrono::milliseconds Settle_Time{100};
+
+// How often to look at the file if the directory can't be watched.
+constexpr std::chrono::milliseconds Poll_Interval{2000};
+
+/** Wait for a while. Returns false if a stop is requested. */
+bool sleep(
+    std::chrono::milliseconds time, std::stop_token const &stop_token
+)
+{
+    std::mutex mutex;
+    std::condition_variable_any stopped;
+    std::unique_lock lock{mutex};
+    return not stopped.wait_for(
+        lock, stop_token, time, []() noexcept { return false; }
+    ) and not stop_token.stop_requested();
+}
+
+std::filesystem::file_time_type get_last_write_time(
+    std::filesystem::path const &file
+) noexcept
+{
+    std::error_code error;
+    auto const last_write_time = std::filesystem::last_write_time(file, error);
+    return error ? std::filesystem::file_time_type::min() : last_write_time;
+}
+
+}    // namespace
+
+File_Watcher::File_Watcher(
+    std::filesystem::path file, Open_Changes open_changes,
+    std::function<void()> changed
+) :
+    file_(std::move(file)),
+    open_changes_(std::move(open_changes)),
+    changed_(std::move(changed)),
+    last_write_time_(get_last_write_time(file_)),
+    thread_(
+        [this](std::stop_token const &stop_token) noexcept
+        { watch(stop_token); }
+    )
+{
+}
+
+File_Watcher::~File_Watcher() = default;
+
+void File_Watcher::watch(std::stop_token const &stop_token) noexcept
+{
+    try
+    {
+        try
+        {
+            auto const changes = open_changes_(file_, stop_token);
+            while (changes->wait())
+            {
+                if (not sleep(Settle_Time, stop_token))
+                {
+                    return;
+                }
+                changed_();
+            }
+            return;
+        }
+        catch (std::exception const &)
+        {
+            // The directory is on something that can't be watched, or has
+            // gone away, so look at the file every so often instead.
+        }
+        poll(stop_token);
+    }
+    catch (std::exception const &)
+    {
+        // Nothing we can usefully do. The file won't be watched.
+    }
+}
+
+void File_Watcher::poll(std::stop_token const &stop_token)
+{
+    while (sleep(Poll_Interval, stop_token))
+    {
+        auto const last_write_time = get_last_write_time(file_);
+        if (last_write_time != last_write_time_)
+        {
+            last_write_time_ = last_write_time;
+            changed_();
+        }
+    }
+}
+
+}    // namespace Linter
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <stop_token>
+#include <thread>
+
+namespace Linter
+{
+
+/** Calls a function from a background thread whenever a file changes.
+ *
+ * The directory containing the file is watched, using whatever the system
+ * provides. If the directory can't be watched (for instance, because it's on
+ * a network share which doesn't support it), the time the file was last
+ * written is checked every so often instead.
+ */
+class File_Watcher
+{
+  public:
+    /** Waits for changes to the file, in a way that depends on the system */
+    class Changes
+    {
+      public:
+        Changes() = default;
+
+        Changes(Changes const &) = delete;
+        Changes(Changes &&) = delete;
+        Changes &operator=(Changes const &) = delete;
+        Changes &operator=(Changes &&) = delete;
+
+        virtual ~Changes() = default;
+
+        /** Wait for the file to be changed, created, deleted or renamed.
+         *
+         * Returns false if a stop has been requested. Throws an exception if
+         * the directory can no longer be watched.
+         */
+        virtual bool wait() = 0;
+    };
+
+    /** Start watching a file, stopping when told to. This throws an
+     * exception if the directory can't be watched.
+     */
+    using Open_Changes = std::function<std::unique_ptr<Changes>(
+        std::filesystem::path const &, std::stop_token const &
+    )>;
+
+    File_Watcher(
+        std::filesystem::path file, Open_Changes open_changes,
+        std::function<void()> changed
+    );
+
+    File_Watcher(File_Watcher const &) = delete;
+    File_Watcher(File_Watcher &&) = delete;
+    File_Watcher &operator=(File_Watcher const &) = delete;
+    File_Watcher &operator=(File_Watcher &&) = delete;
+
+    ~File_Watcher();
+
+  private:
+    /** The thread which waits for the file to change */
+    void watch(std::stop_token const &) noexcept;
+
+    /** Check the file every so often, for when the directory can't be
+     * watched
+     */
+    void poll(std::stop_token const &);
+
+    std::filesystem::path const file_;
+    Open_Changes const open_changes_;
+    std::function<void()> const changed_;
+
+    // Last update time of the file when it was last checked
+    std::filesystem::file_time_type last_write_time_;
+
+    // This is last, so it is stopped before anything it uses is destroyed.
+    std::jthread thread_;
+};
+
+}    // namespace Linter
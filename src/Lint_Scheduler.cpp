@@ -0,0 +1,357 @@
+#include "Lint_Scheduler.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <queue>
+#include <stop_token>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace Linter
+{
+
+Lint_Scheduler::Lint_Scheduler(unsigned int max_running) :
+    max_running_(std::max(max_running, 1U))
+{
+}
+
+Lint_Scheduler::~Lint_Scheduler()
+{
+    shutdown();
+}
+
+void Lint_Scheduler::set_max_running(unsigned int max_running)
+{
+    {
+        std::scoped_lock const lock{mutex_};
+        max_running_ = std::max(max_running, 1U);
+        add_workers();
+        preempt();
+    }
+    changed_.notify_all();
+}
+
+void Lint_Scheduler::run(Priority priority, Task task)
+{
+    queue(Job{
+        .priority = priority,
+        .sequence = 0,
+        .key = std::nullopt,
+        .stop = {},
+        .task = std::move(task),
+        .preempted = false,
+        .cancelled = false
+    });
+}
+
+void Lint_Scheduler::run(Key key, Priority priority, Task task)
+{
+    queue(Job{
+        .priority = priority,
+        .sequence = 0,
+        .key = key,
+        .stop = {},
+        .task = std::move(task),
+        .preempted = false,
+        .cancelled = false
+    });
+}
+
+void Lint_Scheduler::run_together(
+    std::size_t tasks, std::function<void(std::size_t)> const &task,
+    std::stop_token const &stop_token,
+    std::function<void(std::size_t)> const &finished
+)
+{
+    std::mutex mutex;
+    std::condition_variable completed;
+    std::queue<std::size_t> done;
+
+    for (std::size_t number = 0; number < tasks; number += 1)
+    {
+        run(Priority::Active,
+            [&, number](std::stop_token const &)
+            {
+                task(number);
+
+                // Notify with the lock held, as once the last task is
+                // picked up, the condition variable goes away.
+                std::scoped_lock const lock{mutex};
+                done.push(number);
+                completed.notify_one();
+            });
+    }
+
+    // Now hand the results back as each task finishes. The tasks refer to
+    // our local variables, so if the callback throws, we have to wait for
+    // them all to finish before passing on the exception.
+    std::exception_ptr exception;
+    for (std::size_t count = 0; count < tasks; count += 1)
+    {
+        std::size_t number = 0;
+        {
+            std::unique_lock lock{mutex};
+            completed.wait(lock, [&done]() { return not done.empty(); });
+            number = done.front();
+            done.pop();
+        }
+        // If we've been told to stop, the results are going to be discarded,
+        // but we still have to wait for everything to terminate.
+        if (not stop_token.stop_requested() and not exception)
+        {
+            try
+            {
+                finished(number);
+            }
+            catch (...)
+            {
+                exception = std::current_exception();
+            }
+        }
+    }
+    if (exception)
+    {
+        std::rethrow_exception(exception);
+    }
+}
+
+void Lint_Scheduler::set_priority(Key key, Priority priority)
+{
+    {
+        std::scoped_lock const lock{mutex_};
+        for (auto &job : waiting_)
+        {
+            if (job.key == key)
+            {
+                job.priority = priority;
+            }
+        }
+        preempt();
+    }
+    changed_.notify_all();
+}
+
+void Lint_Scheduler::cancel(Key key)
+{
+    std::scoped_lock const lock{mutex_};
+    std::erase_if(
+        waiting_, [key](Job const &job) noexcept { return job.key == key; }
+    );
+    cancel_running(key);
+}
+
+bool Lint_Scheduler::is_running(Key key) const
+{
+    std::scoped_lock const lock{mutex_};
+    return std::ranges::any_of(
+        running_jobs_,
+        [key](Job const *job) noexcept { return job->key == key; }
+    );
+}
+
+void Lint_Scheduler::shutdown()
+{
+    {
+        std::scoped_lock const lock{mutex_};
+        stopping_ = true;
+        // Anything still waiting gets run, but will see it has been
+        // cancelled, as something might be waiting for it to finish.
+        for (auto &job : waiting_)
+        {
+            job.stop.request_stop();
+        }
+        for (auto *const job : running_jobs_)
+        {
+            job->cancelled = true;
+            job->stop.request_stop();
+        }
+    }
+    changed_.notify_all();
+    workers_.clear();
+}
+
+void Lint_Scheduler::queue(Job job)
+{
+    {
+        std::unique_lock lock{mutex_};
+        if (stopping_)
+        {
+            lock.unlock();
+            job.stop.request_stop();
+            job.task(job.stop.get_token());
+            return;
+        }
+        if (job.key.has_value())
+        {
+            Key const key = *job.key;
+            std::erase_if(
+                waiting_,
+                [key](Job const &waiting) noexcept
+                { return waiting.key == key; }
+            );
+            cancel_running(key);
+        }
+        job.sequence = sequence_;
+        sequence_ += 1;
+        waiting_.push_back(std::move(job));
+        add_workers();
+        preempt();
+    }
+    changed_.notify_all();
+}
+
+void Lint_Scheduler::cancel_running(Key key)
+{
+    for (auto *const job : running_jobs_)
+    {
+        if (job->key == key)
+        {
+            job->cancelled = true;
+            job->stop.request_stop();
+        }
+    }
+}
+
+void Lint_Scheduler::add_workers()
+{
+    // The workers are started when they're needed, rather than when the
+    // plugin is loaded.
+    auto const wanted =
+        std::min<std::size_t>(max_running_, running_ + waiting_.size());
+    while (workers_.size() < wanted)
+    {
+        workers_.emplace_back([this]() { worker(); });
+    }
+}
+
+void Lint_Scheduler::preempt()
+{
+    if (stopping_)
+    {
+        return;
+    }
+    auto const active = static_cast<std::size_t>(std::ranges::count_if(
+        waiting_,
+        [](Job const &job) noexcept { return job.priority == Priority::Active; }
+    ));
+    std::size_t available = running_ < max_running_ ? max_running_ - running_
+                                                    : 0;
+    // Anything already stopping will free its worker soon.
+    available += static_cast<std::size_t>(std::ranges::count_if(
+        running_jobs_,
+        [](Job const *job) noexcept { return job->stop.stop_requested(); }
+    ));
+
+    // Stop the background jobs which started most recently first, as they
+    // have done the least work.
+    for (auto job = running_jobs_.rbegin();
+         job != running_jobs_.rend() and available < active;
+         ++job)
+    {
+        if ((*job)->priority != Priority::Active
+            and not (*job)->stop.stop_requested())
+        {
+            (*job)->preempted = true;
+            (*job)->stop.request_stop();
+            available += 1;
+        }
+    }
+}
+
+std::vector<Lint_Scheduler::Job>::iterator Lint_Scheduler::next_job()
+{
+    if (running_ >= max_running_ and not stopping_)
+    {
+        return waiting_.end();
+    }
+    // Keep one worker back for the current buffer. If there is only one,
+    // background jobs can use it, and get stopped if the current buffer needs
+    // it.
+    bool const background_allowed = stopping_ or max_running_ == 1
+                                 or running_background_ + 1 < max_running_;
+    auto best = waiting_.end();
+    for (auto job = waiting_.begin(); job != waiting_.end(); ++job)
+    {
+        if (job->priority != Priority::Active and not background_allowed)
+        {
+            continue;
+        }
+        if (best == waiting_.end()
+            or std::tie(job->priority, job->sequence)
+                   < std::tie(best->priority, best->sequence))
+        {
+            best = job;
+        }
+    }
+    return best;
+}
+
+void Lint_Scheduler::worker()
+{
+    for (;;)
+    {
+        Job job;
+        {
+            std::unique_lock lock{mutex_};
+            changed_.wait(
+                lock,
+                [this]()
+                {
+                    return (stopping_ and waiting_.empty())
+                        or next_job() != waiting_.end();
+                }
+            );
+            auto const next = next_job();
+            if (next == waiting_.end())
+            {
+                return;
+            }
+            job = std::move(*next);
+            waiting_.erase(next);
+            running_ += 1;
+            if (job.priority != Priority::Active)
+            {
+                running_background_ += 1;
+            }
+            running_jobs_.push_back(&job);
+        }
+
+        try
+        {
+            job.task(job.stop.get_token());
+        }
+        catch (std::exception const &err)
+        {
+            // Tasks are expected to deal with their own errors, and there is
+            // nothing we can do with it here.
+            std::ignore = err;
+        }
+
+        {
+            std::scoped_lock const lock{mutex_};
+            running_ -= 1;
+            if (job.priority != Priority::Active)
+            {
+                running_background_ -= 1;
+            }
+            std::erase(running_jobs_, &job);
+            if (job.preempted and not job.cancelled and not stopping_)
+            {
+                // Run it again once the current buffer has been dealt with.
+                // It keeps its place in the queue.
+                job.preempted = false;
+                job.stop = std::stop_source{};
+                waiting_.push_back(std::move(job));
+            }
+        }
+        changed_.notify_all();
+    }
+}
+
+}    // namespace Linter
@@ -0,0 +1,158 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <stop_token>
+#include <thread>
+#include <vector>
+
+namespace Linter
+{
+
+/** Runs linters on a pool of worker threads.
+ *
+ * All linting goes through one pool, so there is a single limit on the
+ * number of linters running at once, however many files are being linted.
+ *
+ * Tasks are run in priority order, and in the order they were added for the
+ * same priority. Linting for the current buffer always gets a worker next,
+ * and one worker is kept free of background tasks so that it doesn't have to
+ * wait for them. If the current buffer still can't get a worker (because the
+ * limit is 1, or it has more linters than there are free workers), running
+ * background tasks are stopped and put back in the queue to run again later.
+ *
+ * Tasks can have a key (the buffer being linted), so that a buffer only has
+ * one task waiting at any time, and it can be cancelled or reprioritised.
+ *
+ * This can be used from several threads at once.
+ */
+class Lint_Scheduler
+{
+  public:
+    enum class Priority    // NOLINT(performance-enum-size)
+    {
+        Active,        // The current buffer
+        Recent,        // Recently viewed buffers
+        Background     // Anything else
+    };
+
+    using Key = std::uintptr_t;
+
+    /** A task. The token is triggered when the task is cancelled */
+    using Task = std::function<void(std::stop_token const &)>;
+
+    explicit Lint_Scheduler(unsigned int max_running);
+
+    Lint_Scheduler(Lint_Scheduler const &) = delete;
+    Lint_Scheduler(Lint_Scheduler &&) = delete;
+    Lint_Scheduler &operator=(Lint_Scheduler const &) = delete;
+    Lint_Scheduler &operator=(Lint_Scheduler &&) = delete;
+
+    ~Lint_Scheduler();
+
+    /** Set the number of tasks that can run at once. Workers are started as
+     * they are needed, up to this number.
+     */
+    void set_max_running(unsigned int);
+
+    /** Queue a task */
+    void run(Priority, Task);
+
+    /** Queue a task for a key, replacing any waiting task for the same key,
+     * and cancelling any running one.
+     */
+    void run(Key, Priority, Task);
+
+    /** Run a number of tasks for the current buffer, and wait for them all.
+     *
+     * task is called with the number of each task, on a worker. As each one
+     * finishes, finished is called with its number on this thread, so the
+     * results can be handed back without waiting for the slowest. The tasks
+     * mustn't throw.
+     *
+     * Once a stop is requested, or finished throws, finished isn't called
+     * again, but this still waits for all the tasks to finish, as they might
+     * refer to the caller's variables. Any exception from finished is then
+     * passed on.
+     */
+    void run_together(
+        std::size_t tasks, std::function<void(std::size_t)> const &task,
+        std::stop_token const &,
+        std::function<void(std::size_t)> const &finished
+    );
+
+    /** Change the priority of the waiting task for a key, if there is one */
+    void set_priority(Key, Priority);
+
+    /** Remove the waiting task for a key, and cancel any running one */
+    void cancel(Key);
+
+    /** Returns true if a task for the key is running */
+    bool is_running(Key) const;
+
+    /** Cancel everything and wait for the workers to finish.
+     *
+     * This must be called before the DLL is unloaded, as the workers can't be
+     * waited for then. Anything queued after this is run immediately, with a
+     * cancelled token.
+     */
+    void shutdown();
+
+  private:
+    struct Job
+    {
+        Priority priority;
+        std::uint64_t sequence;
+        std::optional<Key> key;
+        std::stop_source stop;
+        Task task;
+        // Set if the job has been stopped to make way for the current buffer,
+        // so it should be run again.
+        bool preempted{false};
+        // Set if the job has been cancelled, so it mustn't be run again.
+        bool cancelled{false};
+    };
+
+    void queue(Job);
+
+    /** Stop the running jobs for a key, for good */
+    void cancel_running(Key);
+
+    /** Start workers for any waiting jobs, up to the limit */
+    void add_workers();
+
+    /** Stop a background job if the current buffer is waiting for a worker */
+    void preempt();
+
+    /** Find the next job that can be run, or end() if there isn't one */
+    std::vector<Job>::iterator next_job();
+
+    void worker();
+
+    mutable std::mutex mutex_;
+
+    std::condition_variable changed_;
+
+    std::vector<Job> waiting_;
+
+    // The running jobs, which belong to the workers running them
+    std::vector<Job *> running_jobs_;
+
+    std::vector<std::jthread> workers_;
+
+    unsigned int max_running_;
+
+    unsigned int running_{0};
+
+    unsigned int running_background_{0};
+
+    std::uint64_t sequence_{0};
+
+    bool stopping_{false};
+};
+
+}    // namespace Linter
@@ -0,0 +1,45 @@
+#include "Lint_Target.h"
+
+#include <cstddef>
+#include <filesystem>
+#include <system_error>
+
+namespace Linter
+{
+
+Lint_Target choose_lint_target(
+    std::filesystem::path const &path, bool modified, std::size_t text_size
+) noexcept
+{
+    if (modified)
+    {
+        return Lint_Target::Temp_File;
+    }
+    // The file could have been changed by something else without notepad++
+    // reloading it yet, in which case it's probably a different size.
+    // Likewise if it's saved in an encoding other than UTF-8.
+    std::error_code errcode;
+    auto const size = std::filesystem::file_size(path, errcode);
+    return not errcode and size == text_size ? Lint_Target::File
+                                             : Lint_Target::Temp_File;
+}
+
+std::filesystem::path get_temp_file_name(std::filesystem::path const &target)
+{
+    // We cannot put these files in temp dir because the tools search for
+    // configuration in the directory the file is being processed. Therefore we
+    // create the file in the same directory but mark it hidden.
+    std::filesystem::path temp = target;
+    temp.concat(".linter.tmp").concat(target.extension().native());
+    return temp;
+}
+
+std::filesystem::path get_lint_target_name(
+    std::filesystem::path const &target, Lint_Target lint_target
+)
+{
+    return lint_target == Lint_Target::File ? target
+                                            : get_temp_file_name(target);
+}
+
+}    // namespace Linter
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+
+namespace Linter
+{
+
+/** What %LINTER_TARGET% refers to */
+enum class Lint_Target
+{
+    /** A hidden copy of the text, next to the file */
+    Temp_File,
+    /** The file itself, which must contain the text */
+    File
+};
+
+/** Decide whether the linters can read the file itself.
+ *
+ * They can if the buffer has no unsaved changes and the file on disc is the
+ * same size as the text.
+ */
+Lint_Target choose_lint_target(
+    std::filesystem::path const &, bool modified, std::size_t text_size
+) noexcept;
+
+/** The name of the temporary copy used for a file */
+std::filesystem::path get_temp_file_name(std::filesystem::path const &target);
+
+/** Get the name to put in %LINTER_TARGET% */
+std::filesystem::path get_lint_target_name(
+    std::filesystem::path const &target, Lint_Target
+);
+
+}    // namespace Linter
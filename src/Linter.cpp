@@ -2,13 +2,29 @@
 
 #include "About_Dialogue.h"
 #include "Checkstyle_Parser.h"
+#include "Command_Statistics.h"
 #include "Encoding.h"
+#include "Buffer_Results.h"
+#include "Error_Highlights.h"
 #include "Error_Info.h"
+#include "Error_Store.h"
+#include "Error_Ranges.h"
 #include "File_Linter.h"
+#include "Lint_Scheduler.h"
+#include "Lint_Target.h"
+#include "Linter_Servers.h"
 #include "Indicator.h"
 #include "Menu_Entry.h"
+#include "Moving_Positions.h"
 #include "Output_Dialogue.h"
+#include "Position_Index.h"
+#include "Relint_Delay.h"
+#include "Result_Cache.h"
 #include "Settings.h"
+#include "Settings_Watcher.h"
+#include "System_Error.h"
+#include "Temp_Files.h"
+#include "Trace.h"
 #include "XML_Decode_Error.h"
 
 #include "Plugin/Callback_Context.h"    // IWYU pragma: keep
@@ -26,16 +42,30 @@
 #include <synchapi.h>    // For WaitForSingleObject
 #include <threadpoollegacyapiset.h>
 #include <winbase.h>    // For WAIT_OBJECT_0
+#include <winerror.h>
 #include <winuser.h>
 #include <wtypesbase.h>
 
 // IWYU pragma: no_include <xtree>
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
 #include <exception>
 #include <filesystem>
+#include <fstream>
+#include <future>
+#include <iterator>
 #include <list>
 #include <map>
 #include <memory>
+#include <mutex>
+#include <numeric>
+#include <optional>
+#include <set>
+#include <stop_token>
 #include <string>
+#include <system_error>
 #include <unordered_map>
 #include <utility>
 #include <vector>
@@ -54,6 +84,23 @@ namespace Linter
 
 namespace
 {
+
+// How many buffers are treated as recently viewed when linting in the
+// background
+constexpr std::size_t Max_Recent_Buffers = 8;
+
+constexpr std::size_t megabytes(unsigned int size) noexcept
+{
+    return static_cast<std::size_t>(size) * 1024 * 1024;
+}
+
+/** Identifies a command in the result cache */
+std::wstring get_command_key(Settings::Command const &command)
+{
+    return command.program.wstring() + L" " + command.args
+         + (command.use_stdin ? L" <stdin>" : L"");
+}
+
 class Save_Selected_Indicator
 {
   public:
@@ -84,16 +131,52 @@ class Save_Selected_Indicator
     LRESULT old_id_;
 };
 
+/** Updates the error indicators in scintilla */
+class Scintilla_Highlights : public Highlight_Editor
+{
+  public:
+    explicit Scintilla_Highlights(Plugin &plugin) noexcept :
+        plugin_(plugin),
+        indicator_(plugin)
+    {
+    }
+
+    void clear(std::intptr_t position) override
+    {
+        plugin_.send_to_editor(SCI_INDICATORCLEARRANGE, position, 1);
+    }
+
+    void set_colour(std::uint32_t colour) override
+    {
+        plugin_.send_to_editor(
+            SCI_SETINDICATORVALUE, SC_INDICVALUEBIT | colour
+        );
+    }
+
+    void fill(std::intptr_t position) override
+    {
+        plugin_.send_to_editor(SCI_INDICATORFILLRANGE, position, 1);
+    }
+
+  private:
+    Plugin const &plugin_;
+    Save_Selected_Indicator const indicator_;
+};
+
 }    // namespace
 
 Linter::Linter(NppData const &data) :
     Super(data, get_plugin_name()),
-    settings_(std::make_unique<Settings>(*this)),
+    settings_watcher_(
+        get_plugin_config_dir().append(get_name() + L".xml"),
+        get_module_path().replace_extension(".xsd")
+    ),
     output_dialogue_(
         std::make_unique<Output_Dialogue>(Menu_Entry::Show_Results, *this)
     ),
     timer_queue_(::CreateTimerQueue()),
-    enabled_(settings_->enabled()),
+    temp_files_(File_Linter::write_temp_file),
+    enabled_(settings()->enabled()),
     npp_statusbar_(FindWindowEx(
         get_notepad_window(), nullptr, L"msctls_statusbar32", nullptr
     ))
@@ -102,6 +185,8 @@ Linter::Linter(NppData const &data) :
 
 Linter::~Linter()
 {
+    // Kill off anything we're still running.
+    lint_stop_source_.request_stop();
     std::ignore = ::DeleteTimerQueueEx(timer_queue_, nullptr);
 }
 
@@ -120,7 +205,7 @@ std::vector<FuncItem> &Linter::on_get_menu_entries()
         get_menu_string(entry),                    \
         method,                                    \
         state,                                     \
-        settings_->get_shortcut_key(entry)         \
+        menu_settings_->get_shortcut_key(entry)    \
     )
 
 // NOLINTNEXTLINE(cppcoreguidelines-macro-usage)
@@ -130,6 +215,8 @@ std::vector<FuncItem> &Linter::on_get_menu_entries()
 #define MAKE_SEPARATOR(entry) \
     PLUGIN_MENU_MAKE_SEPARATOR(Linter, static_cast<int>(entry))
 
+    // Notepad++ keeps pointers to the shortcut keys.
+    menu_settings_ = settings();
     menu_entries_ = {
         MAKE_CALLBACK(Menu_Entry::Edit_Config, edit_config),
         MAKE_SEPARATOR(Menu_Entry::Separator_1),
@@ -140,6 +227,7 @@ std::vector<FuncItem> &Linter::on_get_menu_entries()
         MAKE_CALLBACK_TOGGLE(
             Menu_Entry::Toggle_Enabled, toggle_enable, enabled_
         ),
+        MAKE_CALLBACK(Menu_Entry::Export_Trace, export_trace),
         MAKE_SEPARATOR(Menu_Entry::Separator_3),
         MAKE_CALLBACK(Menu_Entry::About, show_about),
         MAKE_CALLBACK(Menu_Entry::Help, show_help)
@@ -150,13 +238,25 @@ std::vector<FuncItem> &Linter::on_get_menu_entries()
 
 void Linter::on_notification(SCNotification const *notification)
 {
+    collect_background_results();
+
     if (bg_linter_thread_handle_ != nullptr)
     {
         if (::WaitForSingleObject(bg_linter_thread_handle_, 0) == WAIT_OBJECT_0)
         {
             ::CloseHandle(bg_linter_thread_handle_);
             bg_linter_thread_handle_ = nullptr;
-            highlight_errors();
+            // If the file has changed since the lint started, the results are
+            // out of date (and probably incomplete), so don't display them.
+            if (not file_changed_)
+            {
+                highlight_errors();
+                save_results();
+            }
+            if (not lint_failure_.empty())
+            {
+                show_tooltip(std::exchange(lint_failure_, {}));
+            }
             if (enabled_)
             {
                 relint_current_file();
@@ -176,27 +276,85 @@ void Linter::on_notification(SCNotification const *notification)
         case NPPN_READY:
             send_to_notepad(NPPM_ADDSCNMODIFIEDFLAGS, 0, Modification_Flags);
             notepad_is_ready_ = true;
+            highlights_valid_ = false;
+            current_buffer_ = current_buffer();
+            add_recent_buffer(current_buffer_);
             // New file, mark as changed
             mark_file_changed();
+            lint_open_buffers();
             break;
 
-        case NPPN_BUFFERACTIVATED:    // NOLINT(bugprone-branch-clone)
-            // New file, mark as changed
-            // At this point, we should kill any existing lint.
-            mark_file_changed();
+        case NPPN_BUFFERACTIVATED:
+            // We don't know what is highlighted in this file, and notepad++
+            // will have updated the status bar.
+            highlights_valid_ = false;
+            status_text_.reset();
+            current_buffer_ = notification->nmhdr.idFrom;
+            add_recent_buffer(current_buffer_);
+            // Anything waiting to lint this in the background would be out of
+            // date by the time it runs.
+            scheduler_.cancel(current_buffer_);
+            if (not show_saved_results(notification->nmhdr.idFrom))
+            {
+                // New file, mark as changed. This also kills any existing
+                // lint.
+                mark_file_changed();
+            }
             break;
 
         case NPPN_FILESAVED:
             // If we were very clever, we could check if the file had actually
-            // changed.
-            mark_file_changed();
+            // changed. It might have been renamed, so the saved results might
+            // be for the wrong linters.
+            buffer_results_.erase(notification->nmhdr.idFrom);
+            if (notification->nmhdr.idFrom == current_buffer_)
+            {
+                mark_file_changed();
+            }
+            else
+            {
+                // Saved with "Save All", so the file on disk is up to date.
+                lint_in_background(notification->nmhdr.idFrom);
+            }
+            break;
+
+        case NPPN_FILEOPENED:
+            lint_in_background(notification->nmhdr.idFrom);
             break;
 
+        case NPPN_FILEBEFORECLOSE:
+            buffer_results_.erase(notification->nmhdr.idFrom);
+            scheduler_.cancel(notification->nmhdr.idFrom);
+            std::erase(recent_buffers_, notification->nmhdr.idFrom);
+            if (auto const path = get_buffer_path(notification->nmhdr.idFrom);
+                not path.empty())
+            {
+                temp_files_.remove(get_temp_file_name(path));
+            }
+            break;
+
+        case NPPN_SHUTDOWN:
+        {
+            // Kill off anything we're still running, and wait for the
+            // workers, which can't be done once the DLL is being unloaded.
+            {
+                std::scoped_lock const lock{lint_stop_mutex_};
+                lint_stop_source_.request_stop();
+            }
+            scheduler_.shutdown();
+            servers_.clear();
+            temp_files_.remove_all();
+            break;
+        }
+
         case SCN_MODIFIED:
             // Sadly even with the above call in NPPN_READY, we can't rely on
             // only getting the notifications we asked for.
             if ((notification->modificationType & Modification_Flags) != 0)
             {
+                follow_edit(*notification);
+                buffer_results_.erase(current_buffer_);
+                relint_delay_.edited(Relint_Delay::Clock::now());
                 mark_file_changed();
             }
             break;
@@ -205,7 +363,11 @@ void Linter::on_notification(SCNotification const *notification)
             show_tooltip();
             break;
 
-        case NPPN_SHUTDOWN:
+        case NPPN_LANGCHANGED:
+            // Notepad++ displays the language in the status bar.
+            status_text_.reset();
+            break;
+
         case SCN_PAINTED:
         case SCN_FOCUSIN:
         case SCN_FOCUSOUT:
@@ -216,7 +378,7 @@ void Linter::on_notification(SCNotification const *notification)
 
 void Linter::edit_config() noexcept
 {
-    if (send_to_notepad(NPPM_DOOPEN, 0, settings_->settings_file().c_str())
+    if (send_to_notepad(NPPM_DOOPEN, 0, settings()->settings_file().c_str())
         == FALSE)
     {
         return;
@@ -309,6 +471,12 @@ void Linter::select_previous_lint() noexcept
 void Linter::toggle_enable() noexcept
 {
     enabled_ = not enabled_;
+    buffer_results_.clear();
+    servers_.clear();
+    if (enabled_)
+    {
+        lint_open_buffers();
+    }
     // FIXME abstract this to plugin class?
     send_to_notepad(
         NPPM_SETMENUITEMCHECK,
@@ -318,6 +486,41 @@ void Linter::toggle_enable() noexcept
     mark_file_changed();    // Force an update
 }
 
+void Linter::export_trace() noexcept
+{
+    try
+    {
+        if (not settings()->trace())
+        {
+            message_box(
+                L"Tracing is switched off. Add <trace/> to the <misc> section "
+                L"of the configuration file to switch it on.",
+                MB_OK | MB_ICONINFORMATION
+            );
+            return;
+        }
+        // Write it somewhere it can be opened, and let the user save it
+        // wherever they want.
+        auto const path = std::filesystem::temp_directory_path().append(
+            get_name() + L" trace.json"
+        );
+        {
+            std::ofstream file{path, std::ios::binary};
+            file << Trace::to_json();
+            if (not file)
+            {
+                throw System_Error("Can't write trace file");
+            }
+        }
+        send_to_notepad(NPPM_DOOPEN, 0, path.c_str());
+    }
+    catch (std::exception const &e)
+    {
+#pragma warning(suppress : 26447)
+        message_box(Encoding::convert(e.what()), MB_OK | MB_ICONERROR);
+    }
+}
+
 void Linter::show_about() const
 {
     About_Dialogue const dialogue(*this);
@@ -339,6 +542,11 @@ void Linter::show_help() const noexcept
 void Linter::mark_file_changed() noexcept
 {
     file_changed_ = true;
+    {
+        // Anything currently being linted is now out of date, so stop it.
+        std::scoped_lock const lock{lint_stop_mutex_};
+        lint_stop_source_.request_stop();
+    }
     relint_current_file();
 }
 
@@ -348,47 +556,493 @@ void Linter::relint_current_file() noexcept
     {
         std::ignore =
             ::DeleteTimerQueueTimer(timer_queue_, relint_timer_, nullptr);
+        auto const delay = relint_delay_.delay(get_document_extension());
         ::CreateTimerQueueTimer(
-            &relint_timer_, timer_queue_, relint_timer_callback, this, 300, 0, 0
+            &relint_timer_,
+            timer_queue_,
+            relint_timer_callback,
+            this,
+            static_cast<DWORD>(delay.count()),
+            0,
+            0
+        );
+    }
+}
+
+std::wstring Linter::get_document_extension() noexcept
+{
+    try
+    {
+        return get_document_path().extension().wstring();
+    }
+    catch (std::exception const &)
+    {
+        return {};
+    }
+}
+
+Buffer_Results::Buffer_ID Linter::current_buffer() noexcept
+{
+    return static_cast<Buffer_Results::Buffer_ID>(
+        send_to_notepad(NPPM_GETCURRENTBUFFERID)
+    );
+}
+
+bool Linter::show_saved_results(Buffer_Results::Buffer_ID buffer)
+{
+    // Stop any lint that is waiting to start for the previous buffer. This
+    // waits for the timer callback if it is running, so that it can't start
+    // a lint once we've checked there isn't one.
+    std::ignore = ::DeleteTimerQueueTimer(
+        timer_queue_, relint_timer_, INVALID_HANDLE_VALUE
+    );
+    relint_timer_ = nullptr;
+
+    // If a lint is running, it is updating the results window, so leave it
+    // to finish and then lint this buffer.
+    if (not enabled_ or bg_linter_thread_handle_ != nullptr)
+    {
+        return false;
+    }
+
+    auto const *const results = buffer_results_.find(
+        buffer, send_to_editor(SCI_GETLENGTH), settings()->generation()
+    );
+    if (results == nullptr)
+    {
+        return false;
+    }
+
+    // If this was linted in the background, the buffer might not be the same
+    // as the file was.
+    bool const from_disk = results->text_hash.has_value();
+    if (from_disk
+        and *results->text_hash != Result_Cache::hash(get_document_text()))
+    {
+        buffer_results_.erase(buffer);
+        return false;
+    }
+
+    errors_ = results->errors;
+    output_dialogue_->show_errors(results->errors, results->system_errors);
+
+    if (from_disk)
+    {
+        // Nothing is highlighted yet.
+        highlight_errors();
+        save_results();
+    }
+    else
+    {
+        // Notepad++ keeps the indicators with the buffer, so they are still
+        // there.
+        set_highlights(results->highlights);
+        highlights_valid_ = true;
+        highlights_generation_ = settings()->generation();
+        error_ranges_ = results->error_ranges;
+    }
+
+    file_changed_ = false;
+    show_tooltip();
+    return true;
+}
+
+void Linter::save_results()
+{
+    if (not enabled_)
+    {
+        return;
+    }
+    buffer_results_.set_budget(megabytes(settings()->buffer_results_size()));
+    buffer_results_.store(
+        current_buffer(),
+        {.errors = errors_,
+         .system_errors = output_dialogue_->system_errors(),
+         .highlights = highlights_,
+         .error_ranges = error_ranges_,
+         .length = send_to_editor(SCI_GETLENGTH),
+         .settings_generation = settings()->generation()}
+    );
+}
+
+std::filesystem::path Linter::get_buffer_path(Buffer_Results::Buffer_ID buffer)
+{
+    auto const length =
+        send_to_notepad(NPPM_GETFULLPATHFROMBUFFERID, buffer, nullptr);
+    if (length <= 0)
+    {
+        return {};
+    }
+    std::wstring path(static_cast<std::size_t>(length), L'\0');
+    send_to_notepad(NPPM_GETFULLPATHFROMBUFFERID, buffer, path.data());
+
+    // New buffers don't have a file yet.
+    std::error_code errcode;
+    if (not std::filesystem::is_regular_file(path, errcode))
+    {
+        return {};
+    }
+    return path;
+}
+
+void Linter::lint_open_buffers()
+{
+    std::set<Buffer_Results::Buffer_ID> buffers;
+    for (auto const [view, files] :
+         {std::pair{MAIN_VIEW, PRIMARY_VIEW}, std::pair{SUB_VIEW, SECOND_VIEW}})
+    {
+        auto const count = send_to_notepad(NPPM_GETNBOPENFILES, 0, files);
+        for (LRESULT pos = 0; pos < count; pos += 1)
+        {
+            auto const buffer = static_cast<Buffer_Results::Buffer_ID>(
+                send_to_notepad(NPPM_GETBUFFERIDFROMPOS, pos, view)
+            );
+            if (buffer != 0)
+            {
+                buffers.insert(buffer);
+            }
+        }
+    }
+    for (auto const buffer : buffers)
+    {
+        lint_in_background(buffer);
+    }
+}
+
+void Linter::lint_in_background(Buffer_Results::Buffer_ID buffer)
+{
+    if (not enabled_ or buffer == current_buffer_
+        or buffer_results_.contains(buffer))
+    {
+        return;
+    }
+    auto path = get_buffer_path(buffer);
+    if (path.empty())
+    {
+        return;
+    }
+    auto settings = this->settings();
+    if (settings->get_commands(path).empty())
+    {
+        return;
+    }
+
+    bool const recent =
+        std::ranges::find(recent_buffers_, buffer) != recent_buffers_.end();
+    Trace::enable(settings->trace());
+    scheduler_.set_max_running(settings->max_parallel_linters());
+    servers_.set_settings_generation(settings->generation());
+    scheduler_.run(
+        buffer,
+        recent ? Lint_Scheduler::Priority::Recent
+               : Lint_Scheduler::Priority::Background,
+        [this,
+         buffer,
+         path = std::move(path),
+         settings = std::move(settings)](std::stop_token const &stop)
+        { lint_from_disk(buffer, path, *settings, stop); }
+    );
+}
+
+void Linter::add_recent_buffer(Buffer_Results::Buffer_ID buffer)
+{
+    std::erase(recent_buffers_, buffer);
+    recent_buffers_.push_front(buffer);
+    if (recent_buffers_.size() > Max_Recent_Buffers)
+    {
+        recent_buffers_.pop_back();
+    }
+    for (auto const recent : recent_buffers_)
+    {
+        scheduler_.set_priority(recent, Lint_Scheduler::Priority::Recent);
+    }
+}
+
+void Linter::lint_from_disk(
+    Buffer_Results::Buffer_ID buffer, std::filesystem::path const &path,
+    Settings const &settings, std::stop_token const &stop_token
+)
+{
+    Trace::Span const span{"Background lint"};
+
+    // If anything goes wrong, we just don't save the results. The buffer
+    // gets linted properly (and the problem reported) when it is viewed.
+    try
+    {
+        std::string text;
+        {
+            std::ifstream file{path, std::ios::binary};
+            text.assign(std::istreambuf_iterator<char>{file}, {});
+            if (file.bad())
+            {
+                return;
+            }
+        }
+        auto const text_hash = Result_Cache::hash(text);
+        auto const text_size = text.size();
+
+        File_Linter file{
+            path,
+            get_module_path().parent_path(),
+            get_plugin_config_dir(),
+            settings.get_variables(),
+            settings.variable_cache(),
+            std::move(text),
+            temp_files_,
+            servers_,
+            File_Linter::Target::File
+        };
+        if (not file.warnings().empty())
+        {
+            return;
+        }
+
+        Error_Store errors;
+        for (auto const &command : settings.get_commands(path))
+        {
+            Result_Cache::Key const key{
+                .text_hash = text_hash,
+                .text_size = text_size,
+                .path = path.wstring(),
+                .command = get_command_key(command),
+                .settings_generation = settings.generation()
+            };
+            if (auto const cached = result_cache_.find(key))
+            {
+                command_statistics_.cache_hit(key.command);
+                errors.append(*cached);
+                continue;
+            }
+            auto const linter_result = file.run_linter(command, stop_token);
+            auto const &[cmdline, result, output, errout, time] =
+                linter_result;
+            if (stop_token.stop_requested())
+            {
+                command_statistics_.cancelled(key.command);
+                return;
+            }
+            if (not errout.empty())
+            {
+                record_run(key.command, linter_result, 0, true);
+                return;
+            }
+            Error_Store detected_errors;
+            Checkstyle_Parser::get_errors(
+                output,
+                [&detected_errors](Error_Info &&error)
+                { detected_errors.add(error); }
+            );
+            record_run(
+                key.command, linter_result, detected_errors.size(), false
+            );
+            result_cache_.store(key, detected_errors);
+            errors.append(detected_errors);
+        }
+
+        std::scoped_lock const lock{background_mutex_};
+        background_results_.push_back(Background_Result{
+            .buffer = buffer,
+            .errors = std::move(errors),
+            .text_hash = text_hash,
+            .length = static_cast<LRESULT>(text_size),
+            .settings_generation = settings.generation()
+        });
+    }
+    catch (std::exception const &err)
+    {
+        std::ignore = err;
+    }
+}
+
+void Linter::collect_background_results()
+{
+    std::vector<Background_Result> results;
+    {
+        std::scoped_lock const lock{background_mutex_};
+        if (background_results_.empty())
+        {
+            return;
+        }
+        results.swap(background_results_);
+    }
+    if (not enabled_)
+    {
+        return;
+    }
+
+    buffer_results_.set_budget(megabytes(settings()->buffer_results_size()));
+    for (auto &result : results)
+    {
+        // Don't overwrite the results of a lint of the buffer itself.
+        if (result.buffer == current_buffer_
+            or buffer_results_.contains(result.buffer))
+        {
+            continue;
+        }
+        buffer_results_.store(
+            result.buffer,
+            {.errors = std::move(result.errors),
+             .length = result.length,
+             .settings_generation = result.settings_generation,
+             .text_hash = result.text_hash}
         );
     }
 }
 
 void Linter::highlight_errors()
 {
-    clear_error_highlights();
-    errors_by_position_.clear();
-    if (not errors_.empty())
+    Trace::Span const span{"Highlight errors"};
+
+    auto wanted = get_error_highlights();
+    if (not wanted.empty())
     {
         setup_error_indicator();
     }
 
-    for (Error_Info const &error : errors_)
+    // If the settings have changed, the colours might be different.
+    if (highlights_generation_ != settings()->generation())
     {
-        auto position = send_to_editor(
-            SCI_POSITIONFROMLINE, static_cast<WPARAM>(error.line_) - 1
-        );
-        // This cast seems pretty pointless though visual c++ editor complains
-        // about sub expressions overflowing otherwise.
-        position += static_cast<LRESULT>(Encoding::utfOffset(
-            get_line_text(error.line_ - 1), error.column_ - 1
-        ));
-        errors_by_position_[position] = error.message_;
-        highlight_error_at(
-            position, settings_->get_message_colour(error.severity_)
+        highlights_valid_ = false;
+        highlights_generation_ = settings()->generation();
+    }
+
+    if (highlights_valid_)
+    {
+        apply_edits_to_highlights();
+    }
+    else
+    {
+        clear_error_highlights();
+        set_highlights({});
+    }
+
+    {
+        Scintilla_Highlights editor{*this};
+        update_highlights(
+            editor,
+            highlights_,
+            wanted,
+            settings()->indicator().colour_as_message()
         );
     }
+
+    set_highlights(std::move(wanted));
+    highlights_valid_ = true;
+}
+
+void Linter::follow_edit(SCNotification const &notification)
+{
+    // Scintilla moves the indicators along with the text, so we do the same
+    // with where we think they are, and the tooltips stay right till the next
+    // lint.
+    auto const position = static_cast<std::intptr_t>(notification.position);
+    auto const length = static_cast<std::intptr_t>(notification.length);
+    if ((notification.modificationType & SC_MOD_INSERTTEXT) == 0)
+    {
+        highlight_positions_.delete_text(position, length);
+        error_ranges_.delete_text(position, length);
+        return;
+    }
+
+    // If two errors next to each other have the same colour, scintilla treats
+    // them as one indicator, and text inserted between them gets highlighted
+    // too. We don't keep track of that, so have to start again.
+    auto const after = highlight_positions_.lower_bound(position);
+    auto const before = highlight_positions_.lower_bound(position - 1);
+    if (before < after and after < highlight_positions_.size()
+        and highlight_positions_.position(before) == position - 1
+        and highlight_positions_.position(after) == position)
+    {
+        highlights_valid_ = false;
+    }
+    highlight_positions_.insert_text(position, length);
+    error_ranges_.insert_text(position, length);
 }
 
-// NOLINTNEXTLINE(bugprone-easily-swappable-parameters)
-void Linter::highlight_error_at(LRESULT position, uint32_t col) noexcept
+void Linter::set_highlights(Error_Highlights highlights)
 {
-    Save_Selected_Indicator const indicator(*this);
-    if (settings_->indicator().colour_as_message())
+    highlights_ = std::move(highlights);
+    std::vector<std::intptr_t> positions;
+    positions.reserve(highlights_.size());
+    for (auto const &highlight : highlights_)
+    {
+        positions.push_back(highlight.first);
+    }
+    highlight_positions_.assign(std::move(positions));
+}
+
+void Linter::apply_edits_to_highlights()
+{
+    if (not highlight_positions_.edited())
+    {
+        return;
+    }
+    Error_Highlights highlights;
+    std::size_t index = 0;
+    for (auto const &highlight : highlights_)
+    {
+        if (not highlight_positions_.removed(index))
+        {
+            highlights.emplace_hint(
+                highlights.end(),
+                highlight_positions_.position(index),
+                highlight.second
+            );
+        }
+        index += 1;
+    }
+    set_highlights(std::move(highlights));
+}
+
+Error_Highlights Linter::get_error_highlights()
+{
+    // Process the errors a line at a time, so the index only needs to fetch
+    // the text of each line once. The sort is stable, so where there are
+    // several errors at the same place the last one reported wins, as it did
+    // when they were processed in order.
+    std::vector<std::size_t> errors(errors_.size());
+    std::iota(errors.begin(), errors.end(), std::size_t{0});
+    std::stable_sort(
+        errors.begin(),
+        errors.end(),
+        [this](std::size_t lhs, std::size_t rhs) noexcept
+        { return errors_.line(lhs) < errors_.line(rhs); }
+    );
+
+    Position_Index index{
+        [this](int line)
+        {
+            return static_cast<std::intptr_t>(
+                send_to_editor(SCI_POSITIONFROMLINE, static_cast<WPARAM>(line))
+            );
+        },
+        [this](int line) { return get_line_text(line); }
+    };
+
+    Error_Highlights highlights;
+    std::vector<Error_Ranges::Range> ranges;
+    ranges.reserve(errors.size());
+    for (auto const error : errors)
     {
-        send_to_editor(SCI_SETINDICATORVALUE, SC_INDICVALUEBIT | col);
+        auto const position =
+            index.position(errors_.line(error), errors_.column(error));
+        highlights.insert_or_assign(
+            position,
+            Error_Highlight{
+                .colour =
+                    settings()->get_message_colour(errors_.severity(error))
+            }
+        );
+        // The indicator is one character wide, so show the message if the
+        // caret is either side of it.
+        ranges.push_back(
+            {.start = position,
+             .end = position + 1,
+             .message = std::wstring{errors_.message(error)}}
+        );
     }
-    send_to_editor(SCI_INDICATORFILLRANGE, position, 1);
+    error_ranges_.assign(std::move(ranges));
+    return highlights;
 }
 
 void Linter::clear_error_highlights() noexcept
@@ -416,7 +1070,7 @@ void Linter::setup_error_indicator()
         {Indicator::Hover_Colour,    SCI_INDICSETHOVERFORE   },
     };
 
-    for (auto const &[command, value] : settings_->indicator().properties())
+    for (auto const &[command, value] : settings()->indicator().properties())
     {
         send_to_editor(cmd_map.at(command), Error_Indicator, value);
     }
@@ -437,6 +1091,11 @@ void Linter::start_async_timer() noexcept
         // The thread is doing something...
         return;
     }
+    {
+        std::scoped_lock const lock{lint_stop_mutex_};
+        lint_stop_source_ = std::stop_source{};
+        lint_stop_token_ = lint_stop_source_.get_token();
+    }
     unsigned thread_id{0};
     bg_linter_thread_handle_ = windows_cast_to<HANDLE, uintptr_t>(
         _beginthreadex(nullptr, 0, &run_linter_thread, this, 0, &thread_id)
@@ -472,10 +1131,11 @@ unsigned int Linter::run_linter() noexcept
 {
     try
     {
+        lint_failure_.clear();
         output_dialogue_->disable_redraw();
         try
         {
-            apply_linters();
+            apply_linters(lint_stop_token_);
         }
         catch (XML_Decode_Error const &e)
         {
@@ -487,7 +1147,7 @@ unsigned int Linter::run_linter() noexcept
                  .line_ = e.line(),
                  .column_ = e.column()}
             );
-            show_tooltip(wstr);
+            lint_failure_ = wstr;
         }
         catch (std::exception const &e)
         {
@@ -496,7 +1156,7 @@ unsigned int Linter::run_linter() noexcept
             output_dialogue_->add_system_error(
                 {.message_ = wstr, .mode_ = Error_Info::Exception}
             );
-            show_tooltip(wstr);
+            lint_failure_ = wstr;
         }
         output_dialogue_->enable_redraw();
     }
@@ -508,38 +1168,81 @@ unsigned int Linter::run_linter() noexcept
     return 0;
 }
 
-void Linter::apply_linters()
+void Linter::apply_linters(std::stop_token const &stop_token)
 {
+    Trace::Span const span{"Lint"};
+
     errors_.clear();
     output_dialogue_->clear_lint_info();
 
     if (not enabled_)
     {
-        std::vector<Error_Info> const detected_errors{
-            {.message_ = L"Linting disabled", .severity_ = L"warning"}
+        Error_Info const disabled{
+            .message_ = L"Linting disabled", .severity_ = L"warning"
         };
-        output_dialogue_->add_system_error(detected_errors.at(0));
+        Error_Store detected_errors;
+        detected_errors.add(disabled);
+        output_dialogue_->add_system_error(disabled);
         output_dialogue_->add_lint_errors(detected_errors);
         return;
     }
 
-    settings_->refresh();
+    // If the configuration file is broken, say so rather than carry on with
+    // the old settings.
+    settings_watcher_.check();
+    auto const settings = this->settings();
+    Trace::enable(settings->trace());
+    scheduler_.set_max_running(settings->max_parallel_linters());
+    servers_.set_settings_generation(settings->generation());
+    relint_delay_.set_limits(
+        Relint_Delay::Duration{settings->min_relint_delay()},
+        Relint_Delay::Duration{settings->max_relint_delay()}
+    );
 
     auto const full_path = get_document_path();
+    auto const &commands = settings->get_commands(full_path);
 
-    std::vector<Settings::Command> commands;
+    if (commands.empty())
+    {
+        return;
+    }
+
+    std::string text{get_document_text()};
+    auto const text_hash = Result_Cache::hash(text);
+    auto const text_size = text.size();
+    auto const generation = settings->generation();
+    auto const make_key = [&](Settings::Command const &command)
     {
-        auto const extension = full_path.extension();
-        for (auto const &linter : settings_->linters())
+        return Result_Cache::Key{
+            .text_hash = text_hash,
+            .text_size = text_size,
+            .path = full_path.wstring(),
+            .command = get_command_key(command),
+            .settings_generation = generation
+        };
+    };
+
+    // Use the saved results for any linter that has already been run on
+    // exactly this text.
+    result_cache_.set_budget(megabytes(settings->result_cache_size()));
+    std::vector<Settings::Command> uncached;
+    for (auto const &command : commands)
+    {
+        auto const key = make_key(command);
+        auto const cached = result_cache_.find(key);
+        if (cached)
         {
-            if (linter.extension == extension)
-            {
-                commands.emplace_back(linter.command);
-            }
+            command_statistics_.cache_hit(key.command);
+            errors_.append(*cached);
+            output_dialogue_->add_lint_errors(*cached);
+        }
+        else
+        {
+            uncached.push_back(command);
         }
     }
 
-    if (commands.empty())
+    if (uncached.empty())
     {
         return;
     }
@@ -548,8 +1251,14 @@ void Linter::apply_linters()
         full_path,
         get_module_path().parent_path(),
         get_plugin_config_dir(),
-        settings_->get_variables(),
-        get_document_text()
+        settings->get_variables(),
+        settings->variable_cache(),
+        std::move(text),
+        temp_files_,
+        servers_,
+        choose_lint_target(
+            full_path, send_to_editor(SCI_GETMODIFY) != 0, text_size
+        )
     };
 
     for (auto const &warning : file.warnings())
@@ -561,78 +1270,138 @@ void Linter::apply_linters()
         );
     }
 
-    for (auto const &command : commands)
+    auto const start = Relint_Delay::Clock::now();
+    file.run_linters(
+        uncached,
+        scheduler_,
+        stop_token,
+        [this, &make_key](
+            Settings::Command const &command,
+            std::future<File_Linter::Linter_Result> &linter_result
+        ) { process_linter_result(command, linter_result, make_key(command)); }
+    );
+    // Only complete lints tell us how long the linters take.
+    if (not stop_token.stop_requested())
     {
+        relint_delay_.linted(
+            full_path.extension().wstring(),
+            std::chrono::duration_cast<Relint_Delay::Duration>(
+                Relint_Delay::Clock::now() - start
+            )
+        );
+    }
+}
+
+void Linter::process_linter_result(
+    Settings::Command const &command,
+    std::future<File_Linter::Linter_Result> &linter_result,
+    Result_Cache::Key const &key
+)
+{
+    try
+    {
+        // Try and work out what to do here:
+        auto const linter_output = linter_result.get();
+        auto const &[cmdline, result, output, errout, time] = linter_output;
+        if (output.empty() && not errout.empty())
+        {
+            record_run(key.command, linter_output, 0, true);
+            // Program terminated with error.
+            output_dialogue_->add_system_error(
+                {.message_ = Encoding::convert(errout),
+                 .tool_ = command.program.stem(),
+                 .command_ = cmdline,
+                 .stdout_ = output,
+                 .stderr_ = errout,
+                 .mode_ = Error_Info::Stderr_Found,
+                 .result_ = result}
+            );
+            return;
+        }
         try
         {
-            // Try and work out what to do here:
-            auto const [cmdline, result, output, errout] =
-                file.run_linter(command);
-            if (output.empty() && not errout.empty())
+            Error_Store detected_errors;
+            Checkstyle_Parser::get_errors(
+                output,
+                [&detected_errors](Error_Info &&error)
+                { detected_errors.add(error); }
+            );
+            record_run(
+                key.command,
+                linter_output,
+                detected_errors.size(),
+                not errout.empty()
+            );
+            errors_.append(detected_errors);
+            output_dialogue_->add_lint_errors(detected_errors);
+            if (not errout.empty())
             {
-                // Program terminated with error.
                 output_dialogue_->add_system_error(
                     {.message_ = Encoding::convert(errout),
+                     .severity_ = L"warning",
                      .tool_ = command.program.stem(),
                      .command_ = cmdline,
                      .stdout_ = output,
                      .stderr_ = errout,
-                     .mode_ = Error_Info::Stderr_Found,
-                     .result_ = result}
+                     .mode_ = Error_Info::Stderr_Found}
                 );
-                continue;
             }
-            try
+            else
             {
-                std::vector<Error_Info> const detected_errors{
-                    Checkstyle_Parser::get_errors(output)
-                };
-                errors_.insert(
-                    errors_.end(),
-                    detected_errors.begin(),
-                    detected_errors.end()
-                );
-                output_dialogue_->add_lint_errors(detected_errors);
-                if (not errout.empty())
-                {
-                    output_dialogue_->add_system_error(
-                        {.message_ = Encoding::convert(errout),
-                         .severity_ = L"warning",
-                         .tool_ = command.program.stem(),
-                         .command_ = cmdline,
-                         .stdout_ = output,
-                         .stderr_ = errout,
-                         .mode_ = Error_Info::Stderr_Found}
-                    );
-                }
-            }
-            catch (XML_Decode_Error const &e)
-            {
-                std::string const exc{e.what()};
-                output_dialogue_->add_system_error(
-                    {.message_ = Encoding::convert(exc),
-                     .tool_ = command.program.stem(),
-                     .command_ = cmdline,
-                     .stdout_ = output,
-                     .stderr_ = errout,
-                     .mode_ = Error_Info::Bad_Output,
-                     .line_ = e.line(),
-                     .column_ = e.column()}
-                );
+                // Only save clean results, as anything else might have been
+                // a transient problem.
+                result_cache_.store(key, detected_errors);
             }
         }
-        catch (std::exception const &e)
+        catch (XML_Decode_Error const &e)
         {
-            // Really bad things happened. we don't have anything much here we
-            // can log
+            record_run(key.command, linter_output, 0, true);
             std::string const exc{e.what()};
             output_dialogue_->add_system_error(
                 {.message_ = Encoding::convert(exc),
                  .tool_ = command.program.stem(),
-                 .mode_ = Error_Info::Exception}
+                 .command_ = cmdline,
+                 .stdout_ = output,
+                 .stderr_ = errout,
+                 .mode_ = Error_Info::Bad_Output,
+                 .line_ = e.line(),
+                 .column_ = e.column()}
             );
         }
     }
+    catch (std::exception const &e)
+    {
+        // Really bad things happened. we don't have anything much here we
+        // can log
+        std::string const exc{e.what()};
+        output_dialogue_->add_system_error(
+            {.message_ = Encoding::convert(exc),
+             .tool_ = command.program.stem(),
+             .mode_ = Error_Info::Exception}
+        );
+    }
+}
+
+void Linter::record_run(
+    std::wstring const &command,
+    File_Linter::Linter_Result const &linter_result, std::size_t errors,
+    bool failed
+)
+{
+    auto const &[cmdline, result, output, errout, time] = linter_result;
+    if (result == ERROR_CANCELLED)
+    {
+        command_statistics_.cancelled(command);
+        return;
+    }
+    command_statistics_.ran(
+        command,
+        {.time = time,
+         .stdout_bytes = output.size(),
+         .stderr_bytes = errout.size(),
+         .errors = errors,
+         .failed = failed}
+    );
 }
 
 void Linter::show_tooltip()
@@ -643,43 +1412,41 @@ void Linter::show_tooltip()
 void Linter::show_tooltip(std::wstring message)
 {
     LRESULT const position = send_to_editor(SCI_GETCURRENTPOS);
-    auto const error = errors_by_position_.find(position);
-    if (error == errors_by_position_.end())
+    auto const errors = error_ranges_.find(position);
+    if (not errors.empty())
     {
-        wchar_t title[256];
-        ::SendMessage(
-            npp_statusbar_,
-            WM_GETTEXT,
-            sizeof(title) / sizeof(title[0]) - 1,
-            windows_cast_to<LPARAM, wchar_t *>(&title[0])
-        );
-
-        std::wstring const str(&title[0]);
-        if (message.empty() && str.starts_with(L" - "))
-        {
-            message = L" - ";
-        }
-
-        if (not message.empty())
+        message = L" - " + errors;
+    }
+    else if (message.empty())
+    {
+        // If we are displaying an error message, remove it. We only need to
+        // ask the status bar if notepad++ might have changed it.
+        if (not status_text_.has_value())
         {
+            wchar_t title[256];
             ::SendMessage(
                 npp_statusbar_,
-                WM_SETTEXT,
-                0,
-                windows_cast_to<LPARAM, wchar_t const *>(message.c_str())
+                WM_GETTEXT,
+                sizeof(title) / sizeof(title[0]) - 1,
+                windows_cast_to<LPARAM, wchar_t *>(&title[0])
             );
+            status_text_ = &title[0];
+        }
+        if (status_text_->starts_with(L" - "))
+        {
+            message = L" - ";
         }
     }
-    else
+
+    if (not message.empty() and message != status_text_)
     {
         ::SendMessage(
             npp_statusbar_,
             WM_SETTEXT,
             0,
-            windows_cast_to<LPARAM, wchar_t const *>(
-                (std::wstring(L" - ") + error->second).c_str()
-            )
+            windows_cast_to<LPARAM, wchar_t const *>(message.c_str())
         );
+        status_text_ = std::move(message);
     }
 }
 
@@ -4,16 +4,38 @@
 // it doesn't understand inheritance
 #include "Plugin/Plugin.h"
 
+#include "Buffer_Results.h"
+#include "Command_Statistics.h"
+#include "Error_Highlights.h"
 #include "Error_Info.h"
+#include "Error_Ranges.h"
+#include "Error_Store.h"
+#include "File_Linter.h"
+#include "Lint_Scheduler.h"
+#include "Linter_Servers.h"
+#include "Moving_Positions.h"
+#include "Relint_Delay.h"
+#include "Result_Cache.h"
+#include "Settings.h"
+#include "Settings_Watcher.h"
+#include "Temp_Files.h"
 
 #include <minwindef.h>
 #include <windef.h>    // For HWND
 #include <winnt.h>
 
+#include <atomic>
+#include <cstddef>
 #include <cstdint>    // For uint32_t
-#include <map>
+#include <deque>
+#include <filesystem>
+#include <future>
 #include <memory>
+#include <mutex>
+#include <optional>
+#include <stop_token>
 #include <string>
+#include <thread>
 #include <vector>
 
 struct FuncItem;
@@ -25,7 +47,6 @@ namespace Linter
 
 // Forward refs
 class Output_Dialogue;
-class Settings;
 
 class Linter : public Plugin
 {
@@ -44,9 +65,28 @@ class Linter : public Plugin
     /** Return the plugin name */
     static wchar_t const *get_plugin_name() noexcept;
 
-    Settings const *settings() const noexcept
+    /** Get the current settings */
+    std::shared_ptr<Settings const> settings() const noexcept
     {
-        return settings_.get();
+        return settings_watcher_.settings();
+    }
+
+    /** Get the usage of the linter result cache */
+    Result_Cache::Statistics result_cache_statistics() const
+    {
+        return result_cache_.statistics();
+    }
+
+    /** Get how each linter command has performed */
+    Command_Statistics const &command_statistics() const noexcept
+    {
+        return command_statistics_;
+    }
+
+    /** Get how long to wait after a change before linting */
+    Relint_Delay const &relint_delay() const noexcept
+    {
+        return relint_delay_;
     }
 
   private:
@@ -61,6 +101,7 @@ class Linter : public Plugin
     void select_next_lint() noexcept;
     void select_previous_lint() noexcept;
     void toggle_enable() noexcept;
+    void export_trace() noexcept;
     void show_about() const;
     void show_help() const noexcept;
 
@@ -70,9 +111,79 @@ class Linter : public Plugin
     // Schedule lint of current file if necessary
     void relint_current_file() noexcept;
 
+    /** Get the extension of the current file, to find out how long its
+     * linters take
+     */
+    std::wstring get_document_extension() noexcept;
+
+    /** Get the notepad++ id of the current buffer */
+    Buffer_Results::Buffer_ID current_buffer() noexcept;
+
+    /** Show the saved results for a buffer, if it hasn't changed since they
+     * were saved.
+     *
+     * Returns false if it needs linting.
+     */
+    bool show_saved_results(Buffer_Results::Buffer_ID);
+
+    /** Move the error positions to follow an insertion or deletion */
+    void follow_edit(SCNotification const &);
+
+    /** Set what is currently highlighted */
+    void set_highlights(Error_Highlights);
+
+    /** Update highlights_ with the edits made since it was set */
+    void apply_edits_to_highlights();
+
+    /** Save the results of the lint of the current buffer */
+    void save_results();
+
+    /** Get the full path of a buffer, or an empty path if it isn't a file */
+    std::filesystem::path get_buffer_path(Buffer_Results::Buffer_ID);
+
+    /** Queue background lints of all the open buffers except the current
+     * one
+     */
+    void lint_open_buffers();
+
+    /** Queue a background lint of a buffer from the file on disk */
+    void lint_in_background(Buffer_Results::Buffer_ID);
+
+    /** Make a buffer the most recently viewed one */
+    void add_recent_buffer(Buffer_Results::Buffer_ID);
+
+    /** The results of linting a buffer in the background */
+    struct Background_Result
+    {
+        Buffer_Results::Buffer_ID buffer;
+        Error_Store errors;
+        std::uint64_t text_hash;
+        LRESULT length;
+        unsigned int settings_generation;
+    };
+
+    /** Lint a file on disk. This is run by the scheduler */
+    void lint_from_disk(
+        Buffer_Results::Buffer_ID, std::filesystem::path const &,
+        Settings const &, std::stop_token const &
+    );
+
+    /** Move any completed background lints into buffer_results_ */
+    void collect_background_results();
+
+    /** Update the error indicators to match the current set of errors.
+     *
+     * Only the indicators that have changed since the last call are updated,
+     * unless the editor contents have been changed in the meantime.
+     */
     void highlight_errors();
 
-    void highlight_error_at(LRESULT pos, uint32_t col) noexcept;
+    /** Get the editor position of each error.
+     *
+     * This also updates the ranges used to find the message for the caret
+     * position.
+     */
+    Error_Highlights get_error_highlights();
 
     void clear_error_highlights() noexcept;
 
@@ -89,7 +200,19 @@ class Linter : public Plugin
     unsigned int run_linter() noexcept;
 
     // Apply all the applicable linters to the current buffer.
-    void apply_linters();
+    void apply_linters(std::stop_token const &);
+
+    // Process the output from one linter.
+    void process_linter_result(
+        Settings::Command const &, std::future<File_Linter::Linter_Result> &,
+        Result_Cache::Key const &
+    );
+
+    /** Record how a run of a linter went in the command statistics */
+    void record_run(
+        std::wstring const &command, File_Linter::Linter_Result const &,
+        std::size_t errors, bool failed
+    );
 
     // Shows tooltip in notepad++ window.
     void show_tooltip();
@@ -97,8 +220,11 @@ class Linter : public Plugin
     // Ditto with optional message
     void show_tooltip(std::wstring message);
 
-    // Settings
-    std::unique_ptr<Settings> settings_;
+    // Rereads the settings when the configuration file changes
+    Settings_Watcher settings_watcher_;
+
+    // The settings the menu was made from
+    std::shared_ptr<Settings const> menu_settings_;
 
     // Messages dockable box
     std::unique_ptr<Output_Dialogue> output_dialogue_;
@@ -112,6 +238,20 @@ class Linter : public Plugin
     // Background thread that spawns linters and collects results.
     HANDLE bg_linter_thread_handle_{nullptr};
 
+    // Why the last lint failed, if it did. This is set by the lint thread and
+    // shown in the status bar by the notepad++ thread once the lint thread
+    // has finished, as only the notepad++ thread can touch the status bar.
+    std::wstring lint_failure_;
+
+    // Used to cancel the current lint if the buffer is changed.
+    std::stop_source lint_stop_source_;
+
+    // Token passed to the background thread.
+    std::stop_token lint_stop_token_;
+
+    // Protects lint_stop_source_, which is updated from the timer thread.
+    std::mutex lint_stop_mutex_;
+
     // Set once notepad is fully initialised
     bool notepad_is_ready_{false};
 
@@ -119,10 +259,57 @@ class Linter : public Plugin
     bool file_changed_{true};
 
     // List of errors picked up in latest lint(s)
-    std::vector<Error_Info> errors_;
+    Error_Store errors_;
+
+    // Errors from previous lints, so unchanged files aren't relinted
+    Result_Cache result_cache_;
+
+    // How each linter command has performed
+    Command_Statistics command_statistics_;
+
+    // Copies of modified buffers for linters that read %LINTER_TARGET%
+    Temp_Files temp_files_;
+
+    // Works out how long to wait after a change before linting
+    Relint_Delay relint_delay_;
+
+    // Linters which are kept running between lints
+    Linter_Servers servers_;
 
-    // Same but by position in window
-    std::map<LRESULT, std::wstring> errors_by_position_;
+    // Results of the last lint of each open buffer
+    Buffer_Results buffer_results_;
+
+    // Buffers that have been viewed, most recent first
+    std::deque<Buffer_Results::Buffer_ID> recent_buffers_;
+
+    // The current buffer, which the timer thread needs to know
+    std::atomic<Buffer_Results::Buffer_ID> current_buffer_{0};
+
+    // Completed background lints waiting to be collected by the notepad++
+    // thread
+    std::vector<Background_Result> background_results_;
+
+    // Protects background_results_
+    std::mutex background_mutex_;
+
+    // Error messages by position in window
+    Error_Ranges error_ranges_;
+
+    // What we last put in the status bar, if we know
+    std::optional<std::wstring> status_text_;
+
+    // What is currently highlighted, by position in window when it was
+    // highlighted
+    Error_Highlights highlights_;
+
+    // Where the highlights are now, after any edits
+    Moving_Positions highlight_positions_;
+
+    // Set if highlights_ matches what is shown in the editor
+    bool highlights_valid_{false};
+
+    // Settings generation used for highlights_
+    unsigned int highlights_generation_{0};
 
     // Whether the linter is enabled
     bool enabled_;
@@ -131,6 +318,10 @@ class Linter : public Plugin
     std::vector<FuncItem> menu_entries_;
 
     HWND npp_statusbar_;
+
+    // Runs all the linters. This is last, so that it stops the workers before
+    // anything they use is destroyed.
+    Lint_Scheduler scheduler_{std::thread::hardware_concurrency()};
 };
 
 }    // namespace Linter
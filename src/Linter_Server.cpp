@@ -0,0 +1,406 @@
+#include "Linter_Server.h"
+
+#include "Child_Pipe.h"
+#include "Child_Process.h"
+#include "Encoding.h"
+#include "Handle_Wrapper.h"
+#include "Server_Protocol.h"
+#include "System_Error.h"
+
+#include <errhandlingapi.h>
+#include <fileapi.h>
+#include <intsafe.h>
+#include <ioapiset.h>
+#include <minwinbase.h>
+#include <minwindef.h>
+#include <synchapi.h>
+#include <winbase.h>
+#include <winerror.h>
+#include <winnt.h>
+
+#include <wil/resource.h>
+
+#include <array>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stop_token>
+#include <string>
+#include <utility>
+
+namespace Linter
+{
+
+namespace
+{
+
+constexpr DWORD Read_Size = 0x10000;
+
+/** How long to give a server whose output has closed to finish exiting, in
+ * milliseconds
+ */
+constexpr DWORD Exit_Wait = 100;
+
+/** The temporary file for the server's stderr */
+struct Error_File
+{
+    /** Inheritable, for the server */
+    Handle_Wrapper writer;
+    /** Ours, which has its own position in the file */
+    Handle_Wrapper reader;
+};
+
+Error_File create_error_file()
+{
+    std::array<wchar_t, MAX_PATH> name{};
+    if (GetTempFileName(
+            std::filesystem::temp_directory_path().c_str(),
+            L"lpp",
+            0,
+            name.data()
+        )
+        == 0)
+    {
+        throw System_Error("Can't create linter server error file");
+    }
+    SECURITY_ATTRIBUTES security = {
+        .nLength = sizeof(SECURITY_ATTRIBUTES),
+        .lpSecurityDescriptor = nullptr,
+        .bInheritHandle = TRUE,
+    };
+    // The file is deleted when the last handle to it is closed, so nothing is
+    // left behind whatever happens to us.
+    HANDLE const writer = CreateFile(
+        name.data(),
+        GENERIC_WRITE,
+        FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+        &security,
+        CREATE_ALWAYS,
+        FILE_ATTRIBUTE_TEMPORARY | FILE_FLAG_DELETE_ON_CLOSE,
+        nullptr
+    );
+    if (writer == INVALID_HANDLE_VALUE)
+    {
+        DWORD const err = GetLastError();
+        DeleteFile(name.data());
+        throw System_Error(err, "Can't create linter server error file");
+    }
+    Handle_Wrapper writer_handle{writer};
+    return Error_File{
+        .writer = std::move(writer_handle),
+        .reader = Handle_Wrapper{CreateFile(
+            name.data(),
+            GENERIC_READ,
+            FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+            nullptr,
+            OPEN_EXISTING,
+            FILE_ATTRIBUTE_NORMAL,
+            nullptr
+        )}
+    };
+}
+
+}    // namespace
+
+/** The server process, and our ends of its pipes and its error file */
+struct Linter_Server::Process
+{
+    // The server's copy of the error file is closed once it has been started.
+    Process(Linter_Server const &server, Error_File error_file) :
+        input(Child_Pipe::create_input_pipe()),
+        output(Child_Pipe::create_output_pipe()),
+        child(
+            server.program_, server.command_line_, server.environment_,
+            server.directory_, input.reader(), output.writer(),
+            error_file.writer
+        ),
+        read_event(CreateEvent(nullptr, TRUE, FALSE, nullptr)),
+        errors(std::move(error_file.reader))
+    {
+        if (not read_event)
+        {
+            child.terminate(ERROR_CANCELLED);
+            throw System_Error();
+        }
+        // We have to close our copy of the server's end of its output, or
+        // we won't notice if it dies.
+        input.reader().close();
+        output.writer().close();
+    }
+
+    Process(Process const &) = delete;
+    Process(Process &&) = delete;
+    Process &operator=(Process const &) = delete;
+    Process &operator=(Process &&) = delete;
+
+    ~Process()
+    {
+        child.terminate(ERROR_CANCELLED);
+    }
+
+    Child_Pipe input;
+    Child_Pipe output;
+    Child_Process child;
+    wil::unique_handle read_event;
+    Handle_Wrapper errors;
+};
+
+Linter_Server::Linter_Server(
+    std::wstring program, std::wstring command_line, std::wstring environment,
+    std::filesystem::path directory
+) :
+    program_(std::move(program)),
+    command_line_(std::move(command_line)),
+    environment_(std::move(environment)),
+    directory_(std::move(directory)),
+    read_buffer_(Read_Size)
+{
+}
+
+Linter_Server::~Linter_Server() = default;
+
+std::optional<Linter_Server::Reply> Linter_Server::lint(
+    std::filesystem::path const &path, std::string const &text,
+    std::stop_token const &stop_token
+)
+{
+    wil::unique_handle const stop_event{
+        CreateEvent(nullptr, TRUE, FALSE, nullptr)
+    };
+    if (not stop_event)
+    {
+        throw System_Error();
+    }
+    std::stop_callback const stopper{
+        stop_token,
+        [&stop_event]() noexcept { SetEvent(stop_event.get()); }
+    };
+
+    // Wait for any other request to finish, unless we're stopped first.
+    {
+        std::unique_lock lock{mutex_};
+        if (not idle_.wait(
+                lock, stop_token, [this]() noexcept { return not busy_; }
+            ))
+        {
+            return std::nullopt;
+        }
+        busy_ = true;
+    }
+    class Release
+    {
+      public:
+        explicit Release(Linter_Server &server) noexcept : server_(server)
+        {
+        }
+
+        Release(Release const &) = delete;
+        Release(Release &&) = delete;
+        Release &operator=(Release const &) = delete;
+        Release &operator=(Release &&) = delete;
+
+        ~Release()
+        {
+            {
+                std::scoped_lock const lock{server_.mutex_};
+                server_.busy_ = false;
+            }
+            server_.idle_.notify_one();
+        }
+
+      private:
+        Linter_Server &server_;
+    } const release{*this};
+
+    // What happened to any servers that died while handling this request
+    std::string failures;
+    DWORD exit_code = 0;
+    for (int attempt = 0;; attempt += 1)
+    {
+        try
+        {
+            if (not process_)
+            {
+                start();
+            }
+
+            // Skip the replies to anything that got cancelled. This can take
+            // a while if the server is still working on them, but it can't
+            // look at our request till it's done anyway.
+            while (unwanted_replies_ != 0)
+            {
+                if (not receive(stop_event.get()).has_value())
+                {
+                    return std::nullopt;
+                }
+                unwanted_replies_ -= 1;
+            }
+
+            send(path, text, stop_token);
+            auto reply = receive(stop_event.get());
+            if (not reply.has_value())
+            {
+                unwanted_replies_ += 1;
+                return reply;
+            }
+            reply->error_output =
+                failures + reply->error_output + read_errors();
+            reply->exit_code = exit_code;
+            return reply;
+        }
+        catch (System_Error const &error)
+        {
+            if (stop_token.stop_requested())
+            {
+                stop();
+                return std::nullopt;
+            }
+            failures += describe_failure(error, exit_code);
+            stop();
+            if (attempt != 0)
+            {
+                return Reply{.error_output = failures, .exit_code = exit_code};
+            }
+        }
+    }
+}
+
+void Linter_Server::start()
+{
+    process_ = std::make_unique<Process>(*this, create_error_file());
+    received_.clear();
+    unwanted_replies_ = 0;
+}
+
+void Linter_Server::stop() noexcept
+{
+    process_.reset();
+    received_.clear();
+    unwanted_replies_ = 0;
+}
+
+std::string Linter_Server::describe_failure(
+    std::exception const &error, DWORD &exit_code
+)
+{
+    std::string description{error.what()};
+    if (process_)
+    {
+        if (WaitForSingleObject(process_->child.handle(), Exit_Wait)
+            == WAIT_OBJECT_0)
+        {
+            exit_code = process_->child.exit_code();
+            description += " (exit code " + std::to_string(exit_code) + ")";
+        }
+        description += '\n' + read_errors();
+    }
+    if (not description.ends_with('\n'))
+    {
+        description += '\n';
+    }
+    return description;
+}
+
+std::string Linter_Server::read_errors()
+{
+    std::string errors;
+    DWORD bytes_read = 0;
+    while (ReadFile(
+               process_->errors,
+               read_buffer_.data(),
+               Read_Size,
+               &bytes_read,
+               nullptr
+           )
+           != FALSE
+           and bytes_read != 0)
+    {
+        errors.append(read_buffer_.data(), bytes_read);
+    }
+    return errors;
+}
+
+void Linter_Server::send(
+    std::filesystem::path const &path, std::string const &text,
+    std::stop_token const &stop_token
+)
+{
+    // If we get stopped part way through writing the request, the server
+    // won't be able to make sense of anything else we send, so we have to
+    // kill it.
+    std::stop_callback const terminator{
+        stop_token,
+        [this]() noexcept { process_->child.terminate(ERROR_CANCELLED); }
+    };
+    process_->input.writer().write_file(
+        Server_Protocol::request(Encoding::convert(path.wstring()), text)
+    );
+}
+
+std::optional<Linter_Server::Reply> Linter_Server::receive(HANDLE stop_event)
+{
+    for (;;)
+    {
+        try
+        {
+            if (auto reply = Server_Protocol::take_reply(received_))
+            {
+                return Reply{
+                    .output = std::move(reply->output),
+                    .error_output = std::move(reply->error_output)
+                };
+            }
+        }
+        catch (Server_Protocol::Invalid_Reply const &error)
+        {
+            throw System_Error(ERROR_INVALID_DATA, error.what());
+        }
+        if (not read_more(stop_event))
+        {
+            return std::nullopt;
+        }
+    }
+}
+
+bool Linter_Server::read_more(HANDLE stop_event)
+{
+    HANDLE const pipe = process_->output.reader();
+    OVERLAPPED overlapped{};
+    overlapped.hEvent = process_->read_event.get();
+    if (ReadFile(pipe, read_buffer_.data(), Read_Size, nullptr, &overlapped)
+        == FALSE)
+    {
+        DWORD const err = GetLastError();
+        if (err != ERROR_IO_PENDING)
+        {
+            throw System_Error(err, "Linter server has stopped");
+        }
+        HANDLE const handles[] = {overlapped.hEvent, stop_event};
+        if (WaitForMultipleObjects(2, &handles[0], FALSE, INFINITE)
+            != WAIT_OBJECT_0)
+        {
+            // We've been stopped, or something went very wrong. Either way,
+            // the read can't be left outstanding.
+            CancelIoEx(pipe, &overlapped);
+        }
+    }
+
+    DWORD bytes_read;    // NOLINT(cppcoreguidelines-init-variables)
+    if (GetOverlappedResult(pipe, &overlapped, &bytes_read, TRUE) == FALSE)
+    {
+        DWORD const err = GetLastError();
+        if (err == ERROR_OPERATION_ABORTED)
+        {
+            return false;
+        }
+        throw System_Error(err, "Linter server has stopped");
+    }
+    received_.append(read_buffer_.data(), bytes_read);
+    return true;
+}
+
+}    // namespace Linter
@@ -0,0 +1,124 @@
+#pragma once
+
+#include <intsafe.h>
+#include <winnt.h>
+
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stop_token>
+#include <string>
+#include <vector>
+
+namespace Linter
+{
+
+/** A linter which is kept running, and is sent each file to lint.
+ *
+ * For tools with a slow startup (node, powershell), starting a new process
+ * for each lint is most of the time taken, so instead the process is started
+ * once and sent requests on its stdin, and sends the replies on its stdout.
+ *
+ * The requests and replies are described in Server_Protocol.h.
+ *
+ * The server handles one request at a time. If it dies, it is restarted.
+ *
+ * Anything the server writes to stderr is kept in a temporary file, and is
+ * added to the error output of the next reply.
+ */
+class Linter_Server
+{
+  public:
+    /** What the server sent back */
+    struct Reply
+    {
+        std::string output;
+        /** The error output in the reply, followed by anything written to
+         * stderr, and what happened to the server if it died
+         */
+        std::string error_output;
+        /** The exit code of the server if it died */
+        DWORD exit_code{0};
+    };
+
+    /** The server is started the first time it is used */
+    Linter_Server(
+        std::wstring program, std::wstring command_line,
+        std::wstring environment, std::filesystem::path directory
+    );
+
+    Linter_Server(Linter_Server const &) = delete;
+    Linter_Server(Linter_Server &&) = delete;
+    Linter_Server &operator=(Linter_Server const &) = delete;
+    Linter_Server &operator=(Linter_Server &&) = delete;
+
+    ~Linter_Server();
+
+    /** Send a file to the server and wait for the reply.
+     *
+     * If the server dies, it is restarted and the request is sent again,
+     * once. If that doesn't work either, the reply has no output, and the
+     * error output says what happened.
+     *
+     * If a stop is requested, this returns an empty optional straight away,
+     * even if it is waiting for another request to finish, and the reply is
+     * thrown away when it turns up.
+     */
+    std::optional<Reply> lint(
+        std::filesystem::path const &, std::string const &text,
+        std::stop_token const &
+    );
+
+  private:
+    struct Process;
+
+    void start();
+
+    void stop() noexcept;
+
+    /** Describe why the server failed, with its exit code if it died and
+     * what it wrote to stderr.
+     */
+    std::string describe_failure(std::exception const &, DWORD &exit_code);
+
+    /** Get what the server has written to stderr since last time */
+    std::string read_errors();
+
+    void send(
+        std::filesystem::path const &, std::string const &text,
+        std::stop_token const &
+    );
+
+    /** Read the next reply. Returns an empty optional if stopped */
+    std::optional<Reply> receive(HANDLE stop_event);
+
+    /** Read whatever is available. Returns false if stopped */
+    bool read_more(HANDLE stop_event);
+
+    std::wstring const program_;
+    std::wstring const command_line_;
+    std::wstring const environment_;
+    std::filesystem::path const directory_;
+
+    // Only one request can be sent at a time. The mutex only protects the
+    // flag, so that waiting for the server can be stopped.
+    std::mutex mutex_;
+    std::condition_variable_any idle_;
+    bool busy_{false};
+
+    std::unique_ptr<Process> process_;
+
+    // Output that has been read but not yet used
+    std::string received_;
+
+    std::vector<char> read_buffer_;
+
+    // Replies to requests which were cancelled
+    std::size_t unwanted_replies_{0};
+};
+
+}    // namespace Linter
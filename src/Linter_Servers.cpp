@@ -0,0 +1,116 @@
+#include "Linter_Servers.h"
+
+#include "Linter_Server.h"
+#include "Settings.h"
+
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace Linter
+{
+
+Linter_Servers::Linter_Servers() = default;
+
+Linter_Servers::~Linter_Servers() = default;
+
+std::shared_ptr<Linter_Server> Linter_Servers::get(
+    Settings::Command const &command, std::wstring const &program,
+    std::wstring const &command_line, std::wstring const &environment,
+    std::filesystem::path const &directory
+)
+{
+    // The variables in a persistent command don't depend on the file (the
+    // settings make sure of that), so the unexpanded command is enough to
+    // tell servers apart, and different files get the same server.
+    std::wstring const key = command.program.wstring() + L'\n' + command.args;
+    auto const now = Clock::now();
+
+    // Killing a server can take a little while, so it is done after the lock
+    // is released.
+    std::vector<std::shared_ptr<Linter_Server>> stopped;
+    std::scoped_lock const lock{mutex_};
+    auto &entry = servers_[key];
+    if (not entry.server)
+    {
+        entry.server = std::make_shared<Linter_Server>(
+            program, command_line, environment, directory
+        );
+    }
+    entry.last_used = now;
+    auto server = entry.server;
+    remove_idle(now, stopped);
+    return server;
+}
+
+void Linter_Servers::set_settings_generation(unsigned int generation)
+{
+    {
+        std::scoped_lock const lock{mutex_};
+        if (generation == settings_generation_)
+        {
+            return;
+        }
+        settings_generation_ = generation;
+    }
+    clear();
+}
+
+void Linter_Servers::clear()
+{
+    // Killing a server can take a little while, so it is done outside the
+    // lock.
+    std::map<std::wstring, Entry> old_servers;
+    {
+        std::scoped_lock const lock{mutex_};
+        old_servers.swap(servers_);
+    }
+}
+
+void Linter_Servers::remove_idle(
+    Clock::time_point now, std::vector<std::shared_ptr<Linter_Server>> &stopped
+)
+{
+    // A server is in use if anything other than us has a pointer to it.
+    auto const idle = [](Entry const &entry) noexcept
+    { return entry.server.use_count() == 1; };
+
+    std::erase_if(
+        servers_,
+        [&](auto const &item)
+        {
+            auto const &entry = item.second;
+            if (not idle(entry) or now - entry.last_used < Idle_Time)
+            {
+                return false;
+            }
+            stopped.push_back(entry.server);
+            return true;
+        }
+    );
+
+    if (servers_.size() > Max_Servers)
+    {
+        auto oldest = servers_.end();
+        for (auto item = servers_.begin(); item != servers_.end(); ++item)
+        {
+            if (idle(item->second)
+                and (oldest == servers_.end()
+                     or item->second.last_used < oldest->second.last_used))
+            {
+                oldest = item;
+            }
+        }
+        if (oldest != servers_.end())
+        {
+            stopped.push_back(oldest->second.server);
+            servers_.erase(oldest);
+        }
+    }
+}
+
+}    // namespace Linter
@@ -0,0 +1,94 @@
+#pragma once
+
+#include "Settings.h"
+
+#include <chrono>
+#include <cstddef>
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace Linter
+{
+
+class Linter_Server;
+
+/** The linter servers for the persistent commands.
+ *
+ * There is one server for each command in the settings, shared by all the
+ * files that use it. Servers that haven't been used for a while are stopped,
+ * as is the least recently used one if there are too many.
+ *
+ * This can be used from several threads at once.
+ */
+class Linter_Servers
+{
+  public:
+    Linter_Servers();
+
+    Linter_Servers(Linter_Servers const &) = delete;
+    Linter_Servers(Linter_Servers &&) = delete;
+    Linter_Servers &operator=(Linter_Servers const &) = delete;
+    Linter_Servers &operator=(Linter_Servers &&) = delete;
+
+    ~Linter_Servers();
+
+    /** Get the server for a command.
+     *
+     * If there isn't one, it is created with the supplied (expanded) program
+     * and command line, environment and working directory.
+     */
+    std::shared_ptr<Linter_Server> get(
+        Settings::Command const &command, std::wstring const &program,
+        std::wstring const &command_line, std::wstring const &environment,
+        std::filesystem::path const &directory
+    );
+
+    /** Stop the servers if the settings have been reread, as the commands
+     * may have changed.
+     */
+    void set_settings_generation(unsigned int generation);
+
+    /** Stop all the servers. Servers which are in use are stopped when they
+     * have finished.
+     */
+    void clear();
+
+  private:
+    using Clock = std::chrono::steady_clock;
+
+    /** Servers unused for this long are stopped */
+    static constexpr std::chrono::minutes Idle_Time{10};
+
+    /** The most servers kept running when they aren't in use */
+    static constexpr std::size_t Max_Servers = 8;
+
+    struct Entry
+    {
+        std::shared_ptr<Linter_Server> server;
+        Clock::time_point last_used;
+    };
+
+    /** Remove the servers which have been idle too long, or the least
+     * recently used idle one if there are too many.
+     *
+     * The servers are moved to stopped, so they can be killed after the lock
+     * is released.
+     */
+    void remove_idle(
+        Clock::time_point now,
+        std::vector<std::shared_ptr<Linter_Server>> &stopped
+    );
+
+    std::mutex mutex_;
+
+    // Servers by program and arguments, before variables are expanded
+    std::map<std::wstring, Entry> servers_;
+
+    unsigned int settings_generation_{0};
+};
+
+}    // namespace Linter
@@ -11,15 +11,23 @@
 #include <windef.h>
 #include <winuser.h>
 
+#include <algorithm>
 #if __cplusplus >= 202302L
 #include <coroutine>
 #endif
+#include <cstddef>
 #include <utility>    //For std::move
+#include <vector>
 
 namespace Linter
 {
 
-List_View::List_View(HWND handle) : handle_(handle)
+List_View::List_View(HWND handle) :
+    handle_(handle),
+    owner_data_(
+        handle_ != nullptr
+        and (::GetWindowLongPtr(handle_, GWL_STYLE) & LVS_OWNERDATA) != 0
+    )
 {
     if (handle_ == nullptr)
     {
@@ -219,6 +227,25 @@ void Linter::List_View::ensure_rows(int total_rows) const noexcept
     ListView_SetItemCount(handle_, total_rows);
 }
 
+void List_View::set_num_rows(int total_rows) const
+{
+    auto const old_rows = windows_static_cast<int, std::size_t>(rows_.size());
+    if (total_rows < old_rows)
+    {
+        // We don't know which rows to remove, so start again.
+        rows_.clear();
+    }
+    for (auto row = windows_static_cast<int, std::size_t>(rows_.size());
+         row < total_rows;
+         row += 1)
+    {
+        rows_.push_back(row);
+    }
+    ListView_SetItemCountEx(
+        handle_, total_rows, LVSICF_NOINVALIDATEALL | LVSICF_NOSCROLL
+    );
+}
+
 void List_View::set_item_text(
     Data_Row row, Data_Column col, std::wstring const &message
 ) const noexcept
@@ -231,6 +258,7 @@ void List_View::set_item_text(
 void List_View::clear() const noexcept
 {
     ListView_DeleteAllItems(handle_);
+    rows_.clear();
 }
 
 void List_View::select_all() const noexcept
@@ -281,6 +309,14 @@ List_View::Data_Row List_View::get_first_selected_index() const noexcept
 
 List_View::Data_Row List_View::get_index(int item) const noexcept
 {
+    if (owner_data_)
+    {
+        if (item < 0 or static_cast<std::size_t>(item) >= rows_.size())
+        {
+            return -1;
+        }
+        return rows_[static_cast<std::size_t>(item)];
+    }
     LVITEM const lvitem{.mask = LVIF_PARAM, .iItem = item};
     ListView_GetItem(handle_, &lvitem);
 #pragma warning(suppress : 26472)
@@ -354,9 +390,85 @@ void List_View::sort_by_column(
             * params.callback(param1, param2, params.column);
     };
 
+    if (owner_data_)
+    {
+        sort_rows(
+            [&details](std::vector<Data_Row> &rows)
+            {
+                if (details.direction == 0)
+                {
+                    std::sort(rows.begin(), rows.end());
+                    return;
+                }
+                std::stable_sort(
+                    rows.begin(),
+                    rows.end(),
+                    [&details](Data_Row row1, Data_Row row2)
+                    {
+                        return details.direction
+                                 * details.callback(row1, row2, details.column)
+                             < 0;
+                    }
+                );
+            }
+        );
+        return;
+    }
+
     ListView_SortItems(handle_, c_callback, &details);
 }
 
+void List_View::sort_rows(Row_Sorter const &sorter) const noexcept
+{
+    // The list view remembers which items are selected, not which rows, so
+    // we have to move the selection ourselves.
+    std::vector<Data_Row> selected;
+    int const focused =
+        get_index(ListView_GetNextItem(handle_, -1, LVNI_FOCUSED));
+    for (int item = ListView_GetNextItem(handle_, -1, LVNI_SELECTED);
+         item != -1;
+         item = ListView_GetNextItem(handle_, item, LVNI_SELECTED))
+    {
+        selected.push_back(get_index(item));
+    }
+
+#ifndef __cpp_lib_copyable_function
+#pragma warning(suppress : 26447)
+#endif
+    sorter(rows_);
+
+    if (not selected.empty() or focused != -1)
+    {
+        std::vector<int> items(rows_.size());
+        for (std::size_t item = 0; item < rows_.size(); item += 1)
+        {
+            items[static_cast<std::size_t>(rows_[item])] =
+                windows_static_cast<int, std::size_t>(item);
+        }
+        ListView_SetItemState(handle_, -1, 0, LVIS_SELECTED | LVIS_FOCUSED);
+        for (auto const row : selected)
+        {
+            ListView_SetItemState(
+                handle_,
+                items[static_cast<std::size_t>(row)],
+                LVIS_SELECTED,
+                LVIS_SELECTED
+            );
+        }
+        if (focused != -1)
+        {
+            ListView_SetItemState(
+                handle_,
+                items[static_cast<std::size_t>(focused)],
+                LVIS_FOCUSED,
+                LVIS_FOCUSED
+            );
+        }
+    }
+
+    ::InvalidateRect(handle_, nullptr, FALSE);
+}
+
 void List_View::get_screen_coordinates(POINT *point) const noexcept
 {
     ClientToScreen(handle_, point);
@@ -11,6 +11,7 @@
 #endif
 #include <optional>
 #include <string>
+#include <vector>
 
 namespace Linter
 {
@@ -19,6 +20,10 @@ namespace Linter
  *
  * This is only used for a report style list view, so the name is somewhat open
  * to question.
+ *
+ * If the control has the LVS_OWNERDATA style, the list view doesn't store any
+ * data. The owner must supply the text via LVN_GETDISPINFO, and the data row
+ * for each displayed item is held here, so sorting just reorders that.
  */
 class List_View
 {
@@ -145,9 +150,18 @@ class List_View
      */
     int add_column(Column_Data const &) const noexcept;
 
-    /** Add a row to the list view */
+    /** Add a row to the list view.
+     *
+     * Don't use this for an owner data list view. Use set_num_rows instead.
+     */
     void add_row(Data_Row, Row_Data const &) const;
 
+    /** Set the number of rows in an owner data list view.
+     *
+     * Any new rows are added to the end of the list, in data row order.
+     */
+    void set_num_rows(int total_rows) const;
+
     /** Ensure that there is space for at least total_rows rows in the list view
      */
     void ensure_rows(int total_rows) const noexcept;
@@ -225,6 +239,12 @@ class List_View
         Data_Column, Sort_Callback_Function, Sort_Direction
     ) const noexcept;
 
+    /** Puts the data rows of an owner data list view in display order */
+    using Row_Sorter = std::function<void(std::vector<Data_Row> &)>;
+
+    /** Reorder an owner data list view, keeping the same rows selected */
+    void sort_rows(Row_Sorter const &) const noexcept;
+
     /** Get the coordinates of a position in the list view */
     void get_screen_coordinates(POINT *point) const noexcept;
 
@@ -259,6 +279,12 @@ class List_View
   private:
     HWND handle_;
 
+    // Set if the list view has the LVS_OWNERDATA style
+    bool owner_data_;
+
+    // For an owner data list view, the data row for each displayed item.
+    mutable std::vector<Data_Row> rows_;
+
     /** Get the first selected item number, or -1 if none */
     int get_first_selected_item() const noexcept;
 };
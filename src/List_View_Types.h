@@ -16,4 +16,11 @@ enum class Sort_Direction    // NOLINT(performance-enum-size)
     Descending
 };
 
+// A column to sort by, and in which direction
+struct Sort_Column
+{
+    Data_Column column;
+    Sort_Direction direction;
+};
+
 }    // namespace Linter::List_View_Types
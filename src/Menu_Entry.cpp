@@ -15,6 +15,7 @@ std::wstring get_menu_string(Menu_Entry entry)
         {Menu_Entry::Show_Next_Lint,     L"Show next message"    },
         {Menu_Entry::Show_Previous_Lint, L"Show previous message"},
         {Menu_Entry::Toggle_Enabled,     L"Enabled"              },
+        {Menu_Entry::Export_Trace,       L"Export trace"         },
         {Menu_Entry::About,              L"About..."             },
         {Menu_Entry::Help,               L"Help"                 }
     };
@@ -29,6 +30,7 @@ Menu_Entry get_menu_entry_from_element(std::wstring const &element_name)
         {L"next",     Menu_Entry::Show_Next_Lint    },
         {L"previous", Menu_Entry::Show_Previous_Lint},
         {L"enabled",  Menu_Entry::Toggle_Enabled    },
+        {L"trace",    Menu_Entry::Export_Trace      },
         {L"about",    Menu_Entry::About             },
         {L"help",     Menu_Entry::Help              }
     };
@@ -14,6 +14,7 @@ enum class Menu_Entry : int
     Show_Previous_Lint,
     Separator_2,
     Toggle_Enabled,
+    Export_Trace,
     Separator_3,
     About,
     Help
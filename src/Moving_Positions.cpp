@@ -0,0 +1,131 @@
+#include "Moving_Positions.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <numeric>
+#include <utility>
+#include <vector>
+
+namespace Linter
+{
+
+void Moving_Positions::assign(std::vector<std::intptr_t> positions)
+{
+    original_ = std::move(positions);
+    moved_.assign(original_.size() + 1, 0);
+    // The extra entry marks the end, so there's always somewhere to point.
+    next_.resize(original_.size() + 1);
+    std::iota(next_.begin(), next_.end(), std::size_t{0});
+    edited_ = false;
+}
+
+void Moving_Positions::clear() noexcept
+{
+    original_.clear();
+    moved_.clear();
+    next_.clear();
+    edited_ = false;
+}
+
+void Moving_Positions::insert_text(std::intptr_t position, std::intptr_t length)
+{
+    if (original_.empty())
+    {
+        return;
+    }
+    edited_ = true;
+    move(lower_bound(position), length);
+}
+
+void Moving_Positions::delete_text(std::intptr_t position, std::intptr_t length)
+{
+    if (original_.empty())
+    {
+        return;
+    }
+    edited_ = true;
+    auto const first = lower_bound(position);
+    auto index = first;
+    auto const end = position + length;
+    while (index < original_.size() and this->position(index) < end)
+    {
+        // Each position is only removed once, so overall this is no worse
+        // than linear in the number of positions.
+        next_[index] = index + 1;
+        index = next(index + 1);
+    }
+    move(first, -length);
+}
+
+std::size_t Moving_Positions::next(std::size_t index) const
+{
+    if (next_.empty())
+    {
+        return 0;
+    }
+    // Find the end of the chain, and shorten the chain as we go.
+    while (next_[index] != index)
+    {
+        next_[index] = next_[next_[index]];
+        index = next_[index];
+    }
+    return index;
+}
+
+std::intptr_t Moving_Positions::position(std::size_t index) const
+{
+    std::intptr_t distance = 0;
+    for (auto node = index + 1; node != 0; node &= node - 1)
+    {
+        distance += moved_[node];
+    }
+    return original_[index] + distance;
+}
+
+std::size_t Moving_Positions::lower_bound(std::intptr_t position) const
+{
+    // This is a binary search which skips the removed positions.
+    std::size_t low = 0;
+    std::size_t high = original_.size();
+    std::size_t found = original_.size();
+    while (low < high)
+    {
+        auto const middle = low + (high - low) / 2;
+        auto const index = next(middle);
+        if (index < high and this->position(index) < position)
+        {
+            low = index + 1;
+        }
+        else
+        {
+            // Either this is a candidate, or everything from the middle
+            // onwards has been removed.
+            if (index < high)
+            {
+                found = index;
+            }
+            high = middle;
+        }
+    }
+    return found;
+}
+
+std::size_t Moving_Positions::bytes() const noexcept
+{
+    return sizeof(Moving_Positions)
+         + original_.capacity() * sizeof(std::intptr_t)
+         + moved_.capacity() * sizeof(std::intptr_t)
+         + next_.capacity() * sizeof(std::size_t);
+}
+
+void Moving_Positions::move(std::size_t index, std::intptr_t distance)
+{
+    // node & (~node + 1) is the lowest set bit, i.e. the size of the node
+    for (auto node = index + 1; node < moved_.size();
+         node += node & (~node + 1))
+    {
+        moved_[node] += distance;
+    }
+}
+
+}    // namespace Linter
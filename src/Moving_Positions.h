@@ -0,0 +1,88 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Linter
+{
+
+/** A sorted list of positions in the editor, which is kept up to date as text
+ * is inserted and deleted.
+ *
+ * Inserting or deleting text moves every position after it, so rather than
+ * updating them all, the amount each one has moved is kept in a Fenwick tree,
+ * which makes an edit take logarithmic time however many positions there are.
+ * Positions in text that is deleted are removed, and are skipped when looking
+ * through the list.
+ */
+class Moving_Positions
+{
+  public:
+    /** Replace the positions, which must be sorted */
+    void assign(std::vector<std::intptr_t> positions);
+
+    void clear() noexcept;
+
+    /** Number of positions, including the ones that have been removed */
+    std::size_t size() const noexcept
+    {
+        return original_.size();
+    }
+
+    /** Returns true if any text has been inserted or deleted since the
+     * positions were assigned
+     */
+    bool edited() const noexcept
+    {
+        return edited_;
+    }
+
+    /** Move everything at or after the position along */
+    void insert_text(std::intptr_t position, std::intptr_t length);
+
+    /** Remove everything in the deleted text, and move everything after it
+     * back
+     */
+    void delete_text(std::intptr_t position, std::intptr_t length);
+
+    /** Get the index of the first position that hasn't been removed, starting
+     * from the supplied index. Returns size() if there aren't any more.
+     */
+    std::size_t next(std::size_t index) const;
+
+    /** Returns true if the position has been removed */
+    bool removed(std::size_t index) const
+    {
+        return next(index) != index;
+    }
+
+    /** Get the current value of a position */
+    std::intptr_t position(std::size_t index) const;
+
+    /** Get the index of the first position that hasn't been removed and is at
+     * or after the supplied position, or size() if there isn't one
+     */
+    std::size_t lower_bound(std::intptr_t position) const;
+
+    /** Approximate number of bytes used */
+    std::size_t bytes() const noexcept;
+
+  private:
+    /** Move all the positions from the index onwards */
+    void move(std::size_t index, std::intptr_t distance);
+
+    // The positions when they were assigned
+    std::vector<std::intptr_t> original_;
+
+    // Fenwick tree of the distance moved, indexed from 1
+    std::vector<std::intptr_t> moved_;
+
+    // Points to the next position, skipping removed ones. It points to itself
+    // if it hasn't been removed.
+    mutable std::vector<std::size_t> next_;
+
+    bool edited_{false};
+};
+
+}    // namespace Linter
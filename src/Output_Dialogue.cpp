@@ -1,11 +1,16 @@
 #include "Output_Dialogue.h"
 
 #include "Clipboard.h"
+#include "Command_Statistics.h"
 #include "Encoding.h"
 #include "Error_Info.h"
+#include "Error_Sort_Keys.h"
+#include "Error_Store.h"
 #include "Linter.h"
+#include "Relint_Delay.h"
 #include "Report_View.h"
 #include "Settings.h"
+#include "Variable_Cache.h"
 
 #include "Plugin/Casts.h"
 #include "Plugin/Plugin.h"
@@ -18,13 +23,23 @@
 
 #include <CommCtrl.h>
 #include <intsafe.h>
-#include <winuser.h>    // For tagNMHDR, AppendMenu
+#include <processthreadsapi.h>    // For GetCurrentThreadId
+#include <winuser.h>              // For tagNMHDR, AppendMenu
 
+#include <algorithm>
+#include <array>
+#include <compare>
+#include <cstddef>
 #include <cstdio>    // For snprintf
+#include <cwchar>    // For swprintf
+#include <exception>
 #include <filesystem>
+#include <fstream>
+#include <functional>
 #if __cplusplus >= 202302L
 #include <generator>
 #endif
+#include <mutex>
 #include <optional>    // For optional, nullopt
 #include <sstream>
 #include <string>
@@ -37,6 +52,9 @@ namespace Linter
 namespace
 {
 
+/** Posted to the dialogue when there are updates from another thread */
+constexpr UINT Message_Apply_Updates = WM_APP + 1;
+
 /** Columns in the error list */
 enum List_Column
 {
@@ -46,6 +64,84 @@ enum List_Column
     Column_Message
 };
 
+/** Columns in the statistics list */
+enum Statistics_Column
+{
+    Column_Command,
+    Column_Runs,
+    Column_Median,
+    Column_95th_Percentile,
+    Column_Max,
+    Column_Stdout,
+    Column_Stderr,
+    Column_Errors,
+    Column_Failures,
+    Column_Cache_Hits,
+    Column_Cancelled,
+    Num_Statistics_Columns
+};
+
+/** Get the value of a numeric column in the statistics list */
+double statistic(
+    Command_Statistics::Summary const &summary, int column
+) noexcept
+{
+    switch (column)
+    {
+        case Column_Runs:
+            return static_cast<double>(summary.runs);
+
+        case Column_Median:
+            return static_cast<double>(summary.median.count());
+
+        case Column_95th_Percentile:
+            return static_cast<double>(summary.percentile_95.count());
+
+        case Column_Max:
+            return static_cast<double>(summary.max.count());
+
+        case Column_Stdout:
+            return static_cast<double>(summary.stdout_bytes);
+
+        case Column_Stderr:
+            return static_cast<double>(summary.stderr_bytes);
+
+        case Column_Errors:
+            return static_cast<double>(summary.errors);
+
+        case Column_Failures:
+            return static_cast<double>(summary.failures);
+
+        case Column_Cache_Hits:
+            return summary.cache_hit_rate();
+
+        case Column_Cancelled:
+            return static_cast<double>(summary.cancelled);
+
+        default:
+            return 0;
+    }
+}
+
+/** Format a numeric column in the statistics list */
+void format_statistic(
+    Command_Statistics::Summary const &summary, int column, wchar_t *text,
+    std::size_t size
+) noexcept
+{
+    if (column == Column_Cache_Hits)
+    {
+        std::ignore = std::swprintf(
+            text, size, L"%.0f%%", summary.cache_hit_rate() * 100
+        );
+    }
+    else
+    {
+        std::ignore =
+            std::swprintf(text, size, L"%.0f", statistic(summary, column));
+    }
+}
+
 /** Context menu items.
  *
  * Ensure they don't clash with anything in the resource file.
@@ -54,7 +150,8 @@ enum Context_Menu_Entry
 {
     Context_Copy_Lints = 1500,
     Context_Show_Source_Line,
-    Context_Select_All
+    Context_Select_All,
+    Context_Export_Statistics
 };
 
 }    // namespace
@@ -66,20 +163,11 @@ Output_Dialogue::Output_Dialogue(Menu_Entry menu_entry, Linter const &plugin) :
         {
          {L"Lint Errors", IDC_LIST_LINTS, Lint_Error, *this},
          {L"System Errors", IDC_LIST_OUTPUT, System_Error, *this},
+         {L"Statistics", IDC_LIST_STATISTICS, Statistics, *this},
          }
 },
     current_tab_(&tab_definitions_.at(0)),
-    settings_(plugin.settings()),
-    sort_callback_(
-#ifndef __cpp_lib_copyable_function
-#pragma warning(suppress : 26447)
-#endif
-        [this](
-            LPARAM row1_index, LPARAM row2_index,
-            Report_View::Data_Column column
-        ) noexcept
-        { return this->sort_call_function(row1_index, row2_index, column); }
-    ),
+    linter_(plugin),
     initial_font_{windows_cast_to<HFONT, LRESULT>(
         SendMessage(GetDlgItem(IDC_LIST_OUTPUT), WM_GETFONT, 0, 0)
     )}
@@ -114,11 +202,23 @@ void Output_Dialogue::display() noexcept
 }
 
 void Output_Dialogue::clear_lint_info()
+{
+    post_update([this]() { clear_tabs(); });
+}
+
+void Output_Dialogue::clear_tabs()
 {
     for (auto &tab : tab_definitions_)
     {
+        // The statistics aren't for a particular lint.
+        if (tab.tab == Tab::Statistics)
+        {
+            continue;
+        }
         tab.report_view.clear();
         tab.errors.clear();
+        tab.sort_keys.clear();
+        tab.sorted = true;
     }
 
     update_displayed_counts();
@@ -126,13 +226,36 @@ void Output_Dialogue::clear_lint_info()
 
 void Output_Dialogue::add_system_error(Error_Info const &err)
 {
-    std::vector<Error_Info> const errs = {err};
-    add_errors(Tab::System_Error, errs);
+    Error_Store errs;
+    errs.add(err);
+    post_update([this, errs]() { add_errors(Tab::System_Error, errs); });
+}
+
+void Output_Dialogue::add_lint_errors(Error_Store const &errs)
+{
+    post_update([this, errs]() { add_errors(Tab::Lint_Error, errs); });
+}
+
+Error_Store const &Output_Dialogue::system_errors()
+{
+    // Include anything a lint has sent that hasn't been shown yet.
+    apply_updates();
+    return tab_definitions_[Tab::System_Error].errors;
 }
 
-void Output_Dialogue::add_lint_errors(std::vector<Error_Info> const &errs)
+void Output_Dialogue::show_errors(
+    Error_Store const &lints, Error_Store const &system
+)
 {
-    add_errors(Tab::Lint_Error, errs);
+    post_update(
+        [this, lints, system]()
+        {
+            clear_tabs();
+            add_errors(Tab::Lint_Error, lints);
+            add_errors(Tab::System_Error, system);
+            sort_tab(*current_tab_);
+        }
+    );
 }
 
 void Output_Dialogue::select_next_lint()
@@ -146,19 +269,34 @@ void Output_Dialogue::select_previous_lint()
 }
 
 /** Disable redrawing */
-void Output_Dialogue::disable_redraw() const noexcept
+void Output_Dialogue::disable_redraw()
 {
-    current_report_view_->disable_redraw();
+    post_update([this]() { current_report_view_->disable_redraw(); });
 }
 
 /** Enable redrawing and set the appropriate font */
-void Output_Dialogue::enable_redraw() const noexcept
+void Output_Dialogue::enable_redraw()
 {
-    HFONT const new_font = settings_->font();    // NOLINT(misc-misplaced-const)
-    current_report_view_->set_font(
-        new_font == nullptr ? initial_font_ : new_font
+    post_update(
+        [this]()
+        {
+            if (current_tab_->tab == Tab::Statistics)
+            {
+                update_statistics();
+            }
+            // Errors arrive from each linter in turn, so sort them once they
+            // have all arrived rather than every time some are added.
+            sort_tab(*current_tab_);
+            // Keep hold of the settings, as they own the font.
+            auto const settings = linter_.settings();
+            // NOLINTNEXTLINE(misc-misplaced-const)
+            HFONT const new_font = settings->font();
+            current_report_view_->set_font(
+                new_font == nullptr ? initial_font_ : new_font
+            );
+            current_report_view_->enable_redraw();
+        }
     );
-    current_report_view_->enable_redraw();
 }
 
 Output_Dialogue::Message_Return Output_Dialogue::on_dialogue_message(
@@ -182,6 +320,10 @@ Output_Dialogue::Message_Return Output_Dialogue::on_dialogue_message(
             window_pos_changed();
             return std::nullopt;
 
+        case Message_Apply_Updates:
+            apply_updates();
+            return TRUE;
+
         default:
             break;
     }
@@ -224,6 +366,10 @@ Output_Dialogue::Message_Return Output_Dialogue::process_dlg_command(
             current_report_view_->select_all();
             return TRUE;
 
+        case Context_Export_Statistics:
+            export_statistics();
+            return TRUE;
+
         default:
             break;
     }
@@ -242,12 +388,20 @@ Output_Dialogue::Message_Return Output_Dialogue::process_dlg_context_menu(
 
     if (numSelected >= 1)
     {
-        if (current_report_view_->has_selected_line())
+        if (current_tab_->tab != Tab::Statistics
+            and current_report_view_->has_selected_line())
         {
             AppendMenu(menu, MF_ENABLED, Context_Show_Source_Line, L"Show");
         }
     }
 
+    if (current_tab_->tab == Tab::Statistics)
+    {
+        AppendMenu(
+            menu, MF_ENABLED, Context_Export_Statistics, L"Export CSV"
+        );
+    }
+
     if (GetMenuItemCount(menu) > 0)
     {
         AppendMenu(menu, MF_SEPARATOR, 0, nullptr);
@@ -309,15 +463,16 @@ Output_Dialogue::Message_Return Output_Dialogue::process_dlg_notify(
             {
                 auto const *const column_click =
                     windows_cast_to<NMLISTVIEW const *, LPARAM>(lParam);
-                // ENHANCMENT Should check if we've clicked shift key here and
-                // add this column to the sort order rather than replacing it.
-                // Using the shift key multiple times should cycle between
-                // ascending sort, descending sort, and removal from the sort.
-                //
-                // Arguably multi-column sorting is only applicable to report
-                // views, at least at this sort of level.
+                // Shift-click adds the column to the sort order rather than
+                // replacing it.
+                bool const add_column =
+                    (::GetKeyState(VK_SHIFT) & 0x8000U) != 0;
+                auto const &tab = *current_tab_;
                 current_report_view_->sort_by_column(
-                    column_click->iSubItem, sort_callback_
+                    column_click->iSubItem,
+                    add_column,
+                    [this, &tab](auto &rows, auto const &columns)
+                    { sort_rows(tab, rows, columns); }
                 );
                 return TRUE;
             }
@@ -339,6 +494,17 @@ Output_Dialogue::Message_Return Output_Dialogue::process_dlg_notify(
             }
             break;
 
+        case LVN_GETDISPINFO:
+            for (auto const &tab : tab_definitions_)
+            {
+                if (notify_header->idFrom == tab.list_view_id)
+                {
+                    get_display_info(tab, lParam);
+                    return TRUE;
+                }
+            }
+            break;
+
         case NM_CUSTOMDRAW:
             if (notify_header->idFrom == current_tab_->list_view_id)
             {
@@ -394,9 +560,12 @@ Output_Dialogue::Message_Return Output_Dialogue::process_custom_draw(
                 }
 
                 // Now we colour the text according to the severity level.
-                auto const &lint_error = current_tab_->errors[row];
                 custom_draw->clrText =
-                    settings_->get_message_colour(lint_error.severity_);
+                    linter_.settings()->get_message_colour(
+                        current_tab_->errors.severity(
+                            static_cast<std::size_t>(row)
+                        )
+                    );
                 // Tell Windows to paint the control itself.
                 return CDRF_DODEFAULT;
             }
@@ -420,6 +589,11 @@ void Output_Dialogue::selected_tab_changed() noexcept
         }
     }
     current_report_view_->show();
+    if (current_tab_->tab == Tab::Statistics)
+    {
+        update_statistics();
+    }
+    sort_tab(*current_tab_);
 }
 
 void Output_Dialogue::window_pos_changed() noexcept
@@ -448,7 +622,7 @@ void Output_Dialogue::update_displayed_counts()
     {
         std::wstring strTabName;
         int const rows = tab.report_view.get_num_rows();
-        if (rows > 0)
+        if (rows > 0 and tab.tab != Tab::Statistics)
         {
             std::wstringstream stream;
             stream << tab.tab_name << L" (" << rows << L")";
@@ -467,43 +641,336 @@ void Output_Dialogue::update_displayed_counts()
     }
 }
 
-void Output_Dialogue::add_errors(Tab tab, std::vector<Error_Info> const &lints)
+void Output_Dialogue::post_update(std::function<void()> update)
+{
+    bool first = false;
+    {
+        std::scoped_lock const lock{updates_mutex_};
+        first = updates_.empty();
+        updates_.push_back(std::move(update));
+    }
+    if (GetWindowThreadProcessId(window(), nullptr) == GetCurrentThreadId())
+    {
+        apply_updates();
+    }
+    else if (first)
+    {
+        // One message is enough to apply everything that has been posted
+        // before it is processed.
+        PostMessage(window(), Message_Apply_Updates, 0, 0);
+    }
+}
+
+void Output_Dialogue::apply_updates()
+{
+    std::vector<std::function<void()>> updates;
+    {
+        std::scoped_lock const lock{updates_mutex_};
+        updates.swap(updates_);
+    }
+    for (auto const &update : updates)
+    {
+        update();
+    }
+}
+
+void Output_Dialogue::add_errors(Tab tab, Error_Store const &lints)
 {
     auto &tab_def = tab_definitions_[tab];
     auto const &report_view = tab_def.report_view;
-    auto row = windows_static_cast<int, size_t>(tab_def.errors.size());
 
-    report_view.ensure_rows(
-        row + windows_static_cast<int, size_t>(lints.size())
+    // The list view doesn't hold any data, it asks for it when it needs to
+    // display it.
+    auto const first = tab_def.errors.size();
+    tab_def.errors.append(lints);
+    for (auto row = first; row < tab_def.errors.size(); row += 1)
+    {
+        tab_def.sort_keys.add(tab_def.errors, row);
+    }
+    tab_def.sorted = false;
+    report_view.set_num_rows(
+        windows_static_cast<int, size_t>(tab_def.errors.size())
     );
 
-    for (auto const &lint : lints)
+    update_displayed_counts();
+
+    if (&tab_def == current_tab_)
     {
-        tab_def.errors.push_back(lint);
+        report_view.autosize_columns();
+    }
+}
 
-        report_view.add_row(row, Report_View::Row_Data{.user_data = row});
+void Output_Dialogue::sort_tab(TabDefinition &tab) noexcept
+{
+    if (tab.sorted)
+    {
+        return;
+    }
+    tab.sorted = true;
+    tab.report_view.sort_by_column(
+        [this, &tab](auto &rows, auto const &columns)
+        { sort_rows(tab, rows, columns); }
+    );
+}
 
-        report_view.set_item_text(row, Column_Message, lint.message_);
+void Output_Dialogue::sort_rows(
+    TabDefinition const &tab, std::vector<Report_View::Data_Row> &rows,
+    std::vector<Report_View::Sort_Column> const &columns
+) const
+{
+    if (columns.empty())
+    {
+        std::sort(rows.begin(), rows.end());
+        return;
+    }
 
-        report_view.set_item_text(row, Column_Tool, lint.tool_);
+    if (tab.tab == Tab::Statistics)
+    {
+        sort_statistics(rows, columns);
+        return;
+    }
 
-        report_view.set_item_text(
-            row, Column_Line, std::to_wstring(lint.line_)
+    std::vector<Error_Sort_Keys::Sort_Field> fields;
+    fields.reserve(columns.size());
+    for (auto const &column : columns)
+    {
+        Error_Sort_Keys::Field field{Error_Sort_Keys::Field::Line};
+        switch (column.column)
+        {
+            case Column_Position:
+                field = Error_Sort_Keys::Field::Column;
+                break;
+
+            case Column_Tool:
+                field = Error_Sort_Keys::Field::Tool;
+                break;
+
+            case Column_Message:
+                field = Error_Sort_Keys::Field::Message;
+                break;
+
+            case Column_Line:
+            default:
+                break;
+        }
+        fields.push_back(
+            {.field = field,
+             .descending =
+                 column.direction == Report_View::Sort_Direction::Descending}
         );
+    }
+    tab.sort_keys.sort(rows, fields, tab.errors);
+}
 
-        report_view.set_item_text(
-            row, Column_Position, std::to_wstring(lint.column_)
+void Output_Dialogue::sort_statistics(
+    std::vector<Report_View::Data_Row> &rows,
+    std::vector<Report_View::Sort_Column> const &columns
+) const
+{
+    std::stable_sort(
+        rows.begin(),
+        rows.end(),
+        [this, &columns](
+            Report_View::Data_Row lhs, Report_View::Data_Row rhs
+        ) noexcept
+        {
+            // The notes stay at the top, in the order they were added.
+            auto const notes = statistics_notes_.size();
+            auto const left_row = static_cast<std::size_t>(lhs);
+            auto const right_row = static_cast<std::size_t>(rhs);
+            if (left_row < notes or right_row < notes)
+            {
+                return left_row < right_row;
+            }
+            auto const &left = statistics_[left_row - notes];
+            auto const &right = statistics_[right_row - notes];
+            for (auto const &column : columns)
+            {
+                std::partial_ordering order = std::partial_ordering::equivalent;
+                if (column.column == Column_Command)
+                {
+                    order = left.command <=> right.command;
+                }
+                else
+                {
+                    order = statistic(left, column.column)
+                        <=> statistic(right, column.column);
+                }
+                if (order != 0)
+                {
+                    return column.direction
+                                == Report_View::Sort_Direction::Descending
+                             ? order > 0
+                             : order < 0;
+                }
+            }
+            return false;
+        }
+    );
+}
+
+void Output_Dialogue::update_statistics()
+{
+    auto &tab = tab_definitions_[Tab::Statistics];
+
+    statistics_notes_.clear();
+    auto const variables = linter_.settings()->variable_cache().statistics();
+    statistics_notes_.push_back(
+        L"Variable values reused: " + std::to_wstring(variables.hits)
+        + L" hits, " + std::to_wstring(variables.misses) + L" misses"
+    );
+    auto const results = linter_.result_cache_statistics();
+    statistics_notes_.push_back(
+        L"Results reused from cache: " + std::to_wstring(results.hits)
+        + L" hits, " + std::to_wstring(results.misses) + L" misses, "
+        + std::to_wstring(results.entries) + L" entries using "
+        + std::to_wstring((results.bytes + 1023) / 1024) + L" KB"
+    );
+    auto const &relint_delay = linter_.relint_delay();
+    std::wstring typing_gap{L"not known"};
+    if (auto const gap = relint_delay.typing_gap())
+    {
+        typing_gap = std::to_wstring(gap->count()) + L" ms";
+    }
+    statistics_notes_.push_back(
+        L"Relint delay: " + std::to_wstring(relint_delay.last_delay().count())
+        + L" ms (typing gap " + typing_gap + L")"
+    );
+
+    statistics_ = linter_.command_statistics().summaries();
+    // The values may have changed even if the number of rows hasn't, so
+    // start again.
+    tab.report_view.clear();
+    tab.report_view.set_num_rows(windows_static_cast<int, std::size_t>(
+        statistics_notes_.size() + statistics_.size()
+    ));
+    tab.sorted = false;
+    tab.report_view.autosize_columns();
+}
+
+void Output_Dialogue::export_statistics()
+{
+    try
+    {
+        // Write it somewhere it can be opened, and let the user save it
+        // wherever they want.
+        auto const path = std::filesystem::temp_directory_path().append(
+            std::wstring{Linter::get_plugin_name()} + L" statistics.csv"
+        );
+        {
+            std::ofstream file{path, std::ios::binary};
+            file << linter_.command_statistics().to_csv();
+            if (not file)
+            {
+                add_system_error(
+                    {.message_ = L"Can't write " + path.wstring(),
+                     .mode_ = Error_Info::Exception}
+                );
+                return;
+            }
+        }
+        plugin()->send_to_notepad(NPPM_DOOPEN, 0, path.c_str());
+    }
+    catch (std::exception const &e)
+    {
+        add_system_error(
+            {.message_ = Encoding::convert(e.what()),
+             .mode_ = Error_Info::Exception}
         );
+    }
+}
 
-        row += 1;
+void Output_Dialogue::get_display_info(
+    TabDefinition const &tab, LPARAM lParam
+) const noexcept
+{
+    auto *const display_info = windows_cast_to<NMLVDISPINFO *, LPARAM>(lParam);
+    LVITEM &item = display_info->item;
+    if ((item.mask & LVIF_TEXT) == 0)
+    {
+        return;
     }
 
-    update_displayed_counts();
+    auto const row = tab.report_view.get_index(item.iItem);
+    if (tab.tab == Tab::Statistics)
+    {
+        auto const notes = statistics_notes_.size();
+        if (row < 0
+            or static_cast<std::size_t>(row) >= notes + statistics_.size())
+        {
+            return;
+        }
+        if (static_cast<std::size_t>(row) < notes)
+        {
+            if (item.iSubItem == Column_Command)
+            {
+                item.pszText = windows_const_cast<wchar_t *>(
+                    statistics_notes_[static_cast<std::size_t>(row)].c_str()
+                );
+            }
+            return;
+        }
+        auto const &summary =
+            statistics_[static_cast<std::size_t>(row) - notes];
+        if (item.iSubItem == Column_Command)
+        {
+            item.pszText =
+                windows_const_cast<wchar_t *>(summary.command.c_str());
+        }
+        else
+        {
+            format_statistic(
+                summary,
+                item.iSubItem,
+                item.pszText,
+                static_cast<std::size_t>(item.cchTextMax)
+            );
+        }
+        return;
+    }
 
-    if (&tab_def == current_tab_)
+    if (row < 0 or static_cast<std::size_t>(row) >= tab.errors.size())
     {
-        report_view.autosize_columns();
-        report_view.sort_by_column(sort_callback_);
+        return;
+    }
+
+    auto const &errors = tab.errors;
+    auto const lint = static_cast<std::size_t>(row);
+    switch (item.iSubItem)
+    {
+        case Column_Line:
+            std::ignore = std::swprintf(
+                item.pszText,
+                static_cast<std::size_t>(item.cchTextMax),
+                L"%d",
+                errors.line(lint)
+            );
+            break;
+
+        case Column_Position:
+            std::ignore = std::swprintf(
+                item.pszText,
+                static_cast<std::size_t>(item.cchTextMax),
+                L"%d",
+                errors.column(lint)
+            );
+            break;
+
+        // For strings, we can point the list view at our copy, which
+        // avoids truncating long messages.
+        case Column_Tool:
+            item.pszText =
+                windows_const_cast<wchar_t *>(errors.tool(lint).c_str());
+            break;
+
+        case Column_Message:
+            // The message is followed by a NUL in the store.
+            item.pszText =
+                windows_const_cast<wchar_t *>(errors.message(lint).data());
+            break;
+
+        default:
+            break;
     }
 }
 
@@ -540,19 +1007,28 @@ void Output_Dialogue::append_text_with_style(
 
 void Output_Dialogue::show_selected_lint(Report_View::Data_Row selected_item)
 {
-    Error_Info const &lint_error = current_tab_->errors[selected_item];
+    if (current_tab_->tab == Tab::Statistics)
+    {
+        // There's nothing to show.
+        return;
+    }
+
+    auto const &errors = current_tab_->errors;
+    auto const lint = static_cast<std::size_t>(selected_item);
 
-    int line = std::max(lint_error.line_ - 1, 0);
-    int const column = std::max(lint_error.column_ - 1, 0);
+    int line = std::max(errors.line(lint) - 1, 0);
+    int const column = std::max(errors.column(lint) - 1, 0);
 
     /* We only need to do this if we need to pop up linter.xml. The
      * following isn't ideal */
     if (current_tab_->tab == Tab::System_Error)
     {
-        if (lint_error.mode_ == Error_Info::Bad_Linter_XML)
+        if (errors.mode(lint) == Error_Info::Bad_Linter_XML)
         {
             plugin()->send_to_notepad(
-                NPPM_DOOPEN, 0, settings_->settings_file().c_str()
+                NPPM_DOOPEN,
+                0,
+                linter_.settings()->settings_file().c_str()
             );
         }
         else
@@ -566,12 +1042,12 @@ void Output_Dialogue::show_selected_lint(Report_View::Data_Row selected_item)
             // This should not throw if the command line is valid UTF16.
             // Which it is.
             append_text(
-                "\n\n" + Encoding::convert(lint_error.command_) + "\n\n"
+                "\n\n" + Encoding::convert(errors.command(lint)) + "\n\n"
             );
             append_text_with_style("Return code: ", style);
             char buff[20];    // NOLINT(cppcoreguidelines-init-variables)
             std::ignore = std::snprintf(
-                &buff[0], sizeof(buff), "%lu", lint_error.result_
+                &buff[0], sizeof(buff), "%lu", errors.result(lint)
             );
             append_text(&buff[0]);
             append_text("\n\n");
@@ -581,10 +1057,12 @@ void Output_Dialogue::show_selected_lint(Report_View::Data_Row selected_item)
                 SCI_LINEFROMPOSITION,
                 plugin()->send_to_editor(SCI_GETTEXTLENGTH)
             ));
-            append_text(lint_error.stdout_ + "\n\n");
+            append_text(errors.output(lint));
+            append_text("\n\n");
 
             append_text_with_style("Error:", style);
-            append_text("\n\n" + lint_error.stderr_);
+            append_text("\n\n");
+            append_text(errors.error_output(lint));
         }
     }
 
@@ -629,7 +1107,8 @@ void Output_Dialogue::copy_to_clipboard()
     bool first = true;
     for (auto row : current_report_view_->selected_items())
     {
-        auto const &lint_error = current_tab_->errors[row];
+        auto const &errors = current_tab_->errors;
+        auto const lint = static_cast<std::size_t>(row);
 
         if (first)
         {
@@ -640,9 +1119,30 @@ void Output_Dialogue::copy_to_clipboard()
             stream << L"\r\n";
         }
 
-        stream << L"Line " << lint_error.line_ << L", column "
-               << lint_error.column_ << L": " << L"\r\n\t"
-               << lint_error.message_ << L"\r\n";
+        if (current_tab_->tab == Tab::Statistics)
+        {
+            if (lint < statistics_notes_.size())
+            {
+                stream << statistics_notes_[lint] << L"\r\n";
+                continue;
+            }
+            // Tab separated, so it can be pasted into a spreadsheet.
+            auto const &summary = statistics_[lint - statistics_notes_.size()];
+            stream << summary.command;
+            for (int column = Column_Runs; column < Num_Statistics_Columns;
+                 column += 1)
+            {
+                std::array<wchar_t, 32> text{};
+                format_statistic(summary, column, text.data(), text.size());
+                stream << L'\t' << text.data();
+            }
+            stream << L"\r\n";
+            continue;
+        }
+
+        stream << L"Line " << errors.line(lint) << L", column "
+               << errors.column(lint) << L": " << L"\r\n\t"
+               << errors.message(lint) << L"\r\n";
     }
 
     std::wstring const str = stream.str();
@@ -657,54 +1157,6 @@ void Output_Dialogue::copy_to_clipboard()
     clipboard.copy(str);
 }
 
-#ifndef __cpp_lib_copyable_function
-#pragma warning(suppress : 26440)
-#endif
-int Output_Dialogue::sort_call_function(
-    // NOLINTNEXTLINE(bugprone-easily-swappable-parameters)
-    LPARAM row1_index, LPARAM row2_index, Report_View::Data_Column column
-)
-#ifdef __cpp_lib_copyable_function
-    const noexcept
-#endif
-{
-    auto const &errs = current_tab_->errors;
-    auto const &row1 = errs[row1_index];
-    auto const &row2 = errs[row2_index];
-    int res = 0;
-
-    switch (column)
-    {
-        case Column_Position:
-            res = row1.column_ - row2.column_;
-            break;
-
-        case Column_Tool:
-            res = row1.tool_.compare(row2.tool_);
-            break;
-
-        case Column_Message:
-            res = row1.message_.compare(row2.message_);
-            break;
-
-        case Column_Line:
-        default:
-            // Nothing to do here.
-            break;
-    }
-
-    // If we still don't know, sort by column and line.
-    if (res == 0)
-    {
-        res = row1.line_ - row2.line_;
-        if (res == 0)
-        {
-            res = row1.column_ - row2.column_;
-        }
-    }
-    return res;
-}
-
 Output_Dialogue::TabDefinition::TabDefinition(
     wchar_t const *name, UINT view_id, Tab tab_id, Output_Dialogue const &parent
 ) :
@@ -715,6 +1167,42 @@ Output_Dialogue::TabDefinition::TabDefinition(
 {
     using Column_Data = Report_View::Column_Data;
 
+    if (tab == Tab::Statistics)
+    {
+        report_view.add_column(
+            Column_Command,
+            {.justification = Column_Data::Justification::Left,
+             .width = 200,
+             .text = L"Command"}
+        );
+        struct Numeric_Column
+        {
+            Statistics_Column column;
+            wchar_t const *text;
+        };
+        for (auto const &[column, text] : {
+                 Numeric_Column{Column_Runs, L"Runs"},
+                 Numeric_Column{Column_Median, L"Median (ms)"},
+                 Numeric_Column{Column_95th_Percentile, L"95% (ms)"},
+                 Numeric_Column{Column_Max, L"Max (ms)"},
+                 Numeric_Column{Column_Stdout, L"Stdout bytes"},
+                 Numeric_Column{Column_Stderr, L"Stderr bytes"},
+                 Numeric_Column{Column_Errors, L"Errors"},
+                 Numeric_Column{Column_Failures, L"Failures"},
+                 Numeric_Column{Column_Cache_Hits, L"Cache hits"},
+                 Numeric_Column{Column_Cancelled, L"Cancelled"}
+        })
+        {
+            report_view.add_column(
+                column,
+                {.justification = Column_Data::Justification::Right,
+                 .width = 70,
+                 .text = text}
+            );
+        }
+        return;
+    }
+
     // Note: The first column is implicitly left justified so the 'right' here
     // is a little optimistic.
     report_view.add_column(
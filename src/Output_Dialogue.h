@@ -1,6 +1,9 @@
 #pragma once
 
+#include "Command_Statistics.h"
 #include "Error_Info.h"
+#include "Error_Sort_Keys.h"
+#include "Error_Store.h"
 #include "Report_View.h"
 
 #include "Plugin/Docking_Dialogue_Interface.h"
@@ -10,6 +13,9 @@
 #include <windef.h>
 
 #include <array>
+#include <functional>
+#include <mutex>
+#include <string>
 #include <string_view>
 #include <vector>
 
@@ -21,7 +27,6 @@ namespace Linter
 {
 
 class Linter;
-class Settings;
 
 enum class Menu_Entry : int;
 
@@ -30,6 +35,11 @@ enum class Menu_Entry : int;
  * The dialogue consists of:
  * 1 tab - status (number of linters found for the current file, fatal errors,
  * etc) 1 tab for each linter
+ *
+ * The list views ask for what to display when they need it, so the errors
+ * they show must only be changed on the notepad++ thread. The functions which
+ * change them can be called from any thread: the change is posted to the
+ * dialogue, and made when notepad++ gets round to it.
  */
 class Output_Dialogue : protected Docking_Dialogue_Interface
 {
@@ -54,7 +64,16 @@ class Output_Dialogue : protected Docking_Dialogue_Interface
     void add_system_error(Error_Info const &);
 
     /** Add a list of lint errors to the lint error list */
-    void add_lint_errors(std::vector<Error_Info> const &);
+    void add_lint_errors(Error_Store const &);
+
+    /** Get the errors shown in the system error list.
+     *
+     * This must be called on the notepad++ thread.
+     */
+    Error_Store const &system_errors();
+
+    /** Replace all the displayed errors with previously saved ones */
+    void show_errors(Error_Store const &lints, Error_Store const &system);
 
     /** Selects the next lint message */
     void select_next_lint();
@@ -63,21 +82,22 @@ class Output_Dialogue : protected Docking_Dialogue_Interface
     void select_previous_lint();
 
     /** Disable redrawing */
-    void disable_redraw() const noexcept;
+    void disable_redraw();
 
-    /** Enable redrawing */
-    void enable_redraw() const noexcept;
+    /** Enable redrawing, sorting the current tab if it has changed */
+    void enable_redraw();
 
   private:
     enum Tab
     {
         Lint_Error,
-        System_Error
+        System_Error,
+        Statistics
     };
 
     enum
     {
-        Num_Tabs = 2
+        Num_Tabs = 3
     };
 
     struct TabDefinition
@@ -92,7 +112,9 @@ class Output_Dialogue : protected Docking_Dialogue_Interface
         UINT list_view_id;
         Tab tab;
         Report_View report_view;
-        std::vector<Error_Info> errors;
+        Error_Store errors;
+        Error_Sort_Keys sort_keys;
+        bool sorted{true};
         // NOLINTEND(misc-non-private-member-variables-in-classes)
     };
 
@@ -124,8 +146,41 @@ class Output_Dialogue : protected Docking_Dialogue_Interface
     /** Update the counts in the tab bar */
     void update_displayed_counts();
 
+    /** Make a change to what is displayed on the notepad++ thread */
+    void post_update(std::function<void()> update);
+
+    /** Make the changes posted from other threads */
+    void apply_updates();
+
+    /** Remove the errors from all the tabs */
+    void clear_tabs();
+
     /** Add list of errors to the appropriate tab */
-    void add_errors(Tab tab, std::vector<Error_Info> const &lints);
+    void add_errors(Tab tab, Error_Store const &lints);
+
+    /** Sort a tab if errors have been added since it was last sorted */
+    void sort_tab(TabDefinition &) noexcept;
+
+    /** Sort rows of a tab by the specified columns */
+    void sort_rows(
+        TabDefinition const &, std::vector<Report_View::Data_Row> &,
+        std::vector<Report_View::Sort_Column> const &
+    ) const;
+
+    /** Sort rows of the statistics tab by the specified columns */
+    void sort_statistics(
+        std::vector<Report_View::Data_Row> &,
+        std::vector<Report_View::Sort_Column> const &
+    ) const;
+
+    /** Get the latest command statistics for the statistics tab */
+    void update_statistics();
+
+    /** Write the command statistics to a CSV file and open it */
+    void export_statistics();
+
+    /** Process LVN_GETDISPINFO notification for one of the tabs */
+    void get_display_info(TabDefinition const &, LPARAM) const noexcept;
 
     /** Skip to the n-th lint forward or backward */
     void select_lint(int n);
@@ -144,9 +199,6 @@ class Output_Dialogue : protected Docking_Dialogue_Interface
     /** Copy selected messages to clipboard */
     void copy_to_clipboard();
 
-    /** This is called from the ListView_Sort method */
-    Report_View::Sort_Callback sort_call_function;
-
     HWND tab_bar_;
 
     Report_View *current_report_view_{nullptr};
@@ -155,10 +207,17 @@ class Output_Dialogue : protected Docking_Dialogue_Interface
 
     TabDefinition *current_tab_;
 
-    Settings const *settings_;
+    // What the statistics tab displays: some notes about the plugin as a
+    // whole, followed by the statistics for each command.
+    std::vector<std::wstring> statistics_notes_;
+    std::vector<Command_Statistics::Summary> statistics_;
+
+    // Changes waiting to be made on the notepad++ thread
+    std::mutex updates_mutex_;
+    std::vector<std::function<void()>> updates_;
 
-    // Sorting callback function pointer.
-    Report_View::Sort_Callback_Function sort_callback_;
+    // For the current settings
+    Linter const &linter_;
 
     // Initial font for the output dialogue
     HFONT initial_font_;
@@ -0,0 +1,29 @@
+#include "Output_Reader.h"
+
+namespace Linter
+{
+
+void Output_Reader::read()
+{
+    bool running = true;
+    while (running or is_open(0) or is_open(1))
+    {
+        auto const [event, pipe] = wait(running);
+        switch (event)
+        {
+            case Event::Stopped:
+            case Event::Timed_Out:
+                return;
+
+            case Event::Output:
+                read_pipe(pipe);
+                break;
+
+            case Event::Exited:
+                running = false;
+                break;
+        }
+    }
+}
+
+}    // namespace Linter
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <cstddef>
+
+namespace Linter
+{
+
+/** Reads the output of a linter from its stdout and stderr till it exits.
+ *
+ * Output is read from either pipe as soon as it arrives, so the linter can't
+ * block writing to one while we wait for the other.
+ *
+ * Normally the pipes will be closed when the process exits, but if the
+ * process starts something else which hangs on to them, we'll never see that,
+ * so once the process has exited, we just take whatever is available and
+ * return. Conversely, the process may close its output before it exits, so
+ * we have to wait for it to actually finish.
+ *
+ * Waiting and reading are left to the subclass, which knows how the system
+ * does them.
+ */
+class Output_Reader
+{
+  public:
+    Output_Reader(Output_Reader const &) = delete;
+    Output_Reader(Output_Reader &&) = delete;
+    Output_Reader &operator=(Output_Reader const &) = delete;
+    Output_Reader &operator=(Output_Reader &&) = delete;
+
+    virtual ~Output_Reader() = default;
+
+    /** Read the output till the process has exited and the pipes have been
+     * drained, or a stop is requested.
+     */
+    void read();
+
+  protected:
+    /** What ended a wait */
+    enum class Event
+    {
+        /** A stop was requested */
+        Stopped,
+        /** Something arrived on a pipe, or the other end was closed */
+        Output,
+        /** The process exited */
+        Exited,
+        /** The process has exited, and nothing else is ready */
+        Timed_Out
+    };
+
+    struct Wakeup
+    {
+        Event event;
+        /** Which pipe (0 or 1) for Event::Output */
+        std::size_t pipe;
+    };
+
+    Output_Reader() = default;
+
+    /** Check if we're still reading from a pipe */
+    virtual bool is_open(std::size_t pipe) const = 0;
+
+    /** Wait for output on a pipe which is still open, or a stop request.
+     *
+     * If the process is still running, this also waits for it to exit.
+     * Otherwise it only waits for things which are already ready.
+     *
+     * If several things are ready, a stop request takes priority, followed by
+     * output, so the pipes are drained before the exit is noticed.
+     */
+    virtual Wakeup wait(bool running) = 0;
+
+    /** Read what has arrived on a pipe, noting if it has been closed */
+    virtual void read_pipe(std::size_t pipe) = 0;
+};
+
+}    // namespace Linter
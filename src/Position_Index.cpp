@@ -0,0 +1,107 @@
+#include "Position_Index.h"
+
+#include "Encoding.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <utility>
+
+namespace Linter
+{
+
+Position_Index::Position_Index(Line_Start line_start, Line_Text line_text) :
+    get_line_start_(std::move(line_start)),
+    get_line_text_(std::move(line_text))
+{
+}
+
+std::intptr_t Position_Index::position(int line, int column)
+{
+    if (line_ != line)
+    {
+        load_line(line);
+    }
+
+    if (column <= 1)
+    {
+        return start_;
+    }
+
+    // Convert to the number of code units before the error.
+    auto const units = static_cast<std::size_t>(column) - 1;
+    std::size_t offset = length_;
+    if (units <= ascii_prefix_)
+    {
+        offset = units;
+    }
+    else
+    {
+        if (not offsets_built_)
+        {
+            build_offsets();
+        }
+        if (units - ascii_prefix_ < offsets_.size())
+        {
+            offset = offsets_[units - ascii_prefix_];
+        }
+    }
+    return start_ + static_cast<std::intptr_t>(offset);
+}
+
+void Position_Index::load_line(int line)
+{
+    line_ = line;
+    start_ = get_line_start_(line - 1);
+    text_ = get_line_text_(line - 1);
+
+    length_ = text_.size();
+    while (length_ > 0
+           and (text_[length_ - 1] == '\n' or text_[length_ - 1] == '\r'))
+    {
+        length_ -= 1;
+    }
+
+    ascii_prefix_ = Encoding::ascii_prefix_length(
+        std::string_view{text_}.substr(0, length_)
+    );
+    offsets_.clear();
+    offsets_built_ = false;
+}
+
+void Position_Index::build_offsets()
+{
+    // The array references are safe as we check against the line length.
+#pragma warning(push)
+#pragma warning(disable : 26446)
+    offsets_.reserve(length_ - ascii_prefix_);
+    for (std::size_t pos = ascii_prefix_; pos < length_;)
+    {
+        auto const chr = static_cast<unsigned char>(text_[pos]);
+        std::size_t bytes = 1;
+        std::size_t units = 1;
+        if (chr >= 0xF0)
+        {
+            // Non-BMP, so it's a surrogate pair in UTF-16
+            bytes = 4;
+            units = 2;
+        }
+        else if (chr >= 0xE0)
+        {
+            bytes = 3;
+        }
+        else if (chr >= 0xC0)
+        {
+            bytes = 2;
+        }
+        // Anything else (ASCII or a stray continuation byte) is 1 byte.
+
+        // Both halves of a surrogate pair map to the start of the character.
+        offsets_.insert(offsets_.end(), units, pos);
+        pos += bytes;
+    }
+    offsets_built_ = true;
+#pragma warning(pop)
+}
+
+}    // namespace Linter
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace Linter
+{
+
+/** Maps the line and column numbers reported by linters to editor positions.
+ *
+ * The text of each line is fetched once, and the column to byte offset
+ * mapping is worked out once per line, so this is most efficient when the
+ * positions are requested in line order.
+ */
+class Position_Index
+{
+  public:
+    /** Get the position of the start of a line (0 based) */
+    using Line_Start = std::function<std::intptr_t(int)>;
+
+    /** Get the UTF-8 text of a line (0 based), including the line end */
+    using Line_Text = std::function<std::string(int)>;
+
+    Position_Index(Line_Start line_start, Line_Text line_text);
+
+    /** Get the editor position for a 1 based line and column.
+     *
+     * Columns are counted in UTF-16 code units, as most linters do. Columns
+     * past the end of the line are placed at the end of the line.
+     */
+    std::intptr_t position(int line, int column);
+
+  private:
+    void load_line(int line);
+
+    void build_offsets();
+
+    Line_Start get_line_start_;
+
+    Line_Text get_line_text_;
+
+    // Currently loaded line
+    std::optional<int> line_;
+
+    // Position of the start of the line
+    std::intptr_t start_{0};
+
+    // Text of the line
+    std::string text_;
+
+    // Length of the line, excluding the line end
+    std::size_t length_{0};
+
+    // Number of bytes at the start of the line which are ASCII, so the
+    // column is the byte offset
+    std::size_t ascii_prefix_{0};
+
+    // Byte offsets of each UTF-16 code unit after the ASCII prefix. This is
+    // only built if needed.
+    std::vector<std::size_t> offsets_;
+
+    bool offsets_built_{false};
+};
+
+}    // namespace Linter
@@ -0,0 +1,96 @@
+#include "Relint_Delay.h"
+
+#include <algorithm>
+#include <chrono>
+#include <mutex>
+#include <optional>
+#include <string>
+
+namespace Linter
+{
+
+void Relint_Delay::set_limits(Duration minimum, Duration maximum)
+{
+    std::scoped_lock const lock{mutex_};
+    minimum_ = minimum;
+    maximum_ = std::max(minimum, maximum);
+}
+
+void Relint_Delay::edited(Clock::time_point now)
+{
+    std::scoped_lock const lock{mutex_};
+    if (last_edit_.has_value())
+    {
+        auto const gap =
+            std::chrono::duration_cast<Duration>(now - *last_edit_);
+        if (gap < Min_Typing_Gap)
+        {
+            // Treat this as part of the previous change.
+            return;
+        }
+        if (gap <= Max_Typing_Gap)
+        {
+            typing_gap_ = average(typing_gap_, gap);
+        }
+    }
+    last_edit_ = now;
+}
+
+void Relint_Delay::linted(std::wstring const &extension, Duration duration)
+{
+    std::scoped_lock const lock{mutex_};
+    auto const pos = lint_times_.find(extension);
+    if (pos == lint_times_.end())
+    {
+        lint_times_.emplace(extension, duration);
+    }
+    else
+    {
+        pos->second = average(pos->second, duration);
+    }
+}
+
+Relint_Delay::Duration Relint_Delay::delay(std::wstring const &extension)
+{
+    std::scoped_lock const lock{mutex_};
+    // Wait for a bit longer than the usual pause between keystrokes, so we
+    // don't start while the user is still typing, and for as long as a lint
+    // takes, so that at most half the time is spent on lints that get thrown
+    // away.
+    Duration wanted{0};
+    if (typing_gap_.has_value())
+    {
+        wanted = *typing_gap_ * 3 / 2;
+    }
+    if (auto const pos = lint_times_.find(extension); pos != lint_times_.end())
+    {
+        wanted = std::max(wanted, pos->second);
+    }
+    last_delay_ = std::clamp(wanted, minimum_, maximum_);
+    return last_delay_;
+}
+
+Relint_Delay::Duration Relint_Delay::last_delay() const
+{
+    std::scoped_lock const lock{mutex_};
+    return last_delay_;
+}
+
+std::optional<Relint_Delay::Duration> Relint_Delay::typing_gap() const
+{
+    std::scoped_lock const lock{mutex_};
+    return typing_gap_;
+}
+
+Relint_Delay::Duration Relint_Delay::average(
+    std::optional<Duration> const &previous, Duration value
+)
+{
+    if (not previous.has_value())
+    {
+        return value;
+    }
+    return (*previous * 3 + value) / 4;
+}
+
+}    // namespace Linter
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <chrono>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+
+namespace Linter
+{
+
+/** Works out how long to wait after the buffer is changed before linting it.
+ *
+ * Starting a lint while the user is still typing is a waste of time, as it
+ * will be stopped at the next keystroke, and that matters more the longer the
+ * linters take. So this keeps track of the time between changes to the
+ * buffer, and of how long the linters for each extension take, and waits for
+ * whichever is longer, within the configured limits.
+ *
+ * The times are supplied by the caller, so this doesn't depend on the clock.
+ *
+ * This can be used from several threads at once.
+ */
+class Relint_Delay
+{
+  public:
+    using Clock = std::chrono::steady_clock;
+    using Duration = std::chrono::milliseconds;
+
+    /** Set the shortest and longest delay to use */
+    void set_limits(Duration minimum, Duration maximum);
+
+    /** Note that the buffer was changed at the given time */
+    void edited(Clock::time_point now);
+
+    /** Note how long it took to lint a file with the given extension */
+    void linted(std::wstring const &extension, Duration duration);
+
+    /** Get the delay to use before linting a file with the given extension */
+    Duration delay(std::wstring const &extension);
+
+    /** The last delay returned by delay() */
+    Duration last_delay() const;
+
+    /** The average time between changes to the buffer while typing */
+    std::optional<Duration> typing_gap() const;
+
+  private:
+    // Changes closer together than this are part of the same edit (for
+    // instance a replacement or an auto-indent).
+    static constexpr Duration Min_Typing_Gap{20};
+
+    // Changes further apart than this are not continuous typing.
+    static constexpr Duration Max_Typing_Gap{1000};
+
+    /** Update a moving average, weighting recent values more heavily */
+    static Duration average(std::optional<Duration> const &, Duration);
+
+    mutable std::mutex mutex_;
+
+    Duration minimum_{100};
+    Duration maximum_{2000};
+
+    std::optional<Clock::time_point> last_edit_;
+
+    std::optional<Duration> typing_gap_;
+
+    // Average lint times by extension
+    std::unordered_map<std::wstring, Duration> lint_times_;
+
+    Duration last_delay_{0};
+};
+
+}    // namespace Linter
@@ -5,7 +5,8 @@
 
 #include <CommCtrl.h>
 
-#include <optional>
+#include <algorithm>
+#include <vector>
 
 namespace Linter
 {
@@ -37,48 +38,54 @@ void Report_View::autosize_columns() const noexcept
     }
 }
 
-void Report_View::sort_by_column(
-    Sort_Callback_Function const &callback
-) const noexcept
+void Report_View::sort_by_column(Sorter const &sorter) const noexcept
 {
-    Super::sort_by_column(
+    sort_rows(
+        [this, &sorter](std::vector<Data_Row> &rows)
+        {
 #ifndef __cpp_lib_copyable_function
 #pragma warning(suppress : 26447)
 #endif
-        current_sort_column_, callback, current_sort_direction_
+            sorter(rows, sort_order_);
+        }
     );
     if (header_)
     {
-        header_->set_sort_icon(current_sort_column_, current_sort_direction_);
+        header_->set_sort_icons(sort_order_);
     }
 }
 
 void Report_View::sort_by_column(
-    Data_Column column, Sort_Callback_Function const &callback
+    Data_Column column, bool add_column, Sorter const &sorter
 ) const noexcept
 {
-    if (current_sort_column_ == column)
+    auto const sort_column =
+        std::ranges::find(sort_order_, column, &Sort_Column::column);
+    if (sort_column == sort_order_.end())
     {
-        // Toggle sort direction
-        if (current_sort_direction_ == Sort_Direction::Ascending)
-        {
-            current_sort_direction_ = Sort_Direction::Descending;
-        }
-        else if (current_sort_direction_ == Sort_Direction::Descending)
+        if (not add_column)
         {
-            current_sort_direction_ = Sort_Direction::None;
-        }
-        else
-        {
-            current_sort_direction_ = Sort_Direction::Ascending;
+            sort_order_.clear();
         }
+        sort_order_.push_back(
+            {.column = column, .direction = Sort_Direction::Ascending}
+        );
+    }
+    else if (not add_column and sort_order_.size() != 1)
+    {
+        sort_order_.assign(
+            {{.column = column, .direction = Sort_Direction::Ascending}}
+        );
+    }
+    else if (sort_column->direction == Sort_Direction::Ascending)
+    {
+        sort_column->direction = Sort_Direction::Descending;
     }
     else
     {
-        current_sort_column_ = column;
-        current_sort_direction_ = Sort_Direction::Ascending;
+        sort_order_.erase(sort_column);
     }
-    sort_by_column(callback);
+    sort_by_column(sorter);
 }
 
 int Report_View::get_num_columns() const noexcept
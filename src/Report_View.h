@@ -5,7 +5,9 @@
 
 #include <windef.h>    // for HWND
 
+#include <functional>
 #include <memory>
+#include <vector>
 
 namespace Linter
 {
@@ -42,12 +44,30 @@ class Report_View : public List_View
      */
     void autosize_columns() const noexcept;
 
-    /* Sort by column using the last used column and direction */
-    void sort_by_column(Sort_Callback_Function const &) const noexcept;
+    using Sort_Column = typename List_View_Types::Sort_Column;
 
-    /* Sort by column, toggling direction if same column as last time */
+    /** Puts the data rows in order according to the supplied columns.
+     *
+     * An empty list of columns means the rows should be in insertion order.
+     */
+    using Sorter = std::function<
+        void(std::vector<Data_Row> &, std::vector<Sort_Column> const &)>;
+
+    /* Sort using the current sort order */
+    void sort_by_column(Sorter const &) const noexcept;
+
+    /* Sort by column.
+     *
+     * If add_column is false, this makes the column the only sort column,
+     * toggling the direction if it was already that, or clearing the sort
+     * after descending.
+     *
+     * If add_column is true, the column is added to the end of the sort
+     * order, or if it is already present, its direction is toggled, and it is
+     * removed after descending.
+     */
     void sort_by_column(
-        Data_Column, Sort_Callback_Function const &
+        Data_Column, bool add_column, Sorter const &
     ) const noexcept;
 
     /** Total number of columns */
@@ -55,9 +75,10 @@ class Report_View : public List_View
 
   private:
     std::unique_ptr<Column_Header> header_;
-    // Initial column and direction for sorting
-    mutable Data_Column current_sort_column_{0};
-    mutable Sort_Direction current_sort_direction_{Sort_Direction::Ascending};
+    // Columns and directions for sorting, most significant first
+    mutable std::vector<Sort_Column> sort_order_{
+        {.column = 0, .direction = Sort_Direction::Ascending}
+    };
 };
 
 }    // namespace Linter
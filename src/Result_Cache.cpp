@@ -0,0 +1,120 @@
+#include "Result_Cache.h"
+
+#include "Error_Store.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <string>
+
+namespace Linter
+{
+
+Result_Cache::~Result_Cache() = default;
+
+std::uint64_t Result_Cache::hash(std::string const &text) noexcept
+{
+    // 64 bit FNV-1a
+    std::uint64_t hash = 0xcbf29ce484222325ULL;
+    for (auto const character : text)
+    {
+        hash ^= static_cast<unsigned char>(character);
+        hash *= 0x100000001b3ULL;
+    }
+    return hash;
+}
+
+std::shared_ptr<Error_Store const> Result_Cache::find(Key const &key)
+{
+    std::scoped_lock const lock{mutex_};
+    auto const pos = index_.find(key);
+    if (pos == index_.end())
+    {
+        misses_ += 1;
+        return nullptr;
+    }
+    hits_ += 1;
+    // Move it to the front so it's the last thing to be evicted.
+    entries_.splice(entries_.begin(), entries_, pos->second);
+    return pos->second->errors;
+}
+
+void Result_Cache::store(Key const &key, Error_Store const &errors)
+{
+    std::size_t const bytes = size_of(key, errors);
+
+    std::scoped_lock const lock{mutex_};
+    if (bytes > budget_)
+    {
+        // This would push everything else out and then get evicted itself.
+        return;
+    }
+    if (auto const pos = index_.find(key); pos != index_.end())
+    {
+        erase(pos->second);
+    }
+    entries_.push_front(Entry{
+        .key = key,
+        .errors = std::make_shared<Error_Store const>(errors),
+        .bytes = bytes
+    });
+    index_.emplace(key, entries_.begin());
+    bytes_ += bytes;
+    evict();
+}
+
+void Result_Cache::set_budget(std::size_t bytes)
+{
+    std::scoped_lock const lock{mutex_};
+    budget_ = bytes;
+    evict();
+}
+
+void Result_Cache::clear()
+{
+    std::scoped_lock const lock{mutex_};
+    index_.clear();
+    entries_.clear();
+    bytes_ = 0;
+}
+
+Result_Cache::Statistics Result_Cache::statistics() const
+{
+    std::scoped_lock const lock{mutex_};
+    return {
+        .hits = hits_,
+        .misses = misses_,
+        .entries = entries_.size(),
+        .bytes = bytes_
+    };
+}
+
+std::size_t Result_Cache::size_of(
+    Key const &key, Error_Store const &errors
+) noexcept
+{
+    // This is an estimate, as it ignores the overhead of the allocations,
+    // but is good enough for keeping the size under control.
+    return sizeof(Entry) + 2 * sizeof(Key)
+         + 2 * (key.path.size() + key.command.size()) * sizeof(wchar_t)
+         + errors.bytes();
+}
+
+void Result_Cache::erase(Entries::iterator entry)
+{
+    bytes_ -= entry->bytes;
+    index_.erase(entry->key);
+    entries_.erase(entry);
+}
+
+void Result_Cache::evict()
+{
+    while (bytes_ > budget_ and not entries_.empty())
+    {
+        erase(std::prev(entries_.end()));
+    }
+}
+
+}    // namespace Linter
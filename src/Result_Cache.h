@@ -0,0 +1,112 @@
+#pragma once
+
+#include "Error_Store.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+namespace Linter
+{
+
+/** Caches the errors produced by running a linter on a buffer.
+ *
+ * Switching between tabs or saving a file without changing it would
+ * otherwise rerun all the linters for no reason.
+ *
+ * The cache is limited to a given number of bytes. When it gets too big, the
+ * least recently used results are discarded.
+ *
+ * This can be used from several threads at once.
+ */
+class Result_Cache
+{
+  public:
+    /** What the results depend on */
+    struct Key
+    {
+        std::uint64_t text_hash;
+        std::size_t text_size;
+        std::wstring path;
+        std::wstring command;
+        unsigned int settings_generation;
+
+        auto operator<=>(Key const &) const = default;
+    };
+
+    struct Statistics
+    {
+        std::size_t hits;
+        std::size_t misses;
+        std::size_t entries;
+        std::size_t bytes;
+    };
+
+    Result_Cache() = default;
+
+    Result_Cache(Result_Cache const &) = delete;
+    Result_Cache(Result_Cache &&) = delete;
+    Result_Cache &operator=(Result_Cache const &) = delete;
+    Result_Cache &operator=(Result_Cache &&) = delete;
+
+    ~Result_Cache();
+
+    /** Get the hash to use in the key for the buffer contents.
+     *
+     * This is 64 bits even in 32 bit builds, as a collision would show the
+     * errors for different text.
+     */
+    static std::uint64_t hash(std::string const &text) noexcept;
+
+    /** Get the results for the key, or nullptr if we don't have them */
+    std::shared_ptr<Error_Store const> find(Key const &);
+
+    /** Save the results for the key */
+    void store(Key const &, Error_Store const &);
+
+    /** Set the maximum number of bytes to use. 0 disables the cache. */
+    void set_budget(std::size_t bytes);
+
+    /** Throw everything away */
+    void clear();
+
+    /** Get the cache usage */
+    Statistics statistics() const;
+
+  private:
+    struct Entry
+    {
+        Key key;
+        std::shared_ptr<Error_Store const> errors;
+        std::size_t bytes;
+    };
+
+    // Most recently used at the front
+    using Entries = std::list<Entry>;
+
+    static std::size_t size_of(Key const &, Error_Store const &) noexcept;
+
+    void erase(Entries::iterator);
+
+    void evict();
+
+    mutable std::mutex mutex_;
+
+    Entries entries_;
+
+    std::map<Key, Entries::iterator> index_;
+
+    std::size_t budget_{0};
+
+    std::size_t bytes_{0};
+
+    std::size_t hits_{0};
+
+    std::size_t misses_{0};
+};
+
+}    // namespace Linter
@@ -0,0 +1,76 @@
+#include "Server_Protocol.h"
+
+#include <charconv>
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <system_error>
+
+namespace Linter::Server_Protocol
+{
+
+namespace
+{
+
+/** Parse one of the byte counts in a reply header */
+std::optional<std::size_t> parse_size(char const *&start, char const *end)
+{
+    std::size_t size = 0;
+    auto const [ptr, err] = std::from_chars(start, end, size);
+    if (err != std::errc{})
+    {
+        return std::nullopt;
+    }
+    start = ptr;
+    return size;
+}
+
+}    // namespace
+
+std::string request(std::string const &path, std::string const &text)
+{
+    return path + "\n" + std::to_string(text.size()) + "\n" + text;
+}
+
+std::optional<Reply> take_reply(std::string &received)
+{
+    auto const header_end = received.find('\n');
+    if (header_end == std::string::npos)
+    {
+        return std::nullopt;
+    }
+
+    char const *start = received.data();
+    char const *const end = start + header_end;
+    auto const output_size = parse_size(start, end);
+    std::optional<std::size_t> error_size;
+    if (output_size.has_value() and start != end and *start == ' ')
+    {
+        start += 1;
+        error_size = parse_size(start, end);
+    }
+    if (not error_size.has_value() or start != end
+        or *output_size > received.max_size()
+        or *error_size > received.max_size() - *output_size)
+    {
+        throw Invalid_Reply(
+            "Invalid reply from linter server: "
+            + received.substr(0, header_end)
+        );
+    }
+
+    auto const body = header_end + 1;
+    if (received.size() < body + *output_size + *error_size)
+    {
+        return std::nullopt;
+    }
+
+    Reply reply{
+        .output = received.substr(body, *output_size),
+        .error_output = received.substr(body + *output_size, *error_size)
+    };
+    received.erase(0, body + *output_size + *error_size);
+    return reply;
+}
+
+}    // namespace Linter::Server_Protocol
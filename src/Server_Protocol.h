@@ -0,0 +1,44 @@
+#pragma once
+
+#include <optional>
+#include <stdexcept>
+#include <string>
+
+namespace Linter::Server_Protocol
+{
+
+/** The framing used to talk to a persistent linter.
+ *
+ * A request is a line containing the (UTF-8) path of the file, a line
+ * containing the number of bytes of text, and then the text itself.
+ *
+ * A reply is a line containing the number of bytes of checkstyle output and
+ * the number of bytes of error output, separated by a space, followed by the
+ * checkstyle output and then the error output.
+ */
+
+/** A reply from the server */
+struct Reply
+{
+    std::string output;
+    std::string error_output;
+};
+
+/** Thrown if the server sends something which isn't a reply */
+class Invalid_Reply : public std::runtime_error
+{
+  public:
+    using std::runtime_error::runtime_error;
+};
+
+/** Make the request for a file */
+std::string request(std::string const &path, std::string const &text);
+
+/** Remove the first reply from the start of what has been received.
+ *
+ * Returns an empty optional, and leaves what has been received alone, if the
+ * reply hasn't all arrived yet.
+ */
+std::optional<Reply> take_reply(std::string &received);
+
+}    // namespace Linter::Server_Protocol
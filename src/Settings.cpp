@@ -3,29 +3,31 @@
 #include "Dom_Document.h"
 #include "Dom_Node.h"
 #include "Dom_Node_List.h"
+#include "Encoding.h"
 #include "Indicator.h"
-#include "Linter.h"
 #include "Menu_Entry.h"
-#include "System_Error.h"
+#include "Variable_Cache.h"
+#include "Whitespace.h"
 
 #include "notepad++/PluginInterface.h"
 
-#include <atlcomcli.h>
-#include <comutil.h>
 #include <intsafe.h>
 #include <minwindef.h>    // For FALSE, TRUE
-#include <msxml6.h>
 #include <wingdi.h>     // For RGB
 #include <winuser.h>    // For VK_...
 
+#include <algorithm>
 #include <chrono>
+#include <cstddef>
 #include <cwctype>
-#include <exception>
 #include <filesystem>
 #include <list>
 #include <optional>
-#include <regex>
 #include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
 #include <vector>
 
 namespace Linter
@@ -34,6 +36,49 @@ namespace Linter
 namespace
 {
 
+unsigned int default_max_parallel_linters() noexcept
+{
+    // hardware_concurrency is allowed to return 0 if it can't work it out.
+    return std::max(std::thread::hardware_concurrency(), 1U);
+}
+
+/** Extensions are matched ignoring case, as windows file names are */
+std::wstring fold_case(std::wstring text)
+{
+    std::ranges::transform(
+        text,
+        text.begin(),
+        [](wchar_t chr) noexcept
+        { return static_cast<wchar_t>(std::towlower(chr)); }
+    );
+    return text;
+}
+
+/** A persistent linter is shared by all the files it lints, so its command
+ * can't depend on which file it is started for.
+ */
+void check_persistent_command(Settings::Command const &command)
+{
+    auto const command_line =
+        fold_case(command.program.wstring() + L' ' + command.args);
+    for (std::wstring const variable :
+         {L"%LINTER_TARGET%",
+          L"%TARGET%",
+          L"%TARGET_DIR%",
+          L"%TARGET_EXT%",
+          L"%TARGET_FILENAME%"})
+    {
+        if (command_line.find(fold_case(variable)) != std::wstring::npos)
+        {
+            throw std::runtime_error(
+                "Persistent linter command can't use "
+                + Encoding::convert(variable) + ": "
+                + Encoding::convert(command.args)
+            );
+        }
+    }
+}
+
 auto default_message_colours()
 {
     static std::unordered_map<std::wstring, uint32_t> const colours{
@@ -46,40 +91,28 @@ auto default_message_colours()
 
 }    // namespace
 
-Settings::Settings(::Linter::Linter const &linter) :
-    settings_xml_(
-        linter.get_plugin_config_dir().append(linter.get_name() + L".xml")
-    ),
-    settings_xsd_(linter.get_module_path().replace_extension(".xsd")),
-    message_colours_(default_message_colours())
+Settings::Settings(
+    std::filesystem::path settings_xml, unsigned int generation
+) :
+    settings_xml_(std::move(settings_xml)),
+    message_colours_(default_message_colours()),
+    max_parallel_linters_(default_max_parallel_linters()),
+    generation_(generation)
 {
-    // Create a schema cache and our xsd to it.
-    auto hres = settings_schema_.CoCreateInstance(__uuidof(XMLSchemaCache60));
-    if (not SUCCEEDED(hres))
-    {
-        throw System_Error(hres, "Can't create XMLSchemaCache60");
-    }
-
-    CComVariant const xsd{settings_xsd_.c_str()};
-
-    hres = settings_schema_->add(bstr_t(""), xsd);
-    if (not SUCCEEDED(hres))
-    {
-        throw System_Error(hres, "Can't add to schema pool");
-    }
+}
 
-    // A note: We try to read the settings at this point and quietly ignore
-    // errors if we can't. This isn't great, but not sure where I can put
-    // errors.
-    try
-    {
-        refresh();
-    }
-    catch (std::exception const &err)
-    {
-        // Nothing we can usefully do.
-        std::ignore = err;
-    }
+Settings::Settings(
+    std::filesystem::path settings_xml, Dom_Document const &settings,
+    unsigned int generation
+) :
+    Settings(std::move(settings_xml), generation)
+{
+    read_indicator(settings);
+    read_messages(settings);
+    read_shortcuts(settings);
+    read_linters(settings);
+    read_variables(settings);
+    read_misc(settings);
 }
 
 Settings::~Settings() = default;
@@ -98,18 +131,27 @@ uint32_t Settings::get_message_colour(std::wstring const &colour) const noexcept
     return val->second;
 }
 
-void Settings::refresh()
+std::vector<Settings::Command> const &Settings::get_commands(
+    std::filesystem::path const &path
+) const
 {
-    if (not std::filesystem::exists(settings_xml_))
+    static std::vector<Command> const none;
+
+    // The longest extension that matches has the commands for all the
+    // shorter ones, so look for that. There's no point looking at anything
+    // longer than the longest extension we know about.
+    auto const name = fold_case(path.filename().wstring());
+    auto const first = name.size() - std::min(name.size(), longest_extension_);
+    for (auto pos = name.find(L'.', first); pos != std::wstring::npos;
+         pos = name.find(L'.', pos + 1))
     {
-        return;
-    }
-    auto const last_write_time{std::filesystem::last_write_time(settings_xml_)};
-    if (last_write_time != last_update_time_)
-    {
-        read_settings();
-        last_update_time_ = last_write_time;
+        if (auto const found = linters_.find(name.substr(pos));
+            found != linters_.end())
+        {
+            return found->second;
+        }
     }
+    return none;
 }
 
 ShortcutKey const *Settings::get_shortcut_key(Menu_Entry entry) const
@@ -138,17 +180,6 @@ uint32_t Settings::read_colour_node(Dom_Node const &node)
     return bgr;
 }
 
-void Settings::read_settings()
-{
-    Dom_Document const settings{settings_xml_, settings_schema_};
-    read_indicator(settings);
-    read_messages(settings);
-    read_shortcuts(settings);
-    read_linters(settings);
-    read_variables(settings);
-    read_misc(settings);
-}
-
 void Settings::read_indicator(Dom_Document const &settings)
 {
     indicator_.read_config(settings.get_node("//indicator"));
@@ -242,13 +273,14 @@ void Settings::read_shortcuts(Dom_Document const &settings)
 
 void Settings::read_linters(Dom_Document const &settings)
 {
-    linters_.clear();
+    // Every command for every extension, in the order they were listed
+    std::vector<std::pair<std::wstring, Command>> linters;
     for (auto const linter : settings.get_node_list("//linter"))
     {
         std::vector<std::wstring> extensions;
         for (auto const extension_node : linter.get_node_list(".//extension"))
         {
-            extensions.push_back(extension_node.get_value());
+            extensions.push_back(fold_case(extension_node.get_value()));
         }
 
         for (auto const command_node : linter.get_node_list(".//command"))
@@ -256,10 +288,37 @@ void Settings::read_linters(Dom_Document const &settings)
             Settings::Command cmd = read_command(command_node);
             cmd.use_stdin =
                 cmd.args.find(L"%LINTER_TARGET%") == std::string::npos;
+            cmd.persistent =
+                command_node.get_optional_node("./persistent").has_value();
+            if (cmd.persistent)
+            {
+                check_persistent_command(cmd);
+            }
 
             for (auto const &extension : extensions)
             {
-                linters_.push_back({.extension = extension, .command = cmd});
+                linters.emplace_back(extension, cmd);
+            }
+        }
+    }
+
+    // Work out the commands for each extension now, so that finding the
+    // commands for a file doesn't depend on how many linters there are.
+    linters_.clear();
+    longest_extension_ = 0;
+    for (auto const &[extension, command] : linters)
+    {
+        linters_.try_emplace(extension);
+        longest_extension_ = std::max(longest_extension_, extension.size());
+    }
+    for (auto &[extension, commands] : linters_)
+    {
+        for (auto const &[suffix, command] : linters)
+        {
+            if (extension.ends_with(suffix)
+                and std::ranges::find(commands, command) == commands.end())
+            {
+                commands.push_back(command);
             }
         }
     }
@@ -275,7 +334,30 @@ void Settings::read_variables(Dom_Document const &settings)
         std::wstring const name{name_node.get_value()};
         Dom_Node const command_node{variable.get_node(".//command")};
         Command const cmd = read_command(command_node);
-        variables_.emplace_back(name, cmd);
+
+        Variable_Cache::Policy cache;
+        if (auto const cache_node = variable.get_optional_node("./cache"))
+        {
+            using Mode = Variable_Cache::Policy::Mode;
+            if (cache_node->get_optional_node("./session"))
+            {
+                cache.mode = Mode::Session;
+            }
+            else if (cache_node->get_optional_node("./directory"))
+            {
+                cache.mode = Mode::Directory;
+            }
+            else if (auto const seconds = cache_node->get_optional_node(
+                         "./seconds"
+                     ))
+            {
+                cache.mode = Mode::Timed;
+                cache.lifetime =
+                    std::chrono::seconds{std::stoul(seconds->get_value())};
+            }
+        }
+
+        variables_.push_back({.name = name, .command = cmd, .cache = cache});
     }
 }
 
@@ -288,6 +370,43 @@ void Settings::read_misc(Dom_Document const &settings)
         enabled_ = false;
     }
 
+    trace_ = settings.get_node("//misc/trace").has_value();
+
+    max_parallel_linters_ = default_max_parallel_linters();
+    if (auto const parallel_node = settings.get_node("//max_parallel_linters"))
+    {
+        max_parallel_linters_ =
+            static_cast<unsigned int>(std::stoul(parallel_node->get_value()));
+    }
+
+    result_cache_size_ = default_result_cache_size;
+    if (auto const cache_node = settings.get_node("//result_cache_size"))
+    {
+        result_cache_size_ =
+            static_cast<unsigned int>(std::stoul(cache_node->get_value()));
+    }
+
+    buffer_results_size_ = default_buffer_results_size;
+    if (auto const buffer_node = settings.get_node("//buffer_results_size"))
+    {
+        buffer_results_size_ =
+            static_cast<unsigned int>(std::stoul(buffer_node->get_value()));
+    }
+
+    min_relint_delay_ = default_min_relint_delay;
+    if (auto const delay_node = settings.get_node("//min_relint_delay"))
+    {
+        min_relint_delay_ =
+            static_cast<unsigned int>(std::stoul(delay_node->get_value()));
+    }
+
+    max_relint_delay_ = default_max_relint_delay;
+    if (auto const delay_node = settings.get_node("//max_relint_delay"))
+    {
+        max_relint_delay_ =
+            static_cast<unsigned int>(std::stoul(delay_node->get_value()));
+    }
+
     font_.reset();
     auto const font_node = settings.get_node("//font");
     if (font_node.has_value())
@@ -409,8 +528,7 @@ Settings::Command Settings::read_command(Dom_Node const &command_node)
     }
     // It appears microsoft completely ignores the xs:token type, so we
     // have to do this ourselves.
-    args = std::regex_replace(args, std::wregex(LR"((^\s+)|(\s+$))"), L"");
-    args = std::regex_replace(args, std::wregex(LR"(\s+)"), L" ");
+    args = Whitespace::collapse(args);
     // Should really only do this for linter commands but...
     if (args.ends_with(L"%%"))
     {
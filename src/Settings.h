@@ -2,22 +2,21 @@
 
 #include "Indicator.h"
 #include "Menu_Entry.h" // IWYU pragma: keep
+#include "Variable_Cache.h"
 // This would be better than the above. Slightly
 // IWYU pragma: no_forward_declare Menu_Entry
 
 #include "notepad++/PluginInterface.h"
 
-#include <atlcomcli.h>
-#include <msxml6.h>
 #include <windef.h>    // for HFONT
 
 #include <wil/resource.h>
 
+#include <cstddef>
 #include <cstdint>    // for uint32_t
 #include <filesystem>
 #include <string>
 #include <unordered_map>
-#include <utility>    // for pair
 #include <vector>
 
 namespace Linter
@@ -25,12 +24,24 @@ namespace Linter
 
 class Dom_Document;
 class Dom_Node;
-class Linter;
 
+/** The settings read from the configuration file.
+ *
+ * These don't change once they've been read. When the file is changed, a new
+ * Settings is created (see Settings_Watcher), so anything which is using the
+ * old ones can carry on doing so.
+ */
 class Settings
 {
   public:
-    explicit Settings(Linter const &linter);
+    /** The default settings, for when there isn't a configuration file */
+    Settings(std::filesystem::path settings_xml, unsigned int generation);
+
+    /** The settings from a configuration file */
+    Settings(
+        std::filesystem::path settings_xml, Dom_Document const &settings,
+        unsigned int generation
+    );
 
     Settings(Settings const &) = delete;
     Settings &operator=(Settings const &) = delete;
@@ -44,34 +55,38 @@ class Settings
         std::filesystem::path program;
         std::wstring args;
         bool use_stdin = false;
+        /** Kept running, and sent each file to lint */
+        bool persistent = false;
+
+        bool operator==(Command const &) const = default;
     };
 
-    struct Linter
+    struct Variable
     {
-        std::wstring extension;
+        std::wstring name;
         Command command;
+        Variable_Cache::Policy cache;
     };
 
-    using Variable = std::pair<std::wstring, Command>;
-
     /** Returns the configuration path */
     std::filesystem::path const &settings_file() const noexcept
     {
         return settings_xml_;
     }
 
-    /** Return the list of linters */
-    std::vector<Linter> const &linters() const noexcept
-    {
-        return linters_;
-    }
+    /** Get the commands to run for a file.
+     *
+     * These are the commands for every extension the file name ends with,
+     * ignoring case, so foo.d.ts gets the commands for .ts and for .d.ts, in
+     * the order they're listed in the configuration file.
+     */
+    std::vector<Command> const &get_commands(
+        std::filesystem::path const &
+    ) const;
 
     /** Get a message colour */
     uint32_t get_message_colour(std::wstring const &colour) const noexcept;
 
-    /** Reread settings if they've changed */
-    void refresh();
-
     ShortcutKey const *get_shortcut_key(Menu_Entry) const;
 
     Indicator const &indicator() const noexcept
@@ -84,11 +99,65 @@ class Settings
         return variables_;
     }
 
+    /** Cached values of variables.
+     *
+     * Each set of settings has its own, so it starts off empty whenever the
+     * settings are reread.
+     */
+    Variable_Cache &variable_cache() const noexcept
+    {
+        return variable_cache_;
+    }
+
     bool enabled() const noexcept
     {
         return enabled_;
     }
 
+    /** Whether to record how long each part of a lint takes */
+    bool trace() const noexcept
+    {
+        return trace_;
+    }
+
+    /** Maximum number of linters to run at the same time */
+    unsigned int max_parallel_linters() const noexcept
+    {
+        return max_parallel_linters_;
+    }
+
+    /** Maximum number of megabytes to use for saved linter results */
+    unsigned int result_cache_size() const noexcept
+    {
+        return result_cache_size_;
+    }
+
+    /** Maximum number of megabytes to use for results of open buffers */
+    unsigned int buffer_results_size() const noexcept
+    {
+        return buffer_results_size_;
+    }
+
+    /** Shortest time in milliseconds to wait after a change before linting */
+    unsigned int min_relint_delay() const noexcept
+    {
+        return min_relint_delay_;
+    }
+
+    /** Longest time in milliseconds to wait after a change before linting */
+    unsigned int max_relint_delay() const noexcept
+    {
+        return max_relint_delay_;
+    }
+
+    /** Incremented each time the settings are reread, so different
+     * settings have different generations
+     */
+    unsigned int generation() const noexcept
+    {
+        return generation_;
+    }
+
     static uint32_t read_colour_node(Dom_Node const &node);
 
     /** Get the font to use in the message window */
@@ -98,7 +167,10 @@ class Settings
     }
 
   private:
-    void read_settings();
+    static constexpr unsigned int default_result_cache_size = 16;
+    static constexpr unsigned int default_buffer_results_size = 16;
+    static constexpr unsigned int default_min_relint_delay = 100;
+    static constexpr unsigned int default_max_relint_delay = 2000;
 
     /** Process <indicator> XML element */
     void read_indicator(Dom_Document const &settings);
@@ -126,17 +198,12 @@ class Settings
     // configuration file
     std::filesystem::path const settings_xml_;
 
-    // xsd file
-    std::filesystem::path const settings_xsd_;
+    // The commands to run for each extension (in lower case), including
+    // the commands for the shorter extensions it ends with.
+    std::unordered_map<std::wstring, std::vector<Command>> linters_;
 
-    // Processed schema
-    CComPtr<IXMLDOMSchemaCollection2> settings_schema_;
-
-    // Last time linter++.xml was updated.
-    std::filesystem::file_time_type last_update_time_;
-
-    // The list of linters
-    std::vector<Linter> linters_;
+    // Length of the longest extension
+    std::size_t longest_extension_{0};
 
     // Custom message colours
     std::unordered_map<std::wstring, uint32_t> message_colours_;
@@ -150,9 +217,31 @@ class Settings
     // List of variables
     std::vector<Variable> variables_;
 
+    // Saved variable values
+    mutable Variable_Cache variable_cache_;
+
     // Startup enabled or not
     bool enabled_{true};
 
+    // Record how long each part of a lint takes
+    bool trace_{false};
+
+    // Number of linters that can be run at once
+    unsigned int max_parallel_linters_;
+
+    // Megabytes to use for saving linter results
+    unsigned int result_cache_size_{default_result_cache_size};
+
+    // Megabytes to use for saving the results of open buffers
+    unsigned int buffer_results_size_{default_buffer_results_size};
+
+    // Limits on the time to wait after a change before linting
+    unsigned int min_relint_delay_{default_min_relint_delay};
+    unsigned int max_relint_delay_{default_max_relint_delay};
+
+    // Number of times the settings have been read
+    unsigned int const generation_;
+
     wil::unique_hfont font_;
 };
 
@@ -0,0 +1,384 @@
+#include "Settings_Watcher.h"
+
+#include "Dom_Document.h"
+#include "File_Watcher.h"
+#include "Result_Cache.h"
+#include "Settings.h"
+#include "System_Error.h"
+#include "Trace.h"
+
+#include <atlcomcli.h>
+#include <combaseapi.h>
+#include <comutil.h>
+#include <fileapi.h>
+#include <handleapi.h>
+#include <intsafe.h>
+#include <ioapiset.h>
+#include <minwinbase.h>
+#include <msxml6.h>
+#include <stringapiset.h>
+#include <synchapi.h>
+#include <winbase.h>
+#include <winnls.h>
+#include <winnt.h>
+
+#include <wil/resource.h>
+
+#include <cstddef>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <sstream>
+#include <stop_token>
+#include <string>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+namespace Linter
+{
+
+namespace
+{
+
+// Size of the buffer for the list of changes to the directory
+constexpr DWORD Changes_Size = 4096;
+
+std::string read_file(std::filesystem::path const &path)
+{
+    std::ifstream file{path, std::ios::binary};
+    if (not file)
+    {
+        throw System_Error("Can't read " + path.filename().string());
+    }
+    return std::string{std::istreambuf_iterator<char>{file}, {}};
+}
+
+CComPtr<IXMLDOMSchemaCollection2> load_schemas(
+    std::filesystem::path const &settings_xsd
+)
+{
+    CComPtr<IXMLDOMSchemaCollection2> schemas;
+    auto hres = schemas.CoCreateInstance(__uuidof(XMLSchemaCache60));
+    if (not SUCCEEDED(hres))
+    {
+        throw System_Error(hres, "Can't create XMLSchemaCache60");
+    }
+
+    CComVariant const xsd{settings_xsd.c_str()};
+
+    hres = schemas->add(bstr_t(""), xsd);
+    if (not SUCCEEDED(hres))
+    {
+        throw System_Error(hres, "Can't add to schema pool");
+    }
+    return schemas;
+}
+
+/** Check if any of the changes in the list are to the named file */
+bool changes_file(
+    std::vector<DWORD> const &changes, std::wstring const &file_name
+)
+{
+    auto const *next = static_cast<void const *>(changes.data());
+    for (;;)
+    {
+        auto const *const change =
+            static_cast<FILE_NOTIFY_INFORMATION const *>(next);
+        // File names aren't case sensitive
+        if (CompareStringOrdinal(
+                &change->FileName[0],
+                static_cast<int>(change->FileNameLength / sizeof(WCHAR)),
+                file_name.c_str(),
+                static_cast<int>(file_name.size()),
+                TRUE
+            )
+            == CSTR_EQUAL)
+        {
+            return true;
+        }
+        if (change->NextEntryOffset == 0)
+        {
+            return false;
+        }
+        next = static_cast<std::byte const *>(next) + change->NextEntryOffset;
+    }
+}
+
+/** Initialises COM for the thread which reads the file */
+class COM_Wrapper
+{
+  public:
+    COM_Wrapper() noexcept : hres_(::CoInitialize(nullptr))
+    {
+    }
+
+    COM_Wrapper(COM_Wrapper const &) = delete;
+    COM_Wrapper(COM_Wrapper &&) = delete;
+    COM_Wrapper &operator=(COM_Wrapper const &) = delete;
+    COM_Wrapper &operator=(COM_Wrapper &&) = delete;
+
+    ~COM_Wrapper()
+    {
+        if (SUCCEEDED(hres_))
+        {
+            ::CoUninitialize();
+        }
+    }
+
+  private:
+    HRESULT hres_;
+};
+
+/** Waits for changes to the configuration directory with
+ * ReadDirectoryChangesW
+ */
+class Directory_Changes : public File_Watcher::Changes
+{
+  public:
+    Directory_Changes(
+        std::filesystem::path const &file, std::stop_token const &stop_token
+    ) :
+        file_name_(file.filename()),
+        directory_(CreateFile(
+            file.parent_path().c_str(),
+            FILE_LIST_DIRECTORY,
+            FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+            nullptr,
+            OPEN_EXISTING,
+            FILE_FLAG_BACKUP_SEMANTICS | FILE_FLAG_OVERLAPPED,
+            nullptr
+        )),
+        read_event_(CreateEvent(nullptr, TRUE, FALSE, nullptr)),
+        stop_event_(CreateEvent(nullptr, TRUE, FALSE, nullptr)),
+        // This has to be DWORD aligned.
+        changes_(Changes_Size / sizeof(DWORD))
+    {
+        if (not directory_)
+        {
+            throw System_Error("Can't watch configuration directory");
+        }
+        if (not read_event_ or not stop_event_)
+        {
+            throw System_Error();
+        }
+        stopper_.emplace(
+            stop_token, [this]() noexcept { SetEvent(stop_event_.get()); }
+        );
+    }
+
+    bool wait() override
+    {
+        for (;;)
+        {
+            OVERLAPPED overlapped{};
+            overlapped.hEvent = read_event_.get();
+            if (ReadDirectoryChangesW(
+                    directory_.get(),
+                    changes_.data(),
+                    Changes_Size,
+                    FALSE,
+                    FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_SIZE
+                        | FILE_NOTIFY_CHANGE_LAST_WRITE,
+                    nullptr,
+                    &overlapped,
+                    nullptr
+                )
+                == FALSE)
+            {
+                throw System_Error("Can't watch configuration directory");
+            }
+
+            HANDLE const handles[] = {overlapped.hEvent, stop_event_.get()};
+            if (WaitForMultipleObjects(2, &handles[0], FALSE, INFINITE)
+                != WAIT_OBJECT_0)
+            {
+                // The read can't be left outstanding, as it writes to
+                // changes_.
+                CancelIoEx(directory_.get(), &overlapped);
+                DWORD ignored;    // NOLINT(cppcoreguidelines-init-variables)
+                GetOverlappedResult(
+                    directory_.get(), &overlapped, &ignored, TRUE
+                );
+                return false;
+            }
+
+            DWORD size;    // NOLINT(cppcoreguidelines-init-variables)
+            if (GetOverlappedResult(directory_.get(), &overlapped, &size, TRUE)
+                == FALSE)
+            {
+                throw System_Error("Can't watch configuration directory");
+            }
+            // If there were too many changes to fit in the buffer, we aren't
+            // told what they were, so assume the file was one of them.
+            if (size == 0 or changes_file(changes_, file_name_))
+            {
+                return true;
+            }
+        }
+    }
+
+  private:
+    std::wstring const file_name_;
+    wil::unique_hfile const directory_;
+    wil::unique_handle const read_event_;
+    wil::unique_handle const stop_event_;
+    std::vector<DWORD> changes_;
+    // NB: This is set up last, as the callback can be invoked immediately.
+    std::optional<std::stop_callback<std::function<void()>>> stopper_;
+};
+
+}    // namespace
+
+Settings_Watcher::Settings_Watcher(
+    std::filesystem::path settings_xml, std::filesystem::path settings_xsd
+) :
+    settings_xml_(std::move(settings_xml)),
+    settings_xsd_(std::move(settings_xsd)),
+    validated_file_(
+        std::filesystem::path{settings_xml_}.replace_extension(".validated")
+    )
+{
+    load();
+    watcher_ = std::make_unique<File_Watcher>(
+        settings_xml_,
+        [](std::filesystem::path const &file,
+           std::stop_token const &stop_token)
+        { return std::make_unique<Directory_Changes>(file, stop_token); },
+        [this]()
+        {
+            COM_Wrapper const wrapper;
+            load();
+        }
+    );
+}
+
+Settings_Watcher::~Settings_Watcher() = default;
+
+std::shared_ptr<Settings const> Settings_Watcher::settings() const noexcept
+{
+    std::scoped_lock const lock{mutex_};
+    return settings_;
+}
+
+void Settings_Watcher::check() const
+{
+    std::exception_ptr error;
+    {
+        std::scoped_lock const lock{mutex_};
+        error = error_;
+    }
+    if (error)
+    {
+        std::rethrow_exception(error);
+    }
+}
+
+void Settings_Watcher::load() noexcept
+{
+    try
+    {
+        std::shared_ptr<Settings const> settings;
+        if (std::filesystem::exists(settings_xml_))
+        {
+            settings = read(read_file(settings_xml_));
+        }
+        else if (not settings_)
+        {
+            settings = std::make_shared<Settings const>(settings_xml_, 0);
+        }
+
+        std::scoped_lock const lock{mutex_};
+        if (settings)
+        {
+            settings_ = std::move(settings);
+        }
+        error_ = nullptr;
+    }
+    catch (std::exception const &)
+    {
+        std::scoped_lock const lock{mutex_};
+        if (not settings_)
+        {
+            // Something is needed, even if it isn't what was asked for.
+            try
+            {
+                settings_ =
+                    std::make_shared<Settings const>(settings_xml_, 0);
+            }
+            catch (std::exception const &)
+            {
+                // Nothing we can usefully do.
+            }
+        }
+        error_ = std::current_exception();
+    }
+}
+
+std::shared_ptr<Settings const> Settings_Watcher::read(
+    std::string const &contents
+)
+{
+    // Saving the file without changing it doesn't need the linters to be
+    // rerun.
+    std::wstring const stamp{get_stamp(contents)};
+    if (settings_ and not stamp.empty() and stamp == loaded_stamp_)
+    {
+        return nullptr;
+    }
+
+    Trace::Span const span{"Read settings"};
+
+    std::wstring validated_stamp;
+    if (std::wifstream file{validated_file_})
+    {
+        std::getline(file, validated_stamp);
+    }
+    bool const validated = not stamp.empty() and stamp == validated_stamp;
+
+    CComPtr<IXMLDOMSchemaCollection2> schemas;
+    if (not validated)
+    {
+        schemas = load_schemas(settings_xsd_);
+    }
+    Dom_Document const document{contents, schemas};
+    auto settings = std::make_shared<Settings const>(
+        settings_xml_, document, generation_ + 1
+    );
+
+    if (not validated and not stamp.empty())
+    {
+        // If this doesn't work, the file will just be validated again next
+        // time.
+        std::wofstream{validated_file_} << stamp << L'\n';
+    }
+    generation_ += 1;
+    loaded_stamp_ = stamp;
+    return settings;
+}
+
+std::wstring Settings_Watcher::get_stamp(std::string const &contents) const
+{
+    std::error_code size_error;
+    auto const xsd_size = std::filesystem::file_size(settings_xsd_, size_error);
+    std::error_code time_error;
+    auto const xsd_time =
+        std::filesystem::last_write_time(settings_xsd_, time_error);
+    if (size_error or time_error)
+    {
+        // If we can't tell whether the schema has changed, always validate.
+        return std::wstring{};
+    }
+    std::wostringstream stamp;
+    stamp << contents.size() << L' '
+          << Result_Cache::hash(contents) << L' ' << xsd_size
+          << L' ' << xsd_time.time_since_epoch().count();
+    return stamp.str();
+}
+
+}    // namespace Linter
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <exception>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <string>
+
+namespace Linter
+{
+
+class File_Watcher;
+class Settings;
+
+/** Keeps the settings up to date with the configuration file.
+ *
+ * The configuration directory is watched from a background thread, and when
+ * the file changes it is read into a new Settings, which replaces the current
+ * one. Anything still using the old settings can carry on doing so, and
+ * getting the settings never touches the file system, so linting doesn't
+ * have to wait for the file to be checked or read.
+ *
+ * Validating the file against the schema is the slowest part of reading it,
+ * so a note is kept on disk of the last file which was valid, and if neither
+ * it nor the schema has changed since, it isn't validated again, even after
+ * a restart.
+ *
+ * This can be used from several threads at once.
+ */
+class Settings_Watcher
+{
+  public:
+    /** The file is read straight away, and then watched for changes */
+    Settings_Watcher(
+        std::filesystem::path settings_xml, std::filesystem::path settings_xsd
+    );
+
+    Settings_Watcher(Settings_Watcher const &) = delete;
+    Settings_Watcher(Settings_Watcher &&) = delete;
+    Settings_Watcher &operator=(Settings_Watcher const &) = delete;
+    Settings_Watcher &operator=(Settings_Watcher &&) = delete;
+
+    ~Settings_Watcher();
+
+    /** Get the current settings.
+     *
+     * If the file couldn't be read, these are the last settings that could
+     * be.
+     */
+    std::shared_ptr<Settings const> settings() const noexcept;
+
+    /** Throw the error from the last attempt to read the file, if it failed */
+    void check() const;
+
+  private:
+    /** Read the file and replace the current settings */
+    void load() noexcept;
+
+    /** Read settings from the contents of the file.
+     *
+     * Returns nullptr if the contents are the same as last time.
+     */
+    std::shared_ptr<Settings const> read(std::string const &contents);
+
+    /** Describe the contents and the schema, so we can tell if either of
+     * them has changed since they were last validated
+     */
+    std::wstring get_stamp(std::string const &contents) const;
+
+    std::filesystem::path const settings_xml_;
+    std::filesystem::path const settings_xsd_;
+
+    // Contains the stamp of the last file which was valid
+    std::filesystem::path const validated_file_;
+
+    mutable std::mutex mutex_;
+
+    std::shared_ptr<Settings const> settings_;
+
+    // Why the file couldn't be read the last time we tried
+    std::exception_ptr error_;
+
+    // Stamp of the file the current settings were read from
+    std::wstring loaded_stamp_;
+
+    // Number of times the file has been read
+    unsigned int generation_{0};
+
+    // This is last, so it is stopped before anything it uses is destroyed.
+    std::unique_ptr<File_Watcher> watcher_;
+};
+
+}    // namespace Linter
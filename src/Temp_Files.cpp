@@ -0,0 +1,96 @@
+#include "Temp_Files.h"
+
+#include "Result_Cache.h"
+
+#include <cstdint>
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <system_error>
+#include <utility>
+
+namespace Linter
+{
+
+Temp_Files::Temp_Files(Writer writer) : writer_{std::move(writer)}
+{
+}
+
+Temp_Files::~Temp_Files()
+{
+    remove_all();
+}
+
+void Temp_Files::write(
+    std::filesystem::path const &path, std::string const &text
+)
+{
+    Written written{
+        .hash = Result_Cache::hash(text), .size = text.size(), .time = {}
+    };
+
+    std::scoped_lock const lock{mutex_};
+    if (auto const pos = written_.find(path); pos != written_.end())
+    {
+        if (pos->second.hash == written.hash
+            and pos->second.size == written.size
+            and unchanged(path, pos->second))
+        {
+            return;
+        }
+        written_.erase(pos);
+    }
+
+    writer_(path, text);
+
+    std::error_code errcode;
+    written.time = std::filesystem::last_write_time(path, errcode);
+    if (not errcode)
+    {
+        written_.emplace(path, written);
+    }
+}
+
+void Temp_Files::remove(std::filesystem::path const &path)
+{
+    std::scoped_lock const lock{mutex_};
+    if (not written_.contains(path))
+    {
+        return;
+    }
+    // If a linter still has it open, we'll have another go when we're
+    // shut down.
+    std::error_code errcode;
+    std::filesystem::remove(path, errcode);
+    if (not errcode)
+    {
+        written_.erase(path);
+    }
+}
+
+void Temp_Files::remove_all()
+{
+    std::scoped_lock const lock{mutex_};
+    for (auto const &file : written_)
+    {
+        std::error_code errcode;
+        std::filesystem::remove(file.first, errcode);
+    }
+    written_.clear();
+}
+
+bool Temp_Files::unchanged(
+    std::filesystem::path const &path, Written const &written
+) noexcept
+{
+    std::error_code errcode;
+    auto const size = std::filesystem::file_size(path, errcode);
+    if (errcode or size != written.size)
+    {
+        return false;
+    }
+    auto const time = std::filesystem::last_write_time(path, errcode);
+    return not errcode and time == written.time;
+}
+
+}    // namespace Linter
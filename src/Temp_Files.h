@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+
+namespace Linter
+{
+
+/** Keeps track of the temporary copies of buffers that linters read.
+ *
+ * Writing a large buffer (especially to a network share) can take longer
+ * than running the linter, so the copies are kept until the buffer is closed,
+ * and are only written again when the contents change.
+ *
+ * Creating the files is left to the caller, as they need to be hidden.
+ *
+ * This can be used from several threads at once.
+ */
+class Temp_Files
+{
+  public:
+    /** Creates a file containing the text, replacing any existing one */
+    using Writer = std::function<
+        void(std::filesystem::path const &, std::string const &text)>;
+
+    explicit Temp_Files(Writer writer);
+
+    Temp_Files(Temp_Files const &) = delete;
+    Temp_Files(Temp_Files &&) = delete;
+    Temp_Files &operator=(Temp_Files const &) = delete;
+    Temp_Files &operator=(Temp_Files &&) = delete;
+
+    ~Temp_Files();
+
+    /** Make sure the file contains the text, unless we've already written
+     * exactly that and nothing has changed it since.
+     */
+    void write(std::filesystem::path const &, std::string const &text);
+
+    /** Delete a file, when its buffer is closed */
+    void remove(std::filesystem::path const &);
+
+    /** Delete all the files */
+    void remove_all();
+
+  private:
+    struct Written
+    {
+        std::uint64_t hash;
+        std::uintmax_t size;
+        std::filesystem::file_time_type time;
+    };
+
+    /** Check if the file still contains what we wrote */
+    static bool unchanged(
+        std::filesystem::path const &, Written const &
+    ) noexcept;
+
+    Writer const writer_;
+
+    std::mutex mutex_;
+
+    std::map<std::filesystem::path, Written> written_;
+};
+
+}    // namespace Linter
@@ -0,0 +1,137 @@
+#include "Trace.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace Linter
+{
+
+namespace
+{
+
+// Enough for a few hundred lints.
+constexpr std::size_t Capacity = 4096;
+
+/** An entry in the ring buffer.
+ *
+ * The sequence number is the index of the event plus 1, and is 0 while the
+ * event is being written, so that a reader can tell if the event was
+ * overwritten while it was being read.
+ */
+struct Slot
+{
+    std::atomic<std::uint64_t> sequence;
+    std::atomic<char const *> name;
+    std::atomic<std::uint32_t> thread;
+    std::atomic<std::int64_t> start;
+    std::atomic<std::int64_t> duration;
+};
+
+std::array<Slot, Capacity> slots;
+
+// Index of the next event to be written
+std::atomic<std::uint64_t> next_event;
+
+// Used to give each thread a small number
+std::atomic<std::uint32_t> next_thread;
+
+std::uint32_t thread_number() noexcept
+{
+    thread_local std::uint32_t const number =
+        next_thread.fetch_add(1, std::memory_order_relaxed) + 1;
+    return number;
+}
+
+}    // namespace
+
+std::vector<Trace::Event> Trace::events()
+{
+    std::vector<Event> events;
+    auto const end = next_event.load(std::memory_order_acquire);
+    auto const begin = end > Capacity ? end - Capacity : 0;
+    events.reserve(static_cast<std::size_t>(end - begin));
+    for (auto index = begin; index != end; index += 1)
+    {
+        auto const &slot = slots[index % Capacity];
+        auto const sequence = slot.sequence.load(std::memory_order_acquire);
+        if (sequence != index + 1)
+        {
+            // Still being written, or already overwritten.
+            continue;
+        }
+        Event const event{
+            .name = slot.name.load(std::memory_order_relaxed),
+            .thread = slot.thread.load(std::memory_order_relaxed),
+            .start = slot.start.load(std::memory_order_relaxed),
+            .duration = slot.duration.load(std::memory_order_relaxed)
+        };
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slot.sequence.load(std::memory_order_relaxed) == sequence)
+        {
+            events.push_back(event);
+        }
+    }
+    std::ranges::sort(
+        events,
+        [](Event const &lhs, Event const &rhs) noexcept
+        {
+            // A span which contains another ends after it, so it comes first
+            // if they start at the same time.
+            if (lhs.start != rhs.start)
+            {
+                return lhs.start < rhs.start;
+            }
+            return lhs.duration > rhs.duration;
+        }
+    );
+    return events;
+}
+
+std::string Trace::to_json()
+{
+    // The names are all string literals in this program, so they don't need
+    // escaping.
+    std::string json{"{\"traceEvents\":["};
+    bool first = true;
+    for (auto const &event : events())
+    {
+        if (not first)
+        {
+            json += ',';
+        }
+        first = false;
+        json += "\n{\"name\":\"";
+        json += event.name;
+        json += "\",\"cat\":\"lint\",\"ph\":\"X\",\"pid\":1,\"tid\":";
+        json += std::to_string(event.thread);
+        json += ",\"ts\":";
+        json += std::to_string(event.start);
+        json += ",\"dur\":";
+        json += std::to_string(event.duration);
+        json += '}';
+    }
+    json += "\n],\"displayTimeUnit\":\"ms\"}\n";
+    return json;
+}
+
+void Trace::record(
+    char const *name, std::int64_t start, std::int64_t duration
+) noexcept
+{
+    auto const index = next_event.fetch_add(1, std::memory_order_relaxed);
+    auto &slot = slots[index % Capacity];
+    slot.sequence.store(0, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    slot.name.store(name, std::memory_order_relaxed);
+    slot.thread.store(thread_number(), std::memory_order_relaxed);
+    slot.start.store(start, std::memory_order_relaxed);
+    slot.duration.store(duration, std::memory_order_relaxed);
+    slot.sequence.store(index + 1, std::memory_order_release);
+}
+
+}    // namespace Linter
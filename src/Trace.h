@@ -0,0 +1,107 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace Linter
+{
+
+/** Records how long each part of a lint takes, so that it's possible to find
+ * out where the time goes when linting is slow.
+ *
+ * Code to be timed is wrapped in a Span. When tracing is on, each Span adds
+ * an event to a fixed size ring buffer when it ends, overwriting the oldest
+ * event once the buffer is full. Adding an event doesn't take a lock, so
+ * tracing the linter threads doesn't make them wait for each other. When
+ * tracing is off, a Span just checks a flag.
+ *
+ * The events can be exported in the Chrome trace event format, which can be
+ * loaded into chrome://tracing or https://ui.perfetto.dev.
+ */
+class Trace
+{
+  public:
+    /** A completed span */
+    struct Event
+    {
+        /** What was being done */
+        char const *name;
+        /** Small number identifying the thread */
+        std::uint32_t thread;
+        /** Microseconds since an arbitrary point */
+        std::int64_t start;
+        /** Microseconds */
+        std::int64_t duration;
+    };
+
+    /** Times from construction to destruction.
+     *
+     * The name must be a string literal (or otherwise last for the life of
+     * the program).
+     */
+    class Span
+    {
+      public:
+        explicit Span(char const *name) noexcept :
+            name_(name),
+            start_(enabled() ? now() : Not_Tracing)
+        {
+        }
+
+        Span(Span const &) = delete;
+        Span(Span &&) = delete;
+        Span &operator=(Span const &) = delete;
+        Span &operator=(Span &&) = delete;
+
+        ~Span()
+        {
+            if (start_ != Not_Tracing)
+            {
+                record(name_, start_, now() - start_);
+            }
+        }
+
+      private:
+        static constexpr std::int64_t Not_Tracing = -1;
+
+        char const *name_;
+        std::int64_t start_;
+    };
+
+    /** Switch tracing on or off. Existing events are kept */
+    static void enable(bool enable) noexcept
+    {
+        enabled_.store(enable, std::memory_order_relaxed);
+    }
+
+    static bool enabled() noexcept
+    {
+        return enabled_.load(std::memory_order_relaxed);
+    }
+
+    /** Get the events in the buffer, in the order they started */
+    static std::vector<Event> events();
+
+    /** Get the events in the buffer as Chrome trace event JSON */
+    static std::string to_json();
+
+  private:
+    static std::int64_t now() noexcept
+    {
+        return std::chrono::duration_cast<std::chrono::microseconds>(
+                   std::chrono::steady_clock::now().time_since_epoch()
+        )
+            .count();
+    }
+
+    static void record(
+        char const *name, std::int64_t start, std::int64_t duration
+    ) noexcept;
+
+    static inline std::atomic<bool> enabled_{false};
+};
+
+}    // namespace Linter
@@ -0,0 +1,81 @@
+#include "Variable_Cache.h"
+
+#include <chrono>
+#include <filesystem>
+#include <mutex>
+#include <optional>
+#include <string>
+
+namespace Linter
+{
+
+Variable_Cache::~Variable_Cache() = default;
+
+std::optional<std::string> Variable_Cache::find(
+    std::wstring const &name, std::wstring const &command_line,
+    Policy const &policy, std::filesystem::path const &directory
+)
+{
+    if (policy.mode == Policy::Mode::None)
+    {
+        return std::nullopt;
+    }
+
+    std::scoped_lock const lock{mutex_};
+    auto const entry = entries_.find(
+        make_key(name, command_line, policy, directory)
+    );
+    if (entry == entries_.end()
+        || (policy.mode == Policy::Mode::Timed
+            && Clock::now() >= entry->second.expires))
+    {
+        misses_ += 1;
+        return std::nullopt;
+    }
+    hits_ += 1;
+    return entry->second.value;
+}
+
+void Variable_Cache::store(
+    std::wstring const &name, std::wstring const &command_line,
+    Policy const &policy, std::filesystem::path const &directory,
+    std::string const &value
+)
+{
+    if (policy.mode == Policy::Mode::None)
+    {
+        return;
+    }
+
+    std::scoped_lock const lock{mutex_};
+    entries_.insert_or_assign(
+        make_key(name, command_line, policy, directory),
+        Entry{.value = value, .expires = Clock::now() + policy.lifetime}
+    );
+}
+
+void Variable_Cache::clear()
+{
+    std::scoped_lock const lock{mutex_};
+    entries_.clear();
+}
+
+Variable_Cache::Statistics Variable_Cache::statistics() const
+{
+    std::scoped_lock const lock{mutex_};
+    return {.hits = hits_, .misses = misses_};
+}
+
+Variable_Cache::Key Variable_Cache::make_key(
+    std::wstring const &name, std::wstring const &command_line,
+    Policy const &policy, std::filesystem::path const &directory
+)
+{
+    if (policy.mode == Policy::Mode::Directory)
+    {
+        return {name, command_line, directory.wstring()};
+    }
+    return {name, command_line, std::wstring{}};
+}
+
+}    // namespace Linter
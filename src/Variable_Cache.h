@@ -0,0 +1,106 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <filesystem>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <tuple>
+
+namespace Linter
+{
+
+/** Caches the output of <variable> commands.
+ *
+ * Each variable can be cached for the whole session, per directory of the
+ * file being linted, or for a fixed time. Everything is discarded when the
+ * settings are reloaded.
+ *
+ * Values are also keyed on the command line after variables have been
+ * expanded, so a command which uses %TARGET% or an earlier variable is rerun
+ * if that changes.
+ *
+ * This can be used from several threads at once.
+ */
+class Variable_Cache
+{
+  public:
+    /** How long a variable value is kept */
+    struct Policy
+    {
+        enum class Mode
+        {
+            None,         // Run the command every time
+            Session,      // Run the command once
+            Directory,    // Run the command once per target directory
+            Timed         // Rerun the command after 'lifetime'
+        };
+
+        Mode mode{Mode::None};
+        std::chrono::seconds lifetime{0};
+    };
+
+    struct Statistics
+    {
+        std::size_t hits;
+        std::size_t misses;
+    };
+
+    Variable_Cache() = default;
+
+    Variable_Cache(Variable_Cache const &) = delete;
+    Variable_Cache(Variable_Cache &&) = delete;
+    Variable_Cache &operator=(Variable_Cache const &) = delete;
+    Variable_Cache &operator=(Variable_Cache &&) = delete;
+
+    ~Variable_Cache();
+
+    /** Get the cached value of a variable, if there is one */
+    std::optional<std::string> find(
+        std::wstring const &name, std::wstring const &command_line,
+        Policy const &, std::filesystem::path const &directory
+    );
+
+    /** Save the value of a variable */
+    void store(
+        std::wstring const &name, std::wstring const &command_line,
+        Policy const &, std::filesystem::path const &directory,
+        std::string const &value
+    );
+
+    /** Throw everything away */
+    void clear();
+
+    /** Get the number of cache hits and misses */
+    Statistics statistics() const;
+
+  private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Entry
+    {
+        std::string value;
+        Clock::time_point expires;
+    };
+
+    // Key is variable name, command line and (for Directory mode) target
+    // directory
+    using Key = std::tuple<std::wstring, std::wstring, std::wstring>;
+
+    static Key make_key(
+        std::wstring const &name, std::wstring const &command_line,
+        Policy const &, std::filesystem::path const &directory
+    );
+
+    mutable std::mutex mutex_;
+
+    std::map<Key, Entry> entries_;
+
+    std::size_t hits_{0};
+
+    std::size_t misses_{0};
+};
+
+}    // namespace Linter
@@ -0,0 +1,16 @@
+#include "Whitespace.h"
+
+#include <regex>
+#include <string>
+
+namespace Linter::Whitespace
+{
+
+std::wstring collapse(std::wstring const &text)
+{
+    auto const trimmed =
+        std::regex_replace(text, std::wregex(LR"((^\s+)|(\s+$))"), L"");
+    return std::regex_replace(trimmed, std::wregex(LR"(\s+)"), L" ");
+}
+
+}    // namespace Linter::Whitespace
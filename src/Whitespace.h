@@ -0,0 +1,13 @@
+#pragma once
+
+#include <string>
+
+namespace Linter::Whitespace
+{
+
+/** Remove leading and trailing whitespace, and replace all other runs of
+ * whitespace with a single space, as for an xs:token value.
+ */
+std::wstring collapse(std::wstring const &text);
+
+}    // namespace Linter::Whitespace
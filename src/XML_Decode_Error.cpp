@@ -12,6 +12,7 @@
 #include <ios>
 #include <memory>
 #include <sstream>
+#include <string>
 #include <utility>    // for std::ignore
 
 namespace Linter
@@ -59,6 +60,23 @@ XML_Decode_Error::XML_Decode_Error(IXMLDOMParseError &error)
     );
 }
 
+// NOLINTNEXTLINE(*-member-init)
+XML_Decode_Error::XML_Decode_Error(
+    std::string const &reason, long line, long column
+) :
+    line_(line),
+    column_(column)
+{
+    std::ignore = std::snprintf(
+        &what_string_[0],
+        sizeof(what_string_),
+        "Invalid xml in linter output at line %ld col %ld: %s",
+        line_,
+        column_,
+        reason.c_str()
+    );
+}
+
 XML_Decode_Error::XML_Decode_Error(XML_Decode_Error const &) noexcept = default;
 
 XML_Decode_Error::XML_Decode_Error(XML_Decode_Error &&) noexcept = default;
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <exception>
+#include <string>
 
 // clang-tidy is being silly here
 // NOLINTNEXTLINE(cppcoreguidelines-virtual-class-destructor)
@@ -14,6 +15,9 @@ class XML_Decode_Error : public std::exception
   public:
     explicit XML_Decode_Error(IXMLDOMParseError &);
 
+    /** Error detected in linter output */
+    XML_Decode_Error(std::string const &reason, long line, long column);
+
     XML_Decode_Error(XML_Decode_Error const &) noexcept;
     XML_Decode_Error(XML_Decode_Error &&) noexcept;
     XML_Decode_Error &operator=(XML_Decode_Error const &) noexcept;
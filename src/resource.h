@@ -15,6 +15,7 @@
 #define IDC_ABOUT_AUTHOR                1008
 #define IDC_ABOUT_HOMEPAGE_TEXT         1009
 #define IDC_ABOUT_HOMEPAGE_LINK         1010
+#define IDC_LIST_STATISTICS             1011
 
 // Next default values for new objects
 // 
@@ -22,7 +23,7 @@
 #ifndef APSTUDIO_READONLY_SYMBOLS
 #define _APS_NEXT_RESOURCE_VALUE        108
 #define _APS_NEXT_COMMAND_VALUE         40001
-#define _APS_NEXT_CONTROL_VALUE         1011
+#define _APS_NEXT_CONTROL_VALUE         1012
 #define _APS_NEXT_SYMED_VALUE           101
 #endif
 #endif
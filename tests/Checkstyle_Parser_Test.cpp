@@ -0,0 +1,258 @@
+#include "Checkstyle_Parser.h"
+
+#include "Error_Info.h"
+#include "XML_Decode_Error.h"
+
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <string>
+#include <tuple>
+#include <vector>
+
+namespace Linter
+{
+
+namespace
+{
+
+struct Expected_Error
+{
+    std::wstring message;
+    std::wstring severity;
+    std::wstring tool;
+    int line;
+    int column;
+};
+
+void expect_errors(
+    std::string const &output, std::vector<Expected_Error> const &expected
+)
+{
+    auto const errors = Checkstyle_Parser::get_errors(output);
+    ASSERT_EQ(errors.size(), expected.size());
+    for (std::size_t error = 0; error < errors.size(); error += 1)
+    {
+        SCOPED_TRACE(error);
+        EXPECT_EQ(errors[error].message_, expected[error].message);
+        EXPECT_EQ(errors[error].severity_, expected[error].severity);
+        EXPECT_EQ(errors[error].tool_, expected[error].tool);
+        EXPECT_EQ(errors[error].mode_, Error_Info::Standard);
+        EXPECT_EQ(errors[error].line_, expected[error].line);
+        EXPECT_EQ(errors[error].column_, expected[error].column);
+    }
+}
+
+/** Check the output is rejected, and the error is reported at the right
+ * place.
+ */
+void expect_failure(std::string const &output, long line, long column)
+{
+    try
+    {
+        std::ignore = Checkstyle_Parser::get_errors(output);
+        ADD_FAILURE() << "No exception for " << output;
+    }
+    catch (XML_Decode_Error const &error)
+    {
+        EXPECT_EQ(error.line(), line) << error.what();
+        EXPECT_EQ(error.column(), column) << error.what();
+    }
+}
+
+// Output from real linters
+
+TEST(Checkstyle_Parser_Test, Reads_Jshint_Output)
+{
+    expect_errors(
+        "<?xml version=\"1.0\" encoding=\"utf-8\"?>\n"
+        "<checkstyle version=\"4.3\">\n"
+        "\t<file name=\"test.js\">\n"
+        "\t\t<error line=\"58\" column=\"81\" severity=\"warning\" "
+        "message=\"Line is too long. (W101)\" source=\"jshint.W101\" />\n"
+        "\t\t<error line=\"60\" column=\"3\" severity=\"error\" "
+        "message=\"Missing &quot;use strict&quot; statement. (E007)\" "
+        "source=\"jshint.E007\" />\n"
+        "\t</file>\n"
+        "</checkstyle>\n",
+        {
+            {L"Line is too long. (W101)", L"warning", L"jshint", 58, 81},
+            {L"Missing \"use strict\" statement. (E007)",
+             L"error", L"jshint", 60, 3}
+        }
+    );
+}
+
+TEST(Checkstyle_Parser_Test, Reads_Eslint_Output)
+{
+    expect_errors(
+        "<?xml version=\"1.0\" encoding=\"utf-8\"?><checkstyle version=\"4.3\">"
+        "<file name=\"C:\\test.js\"><error line=\"83\" column=\"1\" "
+        "severity=\"warning\" message=\"Sentences should start with an "
+        "uppercase character. (jsdoc/require-description-complete-sentence)"
+        "\" source=\"eslint.rules.jsdoc/require-description-complete-sentence"
+        "\" /></file></checkstyle>",
+        {
+            {L"Sentences should start with an uppercase character. "
+             L"(jsdoc/require-description-complete-sentence)",
+             L"warning", L"eslint", 83, 1}
+        }
+    );
+}
+
+TEST(Checkstyle_Parser_Test, Reads_Output_With_No_Errors)
+{
+    expect_errors("<checkstyle version=\"4.3\"></checkstyle>", {});
+    expect_errors("<checkstyle/>", {});
+}
+
+// Things that are allowed in xml
+
+TEST(Checkstyle_Parser_Test, Decodes_Entities)
+{
+    expect_errors(
+        "<checkstyle><error line='1' column='2' severity='error' "
+        "message='&lt;a&gt; &amp; &apos;b&apos; &#65;&#x42; &#xE9; &#x20AC; "
+        "&#x1F600;' source='x'/></checkstyle>",
+        {
+            {L"<a> & 'b' AB \u00E9 \u20AC \U0001F600", L"error", L"x", 1, 2}
+        }
+    );
+}
+
+TEST(Checkstyle_Parser_Test, Reads_UTF8_Messages)
+{
+    expect_errors(
+        "<checkstyle><error line='1' column='2' severity='error' "
+        "message='caf\xC3\xA9 \xF0\x9F\x98\x80' source='x'/></checkstyle>",
+        {
+            {L"caf\u00E9 \U0001F600", L"error", L"x", 1, 2}
+        }
+    );
+}
+
+TEST(Checkstyle_Parser_Test, Normalises_Whitespace_In_Attributes)
+{
+    expect_errors(
+        "<checkstyle><error line='1' column='2' severity='error' "
+        "message='one\r\ntwo\nthree\tfour' source='x'/></checkstyle>",
+        {
+            {L"one two three four", L"error", L"x", 1, 2}
+        }
+    );
+}
+
+TEST(Checkstyle_Parser_Test, Skips_Prolog_Comments_And_CDATA)
+{
+    expect_errors(
+        "\xEF\xBB\xBF<?xml version=\"1.0\"?>\n"
+        "<!DOCTYPE checkstyle [ <!ELEMENT checkstyle ANY> ]>\n"
+        "<!-- <error line='9' column='9'/> -->\n"
+        "<checkstyle>\n"
+        "<![CDATA[ <error line='9' column='9'/> ]]>\n"
+        "<file name='a &amp; b'>text &#65;"
+        "<error column = \"5\"\n line=\"4\" severity='info' message='m' "
+        "source='tool'></error>"
+        "</file>\n"
+        "</checkstyle>\n"
+        "<!-- trailing comment -->\n",
+        {
+            {L"m", L"info", L"tool", 4, 5}
+        }
+    );
+}
+
+TEST(Checkstyle_Parser_Test, Finds_Errors_At_Any_Depth)
+{
+    expect_errors(
+        "<results><checkstyle><file><error line='1' column='1' severity='a' "
+        "message='b' source='c'/></file></checkstyle><error line='2' "
+        "column='2' severity='d' message='e' source='f'/></results>",
+        {
+            {L"b", L"a", L"c", 1, 1},
+            {L"e", L"d", L"f", 2, 2}
+        }
+    );
+}
+
+TEST(Checkstyle_Parser_Test, Reports_Errors_As_They_Are_Found)
+{
+    std::vector<int> lines;
+    Checkstyle_Parser::get_errors(
+        "<checkstyle><error line='3' column='1'/><error line='1' column='1'/>"
+        "</checkstyle>",
+        [&lines](Error_Info &&error) { lines.push_back(error.line_); }
+    );
+    EXPECT_EQ(lines, (std::vector<int>{3, 1}));
+}
+
+// Things that aren't
+
+TEST(Checkstyle_Parser_Test, Rejects_Missing_Line_Or_Column)
+{
+    expect_failure("<checkstyle>\n  <error column='1'/></checkstyle>", 2, 3);
+    expect_failure("<checkstyle>\n  <error line='1'/></checkstyle>", 2, 3);
+}
+
+TEST(Checkstyle_Parser_Test, Rejects_Invalid_Numbers)
+{
+    expect_failure(
+        "<checkstyle><error line='' column='1'/></checkstyle>", 1, 26
+    );
+    expect_failure(
+        "<checkstyle><error line='1' column='x1'/></checkstyle>", 1, 37
+    );
+    expect_failure(
+        "<checkstyle><error line='1' column='1x'/></checkstyle>", 1, 37
+    );
+    expect_failure(
+        "<checkstyle><error line='99999999999' column='1'/></checkstyle>",
+        1,
+        26
+    );
+}
+
+TEST(Checkstyle_Parser_Test, Rejects_Badly_Formed_Output)
+{
+    // Not xml at all
+    expect_failure("Error: linter crashed", 1, 1);
+    expect_failure("", 1, 1);
+    expect_failure("<?xml version=\"1.0\"?>", 1, 22);
+
+    // Structure
+    expect_failure("<a></b>", 1, 4);
+    expect_failure("<a>", 1, 4);
+    expect_failure("</a>", 1, 1);
+    expect_failure("<a/><b/>", 1, 5);
+    expect_failure("<a/>text", 1, 5);
+    expect_failure("<a><!-- unterminated </a>", 1, 4);
+    expect_failure("<a><![CDATA[ unterminated </a>", 1, 4);
+    expect_failure("<a/><!DOCTYPE a>", 1, 5);
+
+    // Tags and attributes
+    expect_failure("<1a/>", 1, 2);
+    expect_failure("<a b='1'c='2'/>", 1, 9);
+    expect_failure("<a b/>", 1, 5);
+    expect_failure("<a b=1/>", 1, 6);
+    expect_failure("<a b='1/>", 1, 7);
+    expect_failure("<a b='1' b='2'/>", 1, 13);
+    expect_failure("<a b='<'/>", 1, 7);
+
+    // References
+    expect_failure("<a>&bogus;</a>", 1, 4);
+    expect_failure("<a>&amp</a>", 1, 4);
+    expect_failure("<a>&#0;</a>", 1, 4);
+    expect_failure("<a>&#xD800;</a>", 1, 4);
+    expect_failure("<a>&#x110000;</a>", 1, 4);
+    expect_failure("<a><error line='1' column='1' message='&#;'/></a>", 1, 40);
+}
+
+TEST(Checkstyle_Parser_Test, Reports_Error_Position_In_Characters)
+{
+    // The column counts characters, not bytes
+    expect_failure("<a>\n\xC3\xA9\xE2\x82\xAC</b>", 2, 3);
+}
+
+}    // namespace
+
+}    // namespace Linter
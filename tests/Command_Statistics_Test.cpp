@@ -0,0 +1,113 @@
+#include "Command_Statistics.h"
+
+#include <gtest/gtest.h>
+
+#include <string>
+
+namespace Linter
+{
+
+namespace
+{
+
+using Duration = Command_Statistics::Duration;
+
+Command_Statistics::Run run_taking(int milliseconds)
+{
+    return Command_Statistics::Run{
+        .time = Duration{milliseconds},
+        .stdout_bytes = 100,
+        .stderr_bytes = 0,
+        .errors = 2,
+        .failed = false
+    };
+}
+
+TEST(Command_Statistics_Test, Estimates_Percentiles_Of_Spread_Out_Times)
+{
+    Command_Statistics statistics;
+    for (int time = 10; time <= 1000; time += 1)
+    {
+        statistics.ran(L"linter", run_taking(time));
+    }
+
+    auto const summaries = statistics.summaries();
+    ASSERT_EQ(summaries.size(), 1U);
+    auto const &summary = summaries[0];
+    EXPECT_EQ(summary.runs, 991U);
+    EXPECT_NEAR(static_cast<double>(summary.median.count()), 505.0, 2.0);
+    EXPECT_NEAR(static_cast<double>(summary.percentile_95.count()), 950.0, 2.0);
+    EXPECT_EQ(summary.max, Duration{1000});
+}
+
+TEST(Command_Statistics_Test, Short_Times_Are_Exact)
+{
+    Command_Statistics statistics;
+    for (int const time : {1, 2, 2, 3, 7})
+    {
+        statistics.ran(L"linter", run_taking(time));
+    }
+
+    auto const summary = statistics.summaries()[0];
+    EXPECT_EQ(summary.median, Duration{2});
+    EXPECT_EQ(summary.percentile_95, Duration{7});
+}
+
+TEST(Command_Statistics_Test, Estimates_Are_No_Longer_Than_The_Slowest_Run)
+{
+    Command_Statistics statistics;
+    statistics.ran(L"linter", run_taking(700));
+
+    auto const summary = statistics.summaries()[0];
+    EXPECT_EQ(summary.median, Duration{700});
+    EXPECT_EQ(summary.percentile_95, Duration{700});
+}
+
+TEST(Command_Statistics_Test, Counts_Each_Command_Separately)
+{
+    Command_Statistics statistics;
+    statistics.ran(L"first", run_taking(10));
+    auto failed = run_taking(20);
+    failed.stderr_bytes = 50;
+    failed.failed = true;
+    statistics.ran(L"first", failed);
+    statistics.cache_hit(L"first");
+    statistics.cancelled(L"first");
+    statistics.cache_hit(L"second");
+
+    auto const summaries = statistics.summaries();
+    ASSERT_EQ(summaries.size(), 2U);
+    auto const &first = summaries[0];
+    EXPECT_EQ(first.command, L"first");
+    EXPECT_EQ(first.runs, 2U);
+    EXPECT_EQ(first.stdout_bytes, 200U);
+    EXPECT_EQ(first.stderr_bytes, 50U);
+    EXPECT_EQ(first.errors, 4U);
+    EXPECT_EQ(first.failures, 1U);
+    EXPECT_EQ(first.cache_hits, 1U);
+    EXPECT_EQ(first.cancelled, 1U);
+    EXPECT_DOUBLE_EQ(first.cache_hit_rate(), 1.0 / 3.0);
+
+    auto const &second = summaries[1];
+    EXPECT_EQ(second.command, L"second");
+    EXPECT_EQ(second.runs, 0U);
+    EXPECT_EQ(second.median, Duration{0});
+    EXPECT_DOUBLE_EQ(second.cache_hit_rate(), 1.0);
+}
+
+TEST(Command_Statistics_Test, Exports_Csv)
+{
+    Command_Statistics statistics;
+    statistics.ran(L"lint \"file\"", run_taking(5));
+
+    EXPECT_EQ(
+        statistics.to_csv(),
+        "Command,Runs,Median ms,95th percentile ms,Max ms,Stdout bytes,"
+        "Stderr bytes,Errors,Failures,Cache hits,Cache hit rate,Cancelled\r\n"
+        "\"lint \"\"file\"\"\",1,5,5,5,100,0,2,0,0,0.000000,0\r\n"
+    );
+}
+
+}    // namespace
+
+}    // namespace Linter
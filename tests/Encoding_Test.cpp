@@ -0,0 +1,382 @@
+#include "Encoding.h"
+
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <string_view>
+
+namespace Linter
+{
+
+namespace
+{
+
+constexpr char32_t Replacement = 0xFFFD;
+
+std::u32string replaced(std::size_t count)
+{
+    return std::u32string(count, Replacement);
+}
+
+/** Convert code points to a wide string the way Windows would, so the
+ * expected values are right whatever size wchar_t is.
+ */
+std::wstring to_wide(std::u32string const &codes)
+{
+    std::wstring wide;
+    for (auto code : codes)
+    {
+        if (sizeof(wchar_t) == 2 and code >= 0x10000)
+        {
+            code -= 0x10000;
+            wide += static_cast<wchar_t>(0xD800 + (code >> 10));
+            wide += static_cast<wchar_t>(0xDC00 + (code & 0x3FF));
+        }
+        else
+        {
+            wide += static_cast<wchar_t>(code);
+        }
+    }
+    return wide;
+}
+
+/** Straightforward UTF-8 encoder to compare against */
+std::string reference_encode(std::u32string const &codes)
+{
+    std::string utf8;
+    for (auto const code : codes)
+    {
+        if (code < 0x80)
+        {
+            utf8 += static_cast<char>(code);
+        }
+        else if (code < 0x800)
+        {
+            utf8 += static_cast<char>(0xC0 | (code >> 6));
+            utf8 += static_cast<char>(0x80 | (code & 0x3F));
+        }
+        else if (code < 0x10000)
+        {
+            utf8 += static_cast<char>(0xE0 | (code >> 12));
+            utf8 += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+            utf8 += static_cast<char>(0x80 | (code & 0x3F));
+        }
+        else
+        {
+            utf8 += static_cast<char>(0xF0 | (code >> 18));
+            utf8 += static_cast<char>(0x80 | ((code >> 12) & 0x3F));
+            utf8 += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+            utf8 += static_cast<char>(0x80 | (code & 0x3F));
+        }
+    }
+    return utf8;
+}
+
+/** Straightforward UTF-8 decoder to compare against.
+ *
+ * This tries each possible sequence length and checks the result decodes to
+ * a code point which needs exactly that length and isn't a surrogate, which
+ * is the definition of well formed UTF-8, rather than using the table of
+ * valid byte ranges. Anything else replaces one byte with U+FFFD.
+ */
+std::u32string reference_decode(std::string_view utf8)
+{
+    std::u32string codes;
+    std::size_t pos = 0;
+    while (pos < utf8.size())
+    {
+        auto const byte = [&](std::size_t offset)
+        { return static_cast<unsigned char>(utf8[pos + offset]); };
+
+        if (byte(0) < 0x80)
+        {
+            codes += byte(0);
+            pos += 1;
+            continue;
+        }
+
+        std::size_t length = 0;
+        char32_t code = 0;
+        if ((byte(0) & 0xE0) == 0xC0)
+        {
+            length = 2;
+            code = byte(0) & 0x1F;
+        }
+        else if ((byte(0) & 0xF0) == 0xE0)
+        {
+            length = 3;
+            code = byte(0) & 0x0F;
+        }
+        else if ((byte(0) & 0xF8) == 0xF0)
+        {
+            length = 4;
+            code = byte(0) & 0x07;
+        }
+
+        bool valid = length != 0 and pos + length <= utf8.size();
+        for (std::size_t offset = 1; valid and offset < length; ++offset)
+        {
+            valid = (byte(offset) & 0xC0) == 0x80;
+            code = (code << 6) | (byte(offset) & 0x3F);
+        }
+        if (valid)
+        {
+            std::size_t const shortest = code < 0x80    ? 1
+                                       : code < 0x800   ? 2
+                                       : code < 0x10000 ? 3
+                                                        : 4;
+            valid = shortest == length and code <= 0x10FFFF
+                and (code < 0xD800 or code > 0xDFFF);
+        }
+
+        if (valid)
+        {
+            codes += code;
+            pos += length;
+        }
+        else
+        {
+            codes += Replacement;
+            pos += 1;
+        }
+    }
+    return codes;
+}
+
+/** Random strings which are mostly the interesting bytes */
+std::string random_utf8ish(std::mt19937 &random, std::size_t length)
+{
+    // ASCII, continuation bytes, and each kind of lead byte, including
+    // ones which are never valid.
+    static constexpr unsigned char Bytes[] = {
+        'a',  ' ',  '\n', 0x7F, 0x80, 0x8F, 0x90, 0x9F, 0xA0, 0xBF,
+        0xC0, 0xC1, 0xC2, 0xDF, 0xE0, 0xED, 0xEE, 0xEF, 0xF0, 0xF4,
+        0xF5, 0xF8, 0xFE, 0xFF
+    };
+    std::uniform_int_distribution<std::size_t> pick{0, std::size(Bytes) - 1};
+    std::uniform_int_distribution<int> any_byte{0, 255};
+    std::bernoulli_distribution ascii_run{0.1};
+
+    std::string result;
+    while (result.size() < length)
+    {
+        if (ascii_run(random))
+        {
+            // Long enough to use the vectorised paths
+            result.append(17, 'x');
+        }
+        else if (random() % 4 == 0)
+        {
+            result += static_cast<char>(any_byte(random));
+        }
+        else
+        {
+            result += static_cast<char>(Bytes[pick(random)]);
+        }
+    }
+    return result;
+}
+
+/** Random valid code points, mostly ASCII so the vectorised paths are used */
+std::u32string random_code_points(std::mt19937 &random, std::size_t length)
+{
+    std::uniform_int_distribution<std::uint32_t> plane{0, 0x10FFFF};
+    std::uniform_int_distribution<std::uint32_t> bmp{0x80, 0xFFFF};
+    std::uniform_int_distribution<std::uint32_t> ascii{0, 0x7F};
+    std::uniform_int_distribution<int> kind{0, 9};
+
+    std::u32string codes;
+    while (codes.size() < length)
+    {
+        auto const choice = kind(random);
+        auto code = choice < 6 ? ascii(random)
+                  : choice < 8 ? bmp(random)
+                               : plane(random);
+        if (code >= 0xD800 and code <= 0xDFFF)
+        {
+            continue;
+        }
+        codes += static_cast<char32_t>(code);
+    }
+    return codes;
+}
+
+TEST(Encoding_Test, Converts_Each_Length_Of_Sequence)
+{
+    std::u32string const codes{
+        U'a', 0x7F, 0x80, 0xE9, 0x7FF, 0x800, 0x20AC, 0xD7FF, 0xE000, 0xFFFD,
+        0xFFFF, 0x10000, 0x1F600, 0x10FFFF
+    };
+    auto const utf8 = reference_encode(codes);
+    EXPECT_EQ(Encoding::convert(utf8), to_wide(codes));
+    EXPECT_EQ(Encoding::convert(to_wide(codes)), utf8);
+}
+
+TEST(Encoding_Test, Converts_Empty_Strings)
+{
+    EXPECT_EQ(Encoding::convert(std::string_view{}), L"");
+    EXPECT_EQ(Encoding::convert(std::wstring{}), "");
+}
+
+TEST(Encoding_Test, Replaces_Invalid_UTF8)
+{
+    struct Case
+    {
+        std::string_view utf8;
+        std::u32string expected;
+    };
+    Case const cases[] = {
+        // Lone continuation bytes
+        {"\x80", {Replacement}},
+        {"a\xBFz", {U'a', Replacement, U'z'}},
+
+        // Overlong encodings
+        {"\xC0\x80", replaced(2)},
+        {"\xC1\xBF", replaced(2)},
+        {"\xE0\x80\x80", replaced(3)},
+        {"\xE0\x9F\xBF", replaced(3)},
+        {"\xF0\x80\x80\x80", replaced(4)},
+        {"\xF0\x8F\xBF\xBF", replaced(4)},
+
+        // Surrogates
+        {"\xED\xA0\x80", replaced(3)},
+        {"\xED\xBF\xBF", replaced(3)},
+        {"\xED\xA0\xBD\xED\xB8\x80", replaced(6)},
+
+        // Past U+10FFFF
+        {"\xF4\x90\x80\x80", replaced(4)},
+        {"\xF5\x80\x80\x80", replaced(4)},
+        {"\xFF", replaced(1)},
+
+        // Truncated sequences
+        {"\xC3", replaced(1)},
+        {"\xE2\x82", replaced(2)},
+        {"\xF0\x9F\x98", replaced(3)},
+        {"\xE2\x82z", replaced(2) + U'z'},
+    };
+    for (auto const &test : cases)
+    {
+        SCOPED_TRACE(testing::PrintToString(std::string(test.utf8)));
+        EXPECT_EQ(Encoding::convert(test.utf8), to_wide(test.expected));
+        EXPECT_EQ(reference_decode(test.utf8), test.expected);
+    }
+}
+
+TEST(Encoding_Test, Replaces_Unpaired_Surrogates)
+{
+    auto const pair_high = static_cast<wchar_t>(0xD83D);
+    auto const pair_low = static_cast<wchar_t>(0xDE00);
+    std::string const replacement = reference_encode({Replacement});
+    std::string const emoji = reference_encode({0x1F600});
+
+    EXPECT_EQ(Encoding::convert(std::wstring{pair_high, pair_low}), emoji);
+    EXPECT_EQ(Encoding::convert(std::wstring{pair_high}), replacement);
+    EXPECT_EQ(Encoding::convert(std::wstring{pair_low}), replacement);
+    EXPECT_EQ(
+        Encoding::convert(std::wstring{pair_low, pair_high}),
+        replacement + replacement
+    );
+    EXPECT_EQ(
+        Encoding::convert(std::wstring{pair_high, L'a', pair_low}),
+        replacement + "a" + replacement
+    );
+    EXPECT_EQ(
+        Encoding::convert(std::wstring{pair_high, pair_high, pair_low}),
+        replacement + emoji
+    );
+}
+
+TEST(Encoding_Test, Round_Trips_Random_Text)
+{
+    std::mt19937 random{20260101};
+    for (std::size_t length = 0; length < 2000; length += 7)
+    {
+        auto const codes = random_code_points(random, length);
+        auto const utf8 = reference_encode(codes);
+        auto const wide = Encoding::convert(utf8);
+        ASSERT_EQ(wide, to_wide(codes));
+        ASSERT_EQ(Encoding::convert(wide), utf8);
+    }
+}
+
+TEST(Encoding_Test, Decodes_Random_Bytes_Like_The_Reference)
+{
+    std::mt19937 random{42};
+    for (int attempt = 0; attempt < 5000; attempt += 1)
+    {
+        auto const utf8 = random_utf8ish(random, random() % 100);
+        auto const expected = reference_decode(utf8);
+        ASSERT_EQ(Encoding::convert(utf8), to_wide(expected))
+            << testing::PrintToString(utf8);
+        // Whatever we got should survive a round trip.
+        ASSERT_EQ(
+            Encoding::convert(Encoding::convert(utf8)),
+            reference_encode(expected)
+        );
+    }
+}
+
+TEST(Encoding_Test, Encodes_Random_Code_Units_Like_The_Reference)
+{
+    // Random UTF-16 code units, biased towards surrogates
+    std::mt19937 random{7};
+    std::uniform_int_distribution<int> unit{0, 0xFFFF};
+    std::uniform_int_distribution<int> surrogate{0xD800, 0xDFFF};
+    for (int attempt = 0; attempt < 5000; attempt += 1)
+    {
+        std::wstring wide;
+        auto const length = random() % 60;
+        while (wide.size() < length)
+        {
+            wide += static_cast<wchar_t>(
+                random() % 3 == 0 ? surrogate(random)
+                : random() % 2 == 0 ? L'a'
+                                    : unit(random)
+            );
+        }
+
+        std::u32string expected;
+        for (std::size_t pos = 0; pos < wide.size(); pos += 1)
+        {
+            char32_t const code = static_cast<char32_t>(wide[pos]);
+            if (code >= 0xD800 and code <= 0xDBFF and pos + 1 < wide.size()
+                and wide[pos + 1] >= 0xDC00 and wide[pos + 1] <= 0xDFFF)
+            {
+                expected += 0x10000 + ((code - 0xD800) << 10)
+                          + (static_cast<char32_t>(wide[pos + 1]) - 0xDC00);
+                pos += 1;
+            }
+            else if (code >= 0xD800 and code <= 0xDFFF)
+            {
+                expected += Replacement;
+            }
+            else
+            {
+                expected += code;
+            }
+        }
+        ASSERT_EQ(Encoding::convert(wide), reference_encode(expected));
+    }
+}
+
+TEST(Encoding_Test, Finds_The_ASCII_Prefix)
+{
+    for (std::size_t length = 0; length < 50; length += 1)
+    {
+        std::string text(length, 'a');
+        EXPECT_EQ(Encoding::ascii_prefix_length(text), length);
+        for (std::size_t pos = 0; pos < length; pos += 1)
+        {
+            text[pos] = '\x80';
+            EXPECT_EQ(Encoding::ascii_prefix_length(text), pos);
+            text[pos] = 'a';
+        }
+    }
+}
+
+}    // namespace
+
+}    // namespace Linter
@@ -0,0 +1,114 @@
+#include "Error_Highlights.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace Linter
+{
+
+namespace
+{
+
+/** Records what would be sent to scintilla */
+class Recording_Editor : public Highlight_Editor
+{
+  public:
+    void clear(std::intptr_t position) override
+    {
+        calls_.push_back("clear " + std::to_string(position));
+    }
+
+    void set_colour(std::uint32_t colour) override
+    {
+        calls_.push_back("colour " + std::to_string(colour));
+    }
+
+    void fill(std::intptr_t position) override
+    {
+        calls_.push_back("fill " + std::to_string(position));
+    }
+
+    std::vector<std::string> const &calls() const noexcept
+    {
+        return calls_;
+    }
+
+  private:
+    std::vector<std::string> calls_;
+};
+
+std::vector<std::string> update(
+    Error_Highlights const &shown, Error_Highlights const &wanted,
+    bool colour_as_message = true
+)
+{
+    Recording_Editor editor;
+    update_highlights(editor, shown, wanted, colour_as_message);
+    return editor.calls();
+}
+
+using Calls = std::vector<std::string>;
+
+}    // namespace
+
+TEST(Error_Highlights_Test, Fills_New_Highlights_Setting_Each_Colour_Once)
+{
+    EXPECT_EQ(
+        update(
+            {},
+            {{10, {.colour = 1}}, {20, {.colour = 1}}, {30, {.colour = 2}}}
+        ),
+        (Calls{"colour 1", "fill 10", "fill 20", "colour 2", "fill 30"})
+    );
+}
+
+TEST(Error_Highlights_Test, Does_Nothing_If_Nothing_Has_Changed)
+{
+    Error_Highlights const highlights{
+        {10, {.colour = 1}}, {20, {.colour = 2}}
+    };
+    EXPECT_EQ(update(highlights, highlights), Calls{});
+}
+
+TEST(Error_Highlights_Test, Only_Updates_What_Has_Changed)
+{
+    EXPECT_EQ(
+        update(
+            {{10, {.colour = 1}}, {20, {.colour = 1}}, {30, {.colour = 1}}},
+            {{10, {.colour = 1}}, {25, {.colour = 1}}, {30, {.colour = 1}}}
+        ),
+        (Calls{"clear 20", "colour 1", "fill 25"})
+    );
+}
+
+TEST(Error_Highlights_Test, Redraws_Highlights_Which_Change_Colour)
+{
+    EXPECT_EQ(
+        update({{10, {.colour = 1}}}, {{10, {.colour = 2}}}),
+        (Calls{"clear 10", "colour 2", "fill 10"})
+    );
+}
+
+TEST(Error_Highlights_Test, Ignores_Colours_Unless_Coloured_By_Message)
+{
+    EXPECT_EQ(
+        update({{10, {.colour = 1}}}, {{10, {.colour = 2}}}, false), Calls{}
+    );
+    EXPECT_EQ(
+        update({{10, {.colour = 1}}}, {{20, {.colour = 2}}}, false),
+        (Calls{"clear 10", "fill 20"})
+    );
+}
+
+TEST(Error_Highlights_Test, Clears_Everything_When_There_Are_No_Errors)
+{
+    EXPECT_EQ(
+        update({{10, {.colour = 1}}, {20, {.colour = 2}}}, {}),
+        (Calls{"clear 10", "clear 20"})
+    );
+}
+
+}    // namespace Linter
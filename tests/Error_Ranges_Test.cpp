@@ -0,0 +1,187 @@
+#include "Error_Ranges.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace Linter
+{
+
+namespace
+{
+
+using Range = Error_Ranges::Range;
+
+/** The obvious way of doing it: move every range on each edit, and look at
+ * all of them to find the errors at a position
+ */
+class Model
+{
+  public:
+    explicit Model(std::vector<Range> ranges) : ranges_(std::move(ranges))
+    {
+        removed_.resize(ranges_.size(), false);
+    }
+
+    void insert_text(std::intptr_t position, std::intptr_t length)
+    {
+        for (auto &range : ranges_)
+        {
+            if (range.start >= position)
+            {
+                range.start += length;
+                range.end += length;
+            }
+        }
+    }
+
+    void delete_text(std::intptr_t position, std::intptr_t length)
+    {
+        for (std::size_t index = 0; index < ranges_.size(); index += 1)
+        {
+            auto &range = ranges_[index];
+            if (removed_[index] or range.start < position)
+            {
+                continue;
+            }
+            if (range.start < position + length)
+            {
+                removed_[index] = true;
+            }
+            else
+            {
+                range.start -= length;
+                range.end -= length;
+            }
+        }
+    }
+
+    std::wstring find(std::intptr_t position) const
+    {
+        std::wstring result;
+        for (std::size_t index = 0; index < ranges_.size(); index += 1)
+        {
+            auto const &range = ranges_[index];
+            if (not removed_[index] and range.start <= position
+                and position <= range.end)
+            {
+                if (not result.empty())
+                {
+                    result += L" | ";
+                }
+                result += range.message;
+            }
+        }
+        return result;
+    }
+
+  private:
+    // Sorted by start, as Error_Ranges keeps them
+    std::vector<Range> ranges_;
+
+    std::vector<bool> removed_;
+};
+
+TEST(Error_Ranges_Test, Finds_Overlapping_Errors_In_Order)
+{
+    Error_Ranges ranges;
+    ranges.assign(
+        {Range{.start = 10, .end = 20, .message = L"second"},
+         Range{.start = 5, .end = 12, .message = L"first"},
+         Range{.start = 10, .end = 10, .message = L"third"}}
+    );
+
+    EXPECT_EQ(ranges.find(4), L"");
+    EXPECT_EQ(ranges.find(5), L"first");
+    EXPECT_EQ(ranges.find(10), L"first | second | third");
+    EXPECT_EQ(ranges.find(20), L"second");
+    EXPECT_EQ(ranges.find(21), L"");
+}
+
+TEST(Error_Ranges_Test, Follows_Edits)
+{
+    Error_Ranges ranges;
+    ranges.assign(
+        {Range{.start = 5, .end = 8, .message = L"first"},
+         Range{.start = 20, .end = 25, .message = L"second"}}
+    );
+
+    ranges.insert_text(0, 10);
+    EXPECT_EQ(ranges.find(5), L"");
+    EXPECT_EQ(ranges.find(15), L"first");
+
+    // Deleting the start of an error removes it.
+    ranges.delete_text(14, 2);
+    EXPECT_EQ(ranges.find(15), L"");
+    EXPECT_EQ(ranges.find(28), L"second");
+}
+
+TEST(Error_Ranges_Test, Follows_Random_Edits)
+{
+    std::mt19937 random{54321};
+    std::intptr_t text_size = 2000;
+
+    std::vector<Range> original;
+    std::uniform_int_distribution<std::intptr_t> anywhere{0, text_size - 1};
+    std::uniform_int_distribution<std::intptr_t> error_length{0, 40};
+    for (int count = 0; count < 200; count += 1)
+    {
+        auto const start = anywhere(random);
+        original.push_back(Range{
+            .start = start,
+            .end = start + error_length(random),
+            .message = L"error " + std::to_wstring(count)
+        });
+    }
+
+    Error_Ranges ranges;
+    ranges.assign(original);
+    // Both keep ranges with the same start in the order they were given.
+    std::ranges::stable_sort(
+        original,
+        [](Range const &lhs, Range const &rhs) noexcept
+        { return lhs.start < rhs.start; }
+    );
+    Model model{original};
+
+    std::uniform_int_distribution<std::intptr_t> edit_length{1, 30};
+    for (int edit = 0; edit < 2000; edit += 1)
+    {
+        auto const position = std::uniform_int_distribution<std::intptr_t>{
+            0, text_size - 1
+        }(random);
+        auto length = edit_length(random);
+        if (random() % 2 == 0)
+        {
+            ranges.insert_text(position, length);
+            model.insert_text(position, length);
+            text_size += length;
+        }
+        else
+        {
+            length = std::min(length, text_size - position);
+            ranges.delete_text(position, length);
+            model.delete_text(position, length);
+            text_size -= length;
+        }
+
+        for (int lookup = 0; lookup < 5; lookup += 1)
+        {
+            auto const target = std::uniform_int_distribution<std::intptr_t>{
+                0, text_size
+            }(random);
+            ASSERT_EQ(ranges.find(target), model.find(target))
+                << "edit " << edit << ", position " << target;
+        }
+    }
+}
+
+}    // namespace
+
+}    // namespace Linter
@@ -0,0 +1,224 @@
+#include "Error_Sort_Keys.h"
+
+#include "Error_Info.h"
+#include "Error_Store.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <compare>
+#include <cstddef>
+#include <numeric>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace Linter
+{
+
+namespace
+{
+
+using Field = Error_Sort_Keys::Field;
+using Sort_Field = Error_Sort_Keys::Sort_Field;
+
+class Error_Sort_Keys_Test : public testing::Test
+{
+  protected:
+    void add(int line, int column, std::wstring tool, std::wstring message)
+    {
+        errors_.add(Error_Info{
+            .message_ = std::move(message),
+            .tool_ = std::move(tool),
+            .mode_ = Error_Info::Standard,
+            .line_ = line,
+            .column_ = column
+        });
+        keys_.add(errors_, errors_.size() - 1);
+    }
+
+    std::vector<int> sort(std::vector<Sort_Field> const &fields) const
+    {
+        std::vector<int> rows(errors_.size());
+        std::iota(rows.begin(), rows.end(), 0);
+        keys_.sort(rows, fields, errors_);
+        return rows;
+    }
+
+    /** Sort by comparing the fields directly, which is what the keys have
+     * to reproduce.
+     */
+    std::vector<int> reference_sort(std::vector<Sort_Field> const &fields
+    ) const
+    {
+        auto const compare = [this](int lhs, int rhs, Field field)
+        {
+            auto const left = static_cast<std::size_t>(lhs);
+            auto const right = static_cast<std::size_t>(rhs);
+            switch (field)
+            {
+                case Field::Line:
+                    return errors_.line(left) <=> errors_.line(right);
+
+                case Field::Column:
+                    return errors_.column(left) <=> errors_.column(right);
+
+                case Field::Tool:
+                    return errors_.tool(left) <=> errors_.tool(right);
+
+                case Field::Message:
+                    return errors_.message(left) <=> errors_.message(right);
+            }
+            return std::strong_ordering::equal;
+        };
+
+        std::vector<int> rows(errors_.size());
+        std::iota(rows.begin(), rows.end(), 0);
+        std::stable_sort(
+            rows.begin(),
+            rows.end(),
+            [&](int lhs, int rhs)
+            {
+                for (auto const &[field, descending] : fields)
+                {
+                    auto const order = compare(lhs, rhs, field);
+                    if (order != 0)
+                    {
+                        return descending ? order > 0 : order < 0;
+                    }
+                }
+                for (auto const field : {Field::Line, Field::Column})
+                {
+                    auto const order = compare(lhs, rhs, field);
+                    if (order != 0)
+                    {
+                        return order < 0;
+                    }
+                }
+                return false;
+            }
+        );
+        return rows;
+    }
+
+    Error_Store errors_;
+    Error_Sort_Keys keys_;
+};
+
+TEST_F(Error_Sort_Keys_Test, Sorts_By_Line_Then_Column_By_Default)
+{
+    add(3, 1, L"a", L"m");
+    add(1, 5, L"a", L"m");
+    add(1, 2, L"a", L"m");
+    add(2, 9, L"a", L"m");
+    EXPECT_EQ(sort({}), (std::vector<int>{2, 1, 3, 0}));
+}
+
+TEST_F(Error_Sort_Keys_Test, Sorts_Tools_By_Name_Not_By_First_Seen)
+{
+    add(1, 1, L"jshint", L"m");
+    add(1, 1, L"eslint", L"m");
+    add(1, 1, L"stylelint", L"m");
+    add(1, 1, L"eslint", L"m");
+    EXPECT_EQ(
+        sort({{.field = Field::Tool, .descending = false}}),
+        (std::vector<int>{1, 3, 0, 2})
+    );
+    EXPECT_EQ(
+        sort({{.field = Field::Tool, .descending = true}}),
+        (std::vector<int>{2, 0, 1, 3})
+    );
+}
+
+TEST_F(Error_Sort_Keys_Test, Compares_Whole_Messages_When_Prefixes_Match)
+{
+    add(1, 1, L"a", L"Line is too long (90)");
+    add(2, 1, L"a", L"Line is too long (81)");
+    add(3, 1, L"a", L"Line");
+    add(4, 1, L"a", L"Lin");
+    add(5, 1, L"a", L"");
+    add(6, 1, L"a", L"Line is too long (81)");
+    EXPECT_EQ(
+        sort({{.field = Field::Message, .descending = false}}),
+        (std::vector<int>{4, 3, 2, 1, 5, 0})
+    );
+}
+
+TEST_F(Error_Sort_Keys_Test, Orders_Messages_By_Code_Unit)
+{
+    // The prefix must treat code units as unsigned, as the full comparison
+    // does.
+    add(1, 1, L"a", L"Ａ");
+    add(2, 1, L"a", L"é");
+    add(3, 1, L"a", L"z");
+    add(4, 1, L"a", L"翿");
+    add(5, 1, L"a", L"耀");
+    EXPECT_EQ(
+        sort({{.field = Field::Message, .descending = false}}),
+        (std::vector<int>{2, 1, 3, 4, 0})
+    );
+}
+
+TEST_F(Error_Sort_Keys_Test, Breaks_Ties_By_Line_Column_Then_Original_Order)
+{
+    add(5, 1, L"a", L"same");
+    add(2, 7, L"a", L"same");
+    add(2, 3, L"a", L"same");
+    add(2, 3, L"a", L"same");
+    add(1, 1, L"a", L"other");
+    // Ties are in ascending line order even when sorting descending.
+    EXPECT_EQ(
+        sort({{.field = Field::Message, .descending = true}}),
+        (std::vector<int>{2, 3, 1, 0, 4})
+    );
+}
+
+TEST_F(Error_Sort_Keys_Test, Matches_Comparing_The_Fields_Directly)
+{
+    // Messages from a small alphabet, so many share long prefixes
+    std::wstring const alphabet{L"aAz é耀Ａ"};
+    std::wstring const tools[] = {L"eslint", L"jshint", L"Eslint", L"csslint"};
+    std::mt19937 random{99};
+    std::uniform_int_distribution<int> number{1, 20};
+    for (int error = 0; error < 3000; error += 1)
+    {
+        std::wstring message;
+        auto const length = random() % 8;
+        for (std::size_t chr = 0; chr < length; chr += 1)
+        {
+            message += alphabet[random() % alphabet.size()];
+        }
+        add(number(random),
+            number(random),
+            tools[random() % std::size(tools)],
+            message);
+    }
+
+    std::vector<Field> const all{
+        Field::Line, Field::Column, Field::Tool, Field::Message
+    };
+    for (auto const first : all)
+    {
+        for (auto const second : all)
+        {
+            for (bool const descending : {false, true})
+            {
+                std::vector<Sort_Field> const fields{
+                    {.field = first, .descending = descending},
+                    {.field = second, .descending = not descending}
+                };
+                SCOPED_TRACE(
+                    testing::Message()
+                    << static_cast<int>(first) << ", "
+                    << static_cast<int>(second) << ", " << descending
+                );
+                ASSERT_EQ(sort(fields), reference_sort(fields));
+            }
+        }
+    }
+}
+
+}    // namespace
+
+}    // namespace Linter
@@ -0,0 +1,196 @@
+#include "Error_Store.h"
+
+#include "Error_Info.h"
+
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <utility>
+
+namespace Linter
+{
+
+namespace
+{
+
+Error_Info make_error(
+    std::wstring const &message, std::wstring const &severity = L"error",
+    std::wstring const &tool = L"jshint", int line = 1
+)
+{
+    Error_Info error{};
+    error.message_ = message;
+    error.severity_ = severity;
+    error.tool_ = tool;
+    error.command_ = L"jshint --reporter=checkstyle";
+    error.mode_ = Error_Info::Standard;
+    error.line_ = line;
+    error.column_ = 5;
+    error.result_ = 0;
+    return error;
+}
+
+Error_Info make_system_error(
+    std::string const &output, std::string const &error_output
+)
+{
+    auto error = make_error(L"Linter failed");
+    error.stdout_ = output;
+    error.stderr_ = error_output;
+    error.mode_ = Error_Info::Stderr_Found;
+    error.result_ = 2;
+    return error;
+}
+
+}    // namespace
+
+TEST(Error_Store_Test, Returns_What_Was_Added)
+{
+    Error_Store store;
+    EXPECT_TRUE(store.empty());
+    store.add(make_error(L"Missing semicolon.", L"warning", L"jshint", 12));
+    store.add(make_system_error("out", "err"));
+
+    ASSERT_EQ(store.size(), 2);
+    EXPECT_EQ(store.message(0), L"Missing semicolon.");
+    EXPECT_EQ(store.severity(0), L"warning");
+    EXPECT_EQ(store.tool(0), L"jshint");
+    EXPECT_EQ(store.command(0), L"jshint --reporter=checkstyle");
+    EXPECT_EQ(store.output(0), "");
+    EXPECT_EQ(store.error_output(0), "");
+    EXPECT_EQ(store.mode(0), Error_Info::Standard);
+    EXPECT_EQ(store.line(0), 12);
+    EXPECT_EQ(store.column(0), 5);
+    EXPECT_EQ(store.result(0), 0);
+
+    EXPECT_EQ(store.message(1), L"Linter failed");
+    EXPECT_EQ(store.output(1), "out");
+    EXPECT_EQ(store.error_output(1), "err");
+    EXPECT_EQ(store.mode(1), Error_Info::Stderr_Found);
+    EXPECT_EQ(store.result(1), 2);
+}
+
+TEST(Error_Store_Test, Messages_Are_Kept_Together_And_Terminated)
+{
+    Error_Store store;
+    store.add(make_error(L"First"));
+    store.add(make_error(L""));
+    store.add(make_error(L"Third"));
+
+    EXPECT_EQ(store.message(1), L"");
+    for (std::size_t row = 0; row < store.size(); row += 1)
+    {
+        auto const message = store.message(row);
+        EXPECT_EQ(message.data()[message.size()], L'\0');
+    }
+    // Each message follows the previous one and its NUL.
+    EXPECT_EQ(store.message(1).data(), store.message(0).data() + 6);
+    EXPECT_EQ(store.message(2).data(), store.message(1).data() + 1);
+}
+
+TEST(Error_Store_Test, Strings_Are_Only_Stored_Once)
+{
+    Error_Store store;
+    store.add(make_error(L"One", L"error", L"jshint"));
+    store.add(make_error(L"Two", L"warning", L"eslint"));
+    store.add(make_error(L"Three", L"error", L"jshint"));
+
+    EXPECT_EQ(&store.severity(0), &store.severity(2));
+    EXPECT_EQ(&store.tool(0), &store.tool(2));
+    EXPECT_NE(&store.severity(0), &store.severity(1));
+    EXPECT_EQ(&store.command(0), &store.command(1));
+
+    // Another error with the same strings only adds its record and message.
+    auto const bytes = store.bytes();
+    store.add(make_error(L"Four", L"warning", L"eslint"));
+    EXPECT_LT(store.bytes() - bytes, 100);
+}
+
+TEST(Error_Store_Test, Output_Is_Shared)
+{
+    Error_Store store;
+    store.add(make_system_error("out", "err"));
+    store.add(make_system_error("out", "err"));
+    store.add(make_system_error("other", ""));
+
+    EXPECT_EQ(&store.output(0), &store.output(1));
+    EXPECT_EQ(&store.error_output(0), &store.error_output(1));
+    EXPECT_NE(&store.output(0), &store.output(2));
+    EXPECT_EQ(store.error_output(2), "");
+}
+
+TEST(Error_Store_Test, Appending_Shares_Output_And_Reinterns_Strings)
+{
+    Error_Store first;
+    first.add(make_error(L"One", L"warning", L"eslint"));
+    Error_Store second;
+    second.add(make_system_error("out", "err"));
+    second.add(make_error(L"Two", L"warning", L"eslint"));
+
+    first.append(second);
+    ASSERT_EQ(first.size(), 3);
+    EXPECT_EQ(first.message(1), L"Linter failed");
+    EXPECT_EQ(first.message(2), L"Two");
+    EXPECT_EQ(&first.output(1), &second.output(0));
+    EXPECT_EQ(&first.severity(2), &first.severity(0));
+    EXPECT_EQ(&first.tool(2), &first.tool(0));
+}
+
+TEST(Error_Store_Test, Clearing_Forgets_Everything)
+{
+    Error_Store store;
+    store.add(make_system_error("out", "err"));
+    auto const empty_bytes = Error_Store{}.bytes();
+    store.clear();
+    EXPECT_TRUE(store.empty());
+
+    store.add(make_error(L"Again"));
+    EXPECT_EQ(store.message(0), L"Again");
+    EXPECT_EQ(store.output(0), "");
+    EXPECT_GT(store.bytes(), empty_bytes);
+}
+
+TEST(Error_Store_Test, Copies_Have_Their_Own_Index)
+{
+    auto original = std::make_unique<Error_Store>();
+    original->add(make_error(L"One", L"warning", L"eslint"));
+    Error_Store copy{*original};
+
+    // If the copy's index referred to the original's strings, it wouldn't
+    // find them once the original had gone.
+    original.reset();
+    copy.add(make_error(L"Two", L"warning", L"eslint"));
+    EXPECT_EQ(&copy.severity(1), &copy.severity(0));
+    EXPECT_EQ(&copy.tool(1), &copy.tool(0));
+    EXPECT_EQ(copy.severity(1), L"warning");
+}
+
+TEST(Error_Store_Test, Assigned_Copies_Have_Their_Own_Index)
+{
+    Error_Store copy;
+    copy.add(make_error(L"Old", L"info", L"pylint"));
+    {
+        Error_Store original;
+        original.add(make_error(L"One", L"warning", L"eslint"));
+        copy = original;
+        original.clear();
+        original.add(make_error(L"Other", L"error", L"jshint"));
+    }
+    ASSERT_EQ(copy.size(), 1);
+    copy.add(make_error(L"Two", L"warning", L"eslint"));
+    EXPECT_EQ(&copy.severity(1), &copy.severity(0));
+    EXPECT_EQ(copy.tool(1), L"eslint");
+}
+
+TEST(Error_Store_Test, Moves_Keep_The_Index)
+{
+    Error_Store original;
+    original.add(make_error(L"One", L"warning", L"eslint"));
+    Error_Store moved{std::move(original)};
+    moved.add(make_error(L"Two", L"warning", L"eslint"));
+    EXPECT_EQ(&moved.severity(1), &moved.severity(0));
+}
+
+}    // namespace Linter
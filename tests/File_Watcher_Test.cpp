@@ -0,0 +1,283 @@
+#include "File_Watcher.h"
+
+#include <gtest/gtest.h>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+
+#include <array>
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <stop_token>
+#include <string>
+#include <thread>
+#include <tuple>
+
+namespace Linter
+{
+
+namespace
+{
+
+using namespace std::chrono_literals;
+
+using Clock = std::chrono::steady_clock;
+
+/** Waits for changes to the directory with inotify */
+class Inotify_Changes : public File_Watcher::Changes
+{
+  public:
+    Inotify_Changes(
+        std::filesystem::path const &file, std::stop_token const &stop_token
+    ) :
+        file_name_(file.filename().string()),
+        inotify_(::inotify_init1(IN_CLOEXEC))
+    {
+        if (inotify_ == -1 or ::pipe2(stop_.data(), O_CLOEXEC) != 0)
+        {
+            throw std::runtime_error("Can't set up inotify");
+        }
+        if (::inotify_add_watch(
+                inotify_,
+                file.parent_path().c_str(),
+                IN_CLOSE_WRITE | IN_CREATE | IN_DELETE | IN_MODIFY
+                    | IN_MOVED_FROM | IN_MOVED_TO
+            )
+            == -1)
+        {
+            throw std::runtime_error("Can't watch directory");
+        }
+        stopper_.emplace(
+            stop_token,
+            [this]() noexcept
+            {
+                char const byte = 0;
+                std::ignore = ::write(stop_[1], &byte, 1);
+            }
+        );
+    }
+
+    Inotify_Changes(Inotify_Changes const &) = delete;
+    Inotify_Changes(Inotify_Changes &&) = delete;
+    Inotify_Changes &operator=(Inotify_Changes const &) = delete;
+    Inotify_Changes &operator=(Inotify_Changes &&) = delete;
+
+    ~Inotify_Changes() override
+    {
+        stopper_.reset();
+        ::close(inotify_);
+        ::close(stop_[0]);
+        ::close(stop_[1]);
+    }
+
+    bool wait() override
+    {
+        for (;;)
+        {
+            std::array<pollfd, 2> polls{
+                {{.fd = stop_[0], .events = POLLIN, .revents = 0},
+                 {.fd = inotify_, .events = POLLIN, .revents = 0}}
+            };
+            if (::poll(polls.data(), polls.size(), -1) == -1)
+            {
+                if (errno == EINTR)
+                {
+                    continue;
+                }
+                throw std::runtime_error("poll failed");
+            }
+            if (polls[0].revents != 0)
+            {
+                return false;
+            }
+            if (changes_file())
+            {
+                return true;
+            }
+        }
+    }
+
+  private:
+    /** Check if any of the changes that have arrived are to the file */
+    bool changes_file() const
+    {
+        alignas(inotify_event) std::array<char, 4096> buffer{};
+        auto const size = ::read(inotify_, buffer.data(), buffer.size());
+        if (size <= 0)
+        {
+            throw std::runtime_error("Can't read changes");
+        }
+        bool changed = false;
+        for (auto pos = buffer.data(); pos < buffer.data() + size;)
+        {
+            inotify_event event{};
+            std::memcpy(&event, pos, sizeof(event));
+            // If there were too many changes to queue, we aren't told what
+            // they were, so assume the file was one of them.
+            if ((event.mask & IN_Q_OVERFLOW) != 0
+                or (event.len != 0
+                    and file_name_ == &pos[sizeof(inotify_event)]))
+            {
+                changed = true;
+            }
+            pos += sizeof(inotify_event) + event.len;
+        }
+        return changed;
+    }
+
+    std::string const file_name_;
+    int const inotify_;
+    std::array<int, 2> stop_{-1, -1};
+    // NB: This is set up last, as the callback can be invoked immediately.
+    std::optional<std::stop_callback<std::function<void()>>> stopper_;
+};
+
+class File_Watcher_Test : public testing::Test
+{
+  protected:
+    void SetUp() override
+    {
+        auto const *const test =
+            testing::UnitTest::GetInstance()->current_test_info();
+        directory_ = std::filesystem::temp_directory_path()
+                   / (std::string{"File_Watcher_Test."} + test->name());
+        std::filesystem::remove_all(directory_);
+        std::filesystem::create_directory(directory_);
+        file_ = directory_ / "settings.xml";
+        write_file(file_, "original");
+    }
+
+    void TearDown() override
+    {
+        watcher_.reset();
+        std::filesystem::remove_all(directory_);
+    }
+
+    static void write_file(
+        std::filesystem::path const &path, std::string const &text
+    )
+    {
+        std::ofstream{path, std::ios::binary} << text;
+    }
+
+    /** Watch the file with inotify, or by polling if that isn't possible */
+    void watch(bool inotify = true)
+    {
+        File_Watcher::Open_Changes open_changes;
+        if (inotify)
+        {
+            open_changes = [](std::filesystem::path const &file,
+                              std::stop_token const &stop_token)
+            { return std::make_unique<Inotify_Changes>(file, stop_token); };
+        }
+        else
+        {
+            open_changes =
+                [](std::filesystem::path const &,
+                   std::stop_token const &) -> std::unique_ptr<Inotify_Changes>
+            { throw std::runtime_error("Can't watch directory"); };
+        }
+        watcher_ = std::make_unique<File_Watcher>(
+            file_,
+            open_changes,
+            [this]()
+            {
+                std::scoped_lock const lock{mutex_};
+                changes_ += 1;
+                changed_.notify_all();
+            }
+        );
+        // Give the thread time to start watching.
+        std::this_thread::sleep_for(100ms);
+    }
+
+    /** Wait till the function has been called the given number of times,
+     * and return how many times it has been called.
+     */
+    std::size_t wait_for_changes(
+        std::size_t changes, std::chrono::milliseconds timeout = 5s
+    )
+    {
+        std::unique_lock lock{mutex_};
+        changed_.wait_for(
+            lock, timeout, [this, changes]() { return changes_ >= changes; }
+        );
+        return changes_;
+    }
+
+    std::filesystem::path directory_;
+    std::filesystem::path file_;
+    std::unique_ptr<File_Watcher> watcher_;
+
+    std::mutex mutex_;
+    std::condition_variable changed_;
+    std::size_t changes_ = 0;
+};
+
+}    // namespace
+
+TEST_F(File_Watcher_Test, Notices_When_The_File_Is_Written)
+{
+    watch();
+    write_file(file_, "changed");
+    EXPECT_GE(wait_for_changes(1), 1);
+}
+
+TEST_F(File_Watcher_Test, Notices_When_The_File_Is_Replaced)
+{
+    watch();
+    auto const temp = directory_ / "settings.xml.new";
+    write_file(temp, "replaced");
+    std::filesystem::rename(temp, file_);
+    EXPECT_GE(wait_for_changes(1), 1);
+}
+
+TEST_F(File_Watcher_Test, Notices_When_The_File_Is_Deleted)
+{
+    watch();
+    std::filesystem::remove(file_);
+    EXPECT_GE(wait_for_changes(1), 1);
+}
+
+TEST_F(File_Watcher_Test, Ignores_Other_Files)
+{
+    watch();
+    write_file(directory_ / "other.xml", "other");
+    EXPECT_EQ(wait_for_changes(1, 500ms), 0);
+}
+
+TEST_F(File_Watcher_Test, Polls_When_The_Directory_Cannot_Be_Watched)
+{
+    watch(false);
+    // Make sure the time is different, however coarse the file system's
+    // times are.
+    std::filesystem::last_write_time(
+        file_, std::filesystem::last_write_time(file_) + 10s
+    );
+    EXPECT_GE(wait_for_changes(1), 1);
+}
+
+TEST_F(File_Watcher_Test, Stops_Promptly)
+{
+    for (bool const inotify : {true, false})
+    {
+        watch(inotify);
+        auto const start = Clock::now();
+        watcher_.reset();
+        EXPECT_LT(Clock::now() - start, 1s);
+    }
+}
+
+}    // namespace Linter
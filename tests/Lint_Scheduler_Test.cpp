@@ -0,0 +1,303 @@
+#include "Lint_Scheduler.h"
+
+#include "Checkstyle_Parser.h"
+#include "Error_Info.h"
+
+#include "Test_Process.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <latch>
+#include <stdexcept>
+#include <stop_token>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace Linter
+{
+
+namespace
+{
+
+using Clock = std::chrono::steady_clock;
+
+/** How long each stand-in linter takes */
+constexpr double Linter_Seconds = 0.4;
+
+constexpr std::size_t Num_Linters = 3;
+
+/** Run the stand-in linters as File_Linter does, merging the errors as
+ * each one finishes, and return how long it took
+ */
+Clock::duration lint(
+    Lint_Scheduler &scheduler, std::vector<Error_Info> &errors,
+    std::size_t linters = Num_Linters
+)
+{
+    std::vector<std::string> outputs(linters);
+    auto const start = Clock::now();
+    scheduler.run_together(
+        linters,
+        [&outputs](std::size_t linter)
+        {
+            outputs[linter] = Test_Process::run_command(
+                Test_Process::linter_command("sleep.sh") + " "
+                + std::to_string(Linter_Seconds)
+            );
+        },
+        std::stop_token{},
+        [&outputs, &errors](std::size_t linter)
+        {
+            Checkstyle_Parser::get_errors(
+                outputs[linter],
+                [&errors](Error_Info &&error)
+                { errors.push_back(std::move(error)); }
+            );
+        }
+    );
+    return Clock::now() - start;
+}
+
+/** Stands in for linting another open file from disk.
+ *
+ * The linter runs in short pieces, as a real one is killed when the lint is
+ * stopped, so stopping it frees the worker quickly.
+ */
+class Background_Lint
+{
+  public:
+    static constexpr int Pieces = 20;
+
+    static constexpr double Piece_Seconds = 0.05;
+
+    Background_Lint(Lint_Scheduler &scheduler, Lint_Scheduler::Key buffer)
+    {
+        scheduler.run(
+            buffer,
+            Lint_Scheduler::Priority::Background,
+            [this](std::stop_token const &stop)
+            {
+                starts_ += 1;
+                for (int piece = 0; piece < Pieces; piece += 1)
+                {
+                    if (stop.stop_requested())
+                    {
+                        return;
+                    }
+                    Test_Process::run_command(
+                        Test_Process::linter_command("sleep.sh") + " "
+                        + std::to_string(Piece_Seconds)
+                    );
+                }
+                done_.count_down();
+            }
+        );
+    }
+
+    int starts() const noexcept
+    {
+        return starts_;
+    }
+
+    /** Wait for a run to get to the end without being stopped */
+    void wait()
+    {
+        done_.wait();
+    }
+
+  private:
+    std::atomic<int> starts_{0};
+
+    std::latch done_{1};
+};
+
+/** Wait for the scheduler to start the task for a buffer */
+void wait_until_running(
+    Lint_Scheduler const &scheduler, Lint_Scheduler::Key buffer
+)
+{
+    while (not scheduler.is_running(buffer))
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+}
+
+}    // namespace
+
+TEST(Lint_Scheduler_Test, Runs_Linters_At_The_Same_Time)
+{
+    Lint_Scheduler scheduler{Num_Linters};
+    std::vector<Error_Info> errors;
+
+    auto const elapsed = lint(scheduler, errors);
+
+    EXPECT_EQ(errors.size(), Num_Linters);
+    // Should take about as long as the slowest one, rather than all of them
+    // added together.
+    EXPECT_LT(
+        elapsed,
+        std::chrono::duration<double>(Linter_Seconds * (Num_Linters - 0.5))
+    );
+}
+
+TEST(Lint_Scheduler_Test, Runs_Linters_One_After_Another_When_Limited)
+{
+    Lint_Scheduler scheduler{Num_Linters};
+    scheduler.set_max_running(1);
+    std::vector<Error_Info> errors;
+
+    auto const elapsed = lint(scheduler, errors);
+
+    EXPECT_EQ(errors.size(), Num_Linters);
+    EXPECT_GE(
+        elapsed, std::chrono::duration<double>(Linter_Seconds * Num_Linters)
+    );
+}
+
+TEST(Lint_Scheduler_Test, Runs_More_Linters_Than_It_Started_With_When_Allowed)
+{
+    Lint_Scheduler scheduler{1};
+    scheduler.set_max_running(Num_Linters);
+    std::vector<Error_Info> errors;
+
+    auto const elapsed = lint(scheduler, errors);
+
+    EXPECT_EQ(errors.size(), Num_Linters);
+    EXPECT_LT(
+        elapsed,
+        std::chrono::duration<double>(Linter_Seconds * (Num_Linters - 0.5))
+    );
+}
+
+TEST(Lint_Scheduler_Test, Stops_Background_Work_For_The_Current_Buffer)
+{
+    Lint_Scheduler scheduler{1};
+    Background_Lint background{scheduler, 2};
+    wait_until_running(scheduler, 2);
+    std::vector<Error_Info> errors;
+
+    auto const elapsed = lint(scheduler, errors);
+
+    EXPECT_EQ(errors.size(), Num_Linters);
+    // The linters for the current buffer still run one after another, but
+    // don't wait for the background lint to finish first.
+    auto const background_seconds =
+        Background_Lint::Pieces * Background_Lint::Piece_Seconds;
+    EXPECT_LT(
+        elapsed,
+        std::chrono::duration<double>(
+            Linter_Seconds * Num_Linters + background_seconds / 2
+        )
+    );
+
+    // The background lint is run again afterwards.
+    background.wait();
+    EXPECT_EQ(background.starts(), 2);
+}
+
+TEST(Lint_Scheduler_Test, Keeps_A_Worker_Free_For_The_Current_Buffer)
+{
+    Lint_Scheduler scheduler{2};
+    Background_Lint first{scheduler, 2};
+    Background_Lint second{scheduler, 3};
+    wait_until_running(scheduler, 2);
+    EXPECT_FALSE(scheduler.is_running(3));
+    std::vector<Error_Info> errors;
+
+    auto const elapsed = lint(scheduler, errors, 1);
+
+    EXPECT_EQ(errors.size(), 1U);
+    EXPECT_LT(elapsed, std::chrono::duration<double>(Linter_Seconds * 1.5));
+    // There was a worker free, so nothing had to be stopped.
+    first.wait();
+    second.wait();
+    EXPECT_EQ(first.starts(), 1);
+    EXPECT_EQ(second.starts(), 1);
+}
+
+TEST(Lint_Scheduler_Test, Hands_Back_Results_On_The_Calling_Thread)
+{
+    Lint_Scheduler scheduler{Num_Linters};
+    std::vector<std::size_t> finished;
+    std::atomic<bool> other_thread{false};
+    auto const caller = std::this_thread::get_id();
+
+    scheduler.run_together(
+        Num_Linters,
+        [&other_thread, caller](std::size_t)
+        {
+            if (std::this_thread::get_id() != caller)
+            {
+                other_thread = true;
+            }
+        },
+        std::stop_token{},
+        [&finished, caller](std::size_t task)
+        {
+            EXPECT_EQ(std::this_thread::get_id(), caller);
+            finished.push_back(task);
+        }
+    );
+
+    EXPECT_TRUE(other_thread);
+    std::ranges::sort(finished);
+    EXPECT_EQ(finished, (std::vector<std::size_t>{0, 1, 2}));
+}
+
+TEST(Lint_Scheduler_Test, Waits_For_All_The_Tasks_Before_Passing_On_Errors)
+{
+    Lint_Scheduler scheduler{Num_Linters};
+    std::atomic<std::size_t> completed{0};
+    std::size_t calls = 0;
+
+    EXPECT_THROW(
+        scheduler.run_together(
+            Num_Linters,
+            [&completed](std::size_t task)
+            {
+                std::this_thread::sleep_for(std::chrono::milliseconds(
+                    task == 0 ? 0 : 100
+                ));
+                completed += 1;
+            },
+            std::stop_token{},
+            [&calls](std::size_t)
+            {
+                calls += 1;
+                throw std::runtime_error("Bad output");
+            }
+        ),
+        std::runtime_error
+    );
+
+    EXPECT_EQ(completed, Num_Linters);
+    EXPECT_EQ(calls, 1U);
+}
+
+TEST(Lint_Scheduler_Test, Stops_Handing_Back_Results_When_Told_To)
+{
+    Lint_Scheduler scheduler{1};
+    std::stop_source stop_source;
+    std::size_t calls = 0;
+
+    scheduler.run_together(
+        Num_Linters,
+        [](std::size_t) {},
+        stop_source.get_token(),
+        [&calls, &stop_source](std::size_t)
+        {
+            calls += 1;
+            stop_source.request_stop();
+        }
+    );
+
+    EXPECT_EQ(calls, 1U);
+}
+
+}    // namespace Linter
@@ -0,0 +1,167 @@
+#include "Lint_Target.h"
+#include "Temp_Files.h"
+
+#include "Test_Process.h"
+
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <filesystem>
+#include <fstream>
+#include <ios>
+#include <iterator>
+#include <string>
+
+namespace Linter
+{
+
+namespace
+{
+
+class Lint_Target_Test : public testing::Test
+{
+  protected:
+    void SetUp() override
+    {
+        auto const *const test =
+            testing::UnitTest::GetInstance()->current_test_info();
+        directory_ = std::filesystem::temp_directory_path()
+                   / (std::string{"Lint_Target_Test."} + test->name());
+        std::filesystem::remove_all(directory_);
+        std::filesystem::create_directory(directory_);
+        file_ = directory_ / "file.txt";
+        write_file(file_, "saved text");
+    }
+
+    void TearDown() override
+    {
+        temp_files_.remove_all();
+        std::filesystem::remove_all(directory_);
+    }
+
+    static void write_file(
+        std::filesystem::path const &path, std::string const &text
+    )
+    {
+        std::ofstream{path, std::ios::binary} << text;
+    }
+
+    static std::string read_file(std::filesystem::path const &path)
+    {
+        std::ifstream stream{path, std::ios::binary};
+        return {
+            std::istreambuf_iterator<char>{stream},
+            std::istreambuf_iterator<char>{}
+        };
+    }
+
+    /** Lint the buffer the way File_Linter does, with a linter that outputs
+     * the name of the file it was given and what it contains.
+     */
+    std::string lint(std::string const &text, bool modified)
+    {
+        auto const target = choose_lint_target(file_, modified, text.size());
+        auto const name = get_lint_target_name(file_, target);
+        if (target == Lint_Target::Temp_File)
+        {
+            temp_files_.write(name, text);
+        }
+        return Test_Process::run_command(
+            "LINTER_TARGET='" + name.string() + "' "
+            + Test_Process::linter_command("target.sh")
+        );
+    }
+
+    std::filesystem::path temp_file() const
+    {
+        return get_temp_file_name(file_);
+    }
+
+    /** What the linter outputs when given a copy of the text */
+    std::string copy_of(std::string const &text) const
+    {
+        return temp_file().string() + "\n" + text;
+    }
+
+    std::filesystem::path directory_;
+    std::filesystem::path file_;
+    std::size_t writes_ = 0;
+    Temp_Files temp_files_{
+        [this](std::filesystem::path const &path, std::string const &text)
+        {
+            writes_ += 1;
+            write_file(path, text);
+        }
+    };
+};
+
+}    // namespace
+
+TEST_F(Lint_Target_Test, Copies_Are_Hidden_Next_To_The_File)
+{
+    EXPECT_EQ(
+        get_temp_file_name("/project/src/main.cpp"),
+        std::filesystem::path{"/project/src/main.cpp.linter.tmp.cpp"}
+    );
+    EXPECT_EQ(
+        get_temp_file_name("/project/Makefile"),
+        std::filesystem::path{"/project/Makefile.linter.tmp"}
+    );
+}
+
+TEST_F(Lint_Target_Test, Unmodified_Buffers_Lint_The_File)
+{
+    EXPECT_EQ(lint("saved text", false), file_.string() + "\nsaved text");
+    EXPECT_EQ(writes_, 0);
+    EXPECT_FALSE(std::filesystem::exists(temp_file()));
+}
+
+TEST_F(Lint_Target_Test, Modified_Buffers_Lint_A_Copy)
+{
+    EXPECT_EQ(lint("edited text", true), copy_of("edited text"));
+    EXPECT_EQ(writes_, 1);
+    EXPECT_EQ(read_file(file_), "saved text");
+}
+
+TEST_F(Lint_Target_Test, Files_Changed_On_Disc_Lint_A_Copy)
+{
+    EXPECT_EQ(lint("reloaded", false), copy_of("reloaded"));
+}
+
+TEST_F(Lint_Target_Test, New_Files_Lint_A_Copy)
+{
+    std::filesystem::remove(file_);
+    EXPECT_EQ(lint("new text", false), copy_of("new text"));
+}
+
+TEST_F(Lint_Target_Test, Copies_Are_Only_Written_When_The_Text_Changes)
+{
+    lint("edited text", true);
+    EXPECT_EQ(lint("edited text", true), copy_of("edited text"));
+    EXPECT_EQ(writes_, 1);
+
+    // The same size, but different text
+    EXPECT_EQ(lint("edited TEXT", true), copy_of("edited TEXT"));
+    EXPECT_EQ(writes_, 2);
+}
+
+TEST_F(Lint_Target_Test, Copies_Changed_By_Something_Else_Are_Rewritten)
+{
+    lint("edited text", true);
+    write_file(temp_file(), "something else");
+    EXPECT_EQ(lint("edited text", true), copy_of("edited text"));
+    EXPECT_EQ(writes_, 2);
+}
+
+TEST_F(Lint_Target_Test, Copies_Are_Removed_With_The_Buffer)
+{
+    lint("edited text", true);
+    temp_files_.remove(temp_file());
+    EXPECT_FALSE(std::filesystem::exists(temp_file()));
+    EXPECT_TRUE(std::filesystem::exists(file_));
+
+    lint("edited again", true);
+    EXPECT_EQ(writes_, 2);
+}
+
+}    // namespace Linter
@@ -0,0 +1,174 @@
+#include "Moving_Positions.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <random>
+#include <vector>
+
+namespace Linter
+{
+
+namespace
+{
+
+/** The obvious way of doing it: move every position on each edit */
+class Model
+{
+  public:
+    explicit Model(std::vector<std::intptr_t> const &positions) :
+        positions_(positions.begin(), positions.end())
+    {
+    }
+
+    void insert_text(std::intptr_t position, std::intptr_t length)
+    {
+        for (auto &value : positions_)
+        {
+            if (value.has_value() and *value >= position)
+            {
+                *value += length;
+            }
+        }
+    }
+
+    void delete_text(std::intptr_t position, std::intptr_t length)
+    {
+        for (auto &value : positions_)
+        {
+            if (not value.has_value() or *value < position)
+            {
+                continue;
+            }
+            if (*value < position + length)
+            {
+                value.reset();
+            }
+            else
+            {
+                *value -= length;
+            }
+        }
+    }
+
+    std::optional<std::intptr_t> position(std::size_t index) const
+    {
+        return positions_[index];
+    }
+
+    std::size_t lower_bound(std::intptr_t position) const
+    {
+        for (std::size_t index = 0; index < positions_.size(); index += 1)
+        {
+            auto const &value = positions_[index];
+            if (value.has_value() and *value >= position)
+            {
+                return index;
+            }
+        }
+        return positions_.size();
+    }
+
+  private:
+    std::vector<std::optional<std::intptr_t>> positions_;
+};
+
+void expect_same(Moving_Positions const &positions, Model const &model)
+{
+    for (std::size_t index = 0; index < positions.size(); index += 1)
+    {
+        auto const expected = model.position(index);
+        ASSERT_EQ(positions.removed(index), not expected.has_value())
+            << "index " << index;
+        if (expected.has_value())
+        {
+            ASSERT_EQ(positions.position(index), *expected)
+                << "index " << index;
+        }
+    }
+}
+
+TEST(Moving_Positions_Test, Moves_Positions_After_Inserted_Text)
+{
+    Moving_Positions positions;
+    positions.assign({0, 10, 10, 20});
+    EXPECT_FALSE(positions.edited());
+
+    positions.insert_text(10, 5);
+
+    EXPECT_TRUE(positions.edited());
+    EXPECT_EQ(positions.position(0), 0);
+    EXPECT_EQ(positions.position(1), 15);
+    EXPECT_EQ(positions.position(2), 15);
+    EXPECT_EQ(positions.position(3), 25);
+}
+
+TEST(Moving_Positions_Test, Removes_Positions_In_Deleted_Text)
+{
+    Moving_Positions positions;
+    positions.assign({0, 10, 12, 20});
+
+    positions.delete_text(10, 5);
+
+    EXPECT_FALSE(positions.removed(0));
+    EXPECT_TRUE(positions.removed(1));
+    EXPECT_TRUE(positions.removed(2));
+    EXPECT_EQ(positions.next(1), 3U);
+    EXPECT_EQ(positions.position(3), 15);
+    EXPECT_EQ(positions.lower_bound(1), 3U);
+    EXPECT_EQ(positions.lower_bound(16), 4U);
+}
+
+TEST(Moving_Positions_Test, Follows_Random_Edits)
+{
+    std::mt19937 random{12345};
+    std::intptr_t text_size = 2000;
+
+    std::vector<std::intptr_t> original;
+    std::uniform_int_distribution<std::intptr_t> anywhere{0, text_size - 1};
+    for (int count = 0; count < 300; count += 1)
+    {
+        original.push_back(anywhere(random));
+    }
+    std::ranges::sort(original);
+
+    Moving_Positions positions;
+    positions.assign(original);
+    Model model{original};
+
+    std::uniform_int_distribution<std::intptr_t> edit_length{1, 30};
+    for (int edit = 0; edit < 2000; edit += 1)
+    {
+        auto const position = std::uniform_int_distribution<std::intptr_t>{
+            0, text_size - 1
+        }(random);
+        auto length = edit_length(random);
+        if (random() % 2 == 0)
+        {
+            positions.insert_text(position, length);
+            model.insert_text(position, length);
+            text_size += length;
+        }
+        else
+        {
+            length = std::min(length, text_size - position);
+            positions.delete_text(position, length);
+            model.delete_text(position, length);
+            text_size -= length;
+        }
+
+        expect_same(positions, model);
+        auto const target = std::uniform_int_distribution<std::intptr_t>{
+            0, text_size
+        }(random);
+        ASSERT_EQ(positions.lower_bound(target), model.lower_bound(target))
+            << "edit " << edit << ", position " << target;
+    }
+}
+
+}    // namespace
+
+}    // namespace Linter
@@ -0,0 +1,305 @@
+#include "Output_Reader.h"
+
+#include <gtest/gtest.h>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <sys/syscall.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <array>
+#include <cerrno>
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <stdexcept>
+#include <stop_token>
+#include <string>
+#include <thread>
+#include <tuple>
+
+namespace Linter
+{
+
+namespace
+{
+
+using namespace std::chrono_literals;
+
+using Clock = std::chrono::steady_clock;
+
+/** A shell command started with its stdout and stderr going to pipes, as
+ * File_Linter runs linters on Windows.
+ */
+class Child
+{
+  public:
+    explicit Child(std::string const &command)
+    {
+        std::array<int, 2> output{};
+        std::array<int, 2> errors{};
+        if (::pipe2(output.data(), O_CLOEXEC) != 0
+            or ::pipe2(errors.data(), O_CLOEXEC) != 0)
+        {
+            throw std::runtime_error("Can't create pipes");
+        }
+        process_ = ::fork();
+        if (process_ == 0)
+        {
+            ::dup2(output[1], 1);
+            ::dup2(errors[1], 2);
+            ::execl("/bin/sh", "sh", "-c", command.c_str(), nullptr);
+            ::_exit(127);
+        }
+        ::close(output[1]);
+        ::close(errors[1]);
+        pipes_ = {output[0], errors[0]};
+        // This becomes readable when the process exits.
+        exited_ = static_cast<int>(::syscall(SYS_pidfd_open, process_, 0));
+        if (exited_ == -1)
+        {
+            throw std::runtime_error("Can't open the process");
+        }
+    }
+
+    Child(Child const &) = delete;
+    Child(Child &&) = delete;
+    Child &operator=(Child const &) = delete;
+    Child &operator=(Child &&) = delete;
+
+    ~Child()
+    {
+        ::kill(process_, SIGKILL);
+        ::waitpid(process_, nullptr, 0);
+        ::close(exited_);
+        for (int const pipe : pipes_)
+        {
+            ::close(pipe);
+        }
+    }
+
+    int pipe(std::size_t pipe) const noexcept
+    {
+        return pipes_.at(pipe);
+    }
+
+    int exited() const noexcept
+    {
+        return exited_;
+    }
+
+  private:
+    pid_t process_;
+    std::array<int, 2> pipes_{};
+    int exited_;
+};
+
+/** Reads the output of a child with poll */
+class Poll_Output_Reader : public Output_Reader
+{
+  public:
+    Poll_Output_Reader(Child const &child, std::stop_token const &stop_token) :
+        child_(child),
+        stop_(make_pipe()),
+        callback_(stop_token, [this]() noexcept { request_stop(); })
+    {
+    }
+
+    Poll_Output_Reader(Poll_Output_Reader const &) = delete;
+    Poll_Output_Reader(Poll_Output_Reader &&) = delete;
+    Poll_Output_Reader &operator=(Poll_Output_Reader const &) = delete;
+    Poll_Output_Reader &operator=(Poll_Output_Reader &&) = delete;
+
+    ~Poll_Output_Reader() override
+    {
+        ::close(stop_[0]);
+        ::close(stop_[1]);
+    }
+
+    std::string const &output(std::size_t pipe) const noexcept
+    {
+        return outputs_.at(pipe);
+    }
+
+  private:
+    static std::array<int, 2> make_pipe()
+    {
+        std::array<int, 2> pipe{};
+        if (::pipe2(pipe.data(), O_CLOEXEC) != 0)
+        {
+            throw std::runtime_error("Can't create pipe");
+        }
+        return pipe;
+    }
+
+    void request_stop() const noexcept
+    {
+        char const byte = 0;
+        std::ignore = ::write(stop_[1], &byte, 1);
+    }
+
+    bool is_open(std::size_t pipe) const override
+    {
+        return open_.at(pipe);
+    }
+
+    Wakeup wait(bool running) override
+    {
+        std::array<pollfd, 4> polls{};
+        std::array<Wakeup, 4> wakeups{};
+        nfds_t count = 0;
+        auto const add = [&](int file, Event event, std::size_t pipe)
+        {
+            polls.at(count) = {.fd = file, .events = POLLIN, .revents = 0};
+            wakeups.at(count) = {.event = event, .pipe = pipe};
+            count += 1;
+        };
+
+        add(stop_[0], Event::Stopped, 0);
+        for (std::size_t pipe = 0; pipe < 2; pipe += 1)
+        {
+            if (open_.at(pipe))
+            {
+                add(child_.pipe(pipe), Event::Output, pipe);
+            }
+        }
+        if (running)
+        {
+            add(child_.exited(), Event::Exited, 0);
+        }
+
+        int ready = 0;
+        do
+        {
+            ready = ::poll(polls.data(), count, running ? -1 : 0);
+        } while (ready == -1 and errno == EINTR);
+        if (ready == -1)
+        {
+            throw std::runtime_error("poll failed");
+        }
+        for (nfds_t pos = 0; pos < count; pos += 1)
+        {
+            if (polls.at(pos).revents != 0)
+            {
+                return wakeups.at(pos);
+            }
+        }
+        return {.event = Event::Timed_Out, .pipe = 0};
+    }
+
+    void read_pipe(std::size_t pipe) override
+    {
+        std::array<char, 0x10000> buffer{};
+        auto const count =
+            ::read(child_.pipe(pipe), buffer.data(), buffer.size());
+        if (count <= 0)
+        {
+            open_.at(pipe) = false;
+            return;
+        }
+        outputs_.at(pipe).append(buffer.data(), count);
+    }
+
+    Child const &child_;
+    std::array<int, 2> stop_;
+    std::array<bool, 2> open_{true, true};
+    std::array<std::string, 2> outputs_;
+    // NB: This must be declared after stop_, as it can be invoked immediately.
+    std::stop_callback<std::function<void()>> callback_;
+};
+
+/** Run a command, and get what it wrote to stdout and stderr, and how long
+ * it took to read it.
+ */
+struct Result
+{
+    std::string output;
+    std::string errors;
+    Clock::duration time;
+};
+
+Result read_output(
+    std::string const &command, std::stop_token const &stop_token = {}
+)
+{
+    auto const start = Clock::now();
+    Child const child{command};
+    Poll_Output_Reader reader{child, stop_token};
+    reader.read();
+    return {
+        .output = reader.output(0),
+        .errors = reader.output(1),
+        .time = Clock::now() - start
+    };
+}
+
+}    // namespace
+
+TEST(Output_Reader_Test, Reads_Both_Pipes)
+{
+    auto const result = read_output("echo output; echo errors >&2");
+    EXPECT_EQ(result.output, "output\n");
+    EXPECT_EQ(result.errors, "errors\n");
+}
+
+TEST(Output_Reader_Test, Reads_Nothing_From_Silent_Processes)
+{
+    auto const result = read_output("true");
+    EXPECT_EQ(result.output, "");
+    EXPECT_EQ(result.errors, "");
+}
+
+TEST(Output_Reader_Test, Drains_Both_Pipes_As_Output_Arrives)
+{
+    // Much more than a pipe holds, so the process would block if we only
+    // read one pipe at a time.
+    auto const result = read_output(
+        "head -c 1000000 /dev/zero | tr '\\0' e >&2;"
+        "head -c 1000000 /dev/zero | tr '\\0' o;"
+        "head -c 1000000 /dev/zero | tr '\\0' e >&2"
+    );
+    EXPECT_EQ(result.output, std::string(1000000, 'o'));
+    EXPECT_EQ(result.errors, std::string(2000000, 'e'));
+}
+
+TEST(Output_Reader_Test, Waits_For_The_Process_To_Exit)
+{
+    auto const result = read_output("echo done; exec >&- 2>&-; sleep 0.3");
+    EXPECT_EQ(result.output, "done\n");
+    EXPECT_GE(result.time, 300ms);
+}
+
+TEST(Output_Reader_Test, Does_Not_Wait_For_What_The_Process_Started)
+{
+    // The sleep still has the pipes open after the shell exits.
+    auto const result = read_output("sleep 3 & echo started");
+    EXPECT_EQ(result.output, "started\n");
+    EXPECT_LT(result.time, 2s);
+}
+
+TEST(Output_Reader_Test, Stops_When_Asked)
+{
+    std::stop_source stop_source;
+    std::jthread const stopper{[&stop_source]()
+                               {
+                                   std::this_thread::sleep_for(100ms);
+                                   stop_source.request_stop();
+                               }};
+    auto const result =
+        read_output("echo started; sleep 3", stop_source.get_token());
+    EXPECT_EQ(result.output, "started\n");
+    EXPECT_LT(result.time, 2s);
+}
+
+TEST(Output_Reader_Test, Stops_Straight_Away_If_Already_Asked)
+{
+    std::stop_source stop_source;
+    stop_source.request_stop();
+    auto const result = read_output("sleep 3", stop_source.get_token());
+    EXPECT_LT(result.time, 2s);
+}
+
+}    // namespace Linter
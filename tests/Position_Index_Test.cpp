@@ -0,0 +1,134 @@
+#include "Position_Index.h"
+
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace Linter
+{
+
+namespace
+{
+
+/** Stands in for Scintilla, counting how often the lines are fetched */
+class Position_Index_Test : public testing::Test
+{
+  protected:
+    Position_Index make_index(std::vector<std::string> lines)
+    {
+        lines_ = std::move(lines);
+        return Position_Index{
+            [this](int line)
+            {
+                std::intptr_t start = 0;
+                for (int previous = 0; previous < line; previous += 1)
+                {
+                    start += static_cast<std::intptr_t>(
+                        lines_[static_cast<std::size_t>(previous)].size()
+                    );
+                }
+                return start;
+            },
+            [this](int line)
+            {
+                fetches_ += 1;
+                return lines_[static_cast<std::size_t>(line)];
+            }
+        };
+    }
+
+    std::vector<std::string> lines_;
+    int fetches_{0};
+};
+
+TEST_F(Position_Index_Test, Uses_Byte_Offsets_For_ASCII)
+{
+    auto index = make_index({"abcdef\n"});
+    EXPECT_EQ(index.position(1, 1), 0);
+    EXPECT_EQ(index.position(1, 2), 1);
+    EXPECT_EQ(index.position(1, 6), 5);
+}
+
+TEST_F(Position_Index_Test, Adds_The_Line_Start)
+{
+    auto index = make_index({"one\n", "two\r\n", "three\n"});
+    EXPECT_EQ(index.position(2, 1), 4);
+    EXPECT_EQ(index.position(2, 3), 6);
+    EXPECT_EQ(index.position(3, 2), 10);
+}
+
+TEST_F(Position_Index_Test, Counts_Columns_In_UTF16_Code_Units)
+{
+    // e acute is 2 bytes, the euro sign is 3, and both are 1 code unit
+    auto index = make_index({"\xC3\xA9\xE2\x82\xAC" "x\n"});
+    EXPECT_EQ(index.position(1, 2), 2);
+    EXPECT_EQ(index.position(1, 3), 5);
+    EXPECT_EQ(index.position(1, 4), 6);
+}
+
+TEST_F(Position_Index_Test, Counts_Surrogate_Pairs_As_Two_Columns)
+{
+    // The emoji is 4 bytes and a surrogate pair in UTF-16
+    auto index = make_index({"a\xF0\x9F\x98\x80" "b\n"});
+    EXPECT_EQ(index.position(1, 2), 1);
+    // Pointing into the middle of the pair gives the start of the character
+    EXPECT_EQ(index.position(1, 3), 1);
+    EXPECT_EQ(index.position(1, 4), 5);
+    EXPECT_EQ(index.position(1, 5), 6);
+}
+
+TEST_F(Position_Index_Test, Handles_Non_ASCII_After_A_Long_ASCII_Prefix)
+{
+    // Long enough that the prefix is found 16 bytes at a time
+    std::string const prefix(40, 'x');
+    auto index = make_index({prefix + "\xC3\xA9y\n"});
+    EXPECT_EQ(index.position(1, 41), 40);
+    EXPECT_EQ(index.position(1, 42), 42);
+    EXPECT_EQ(index.position(1, 43), 43);
+}
+
+TEST_F(Position_Index_Test, Counts_Stray_Bytes_As_One_Column)
+{
+    auto index = make_index({"\x80\x80z\n"});
+    EXPECT_EQ(index.position(1, 2), 1);
+    EXPECT_EQ(index.position(1, 3), 2);
+}
+
+TEST_F(Position_Index_Test, Clamps_Columns_To_The_Line)
+{
+    auto index = make_index({"abc\r\n", "d\xC3\xA9\r\n", "\r\n", "xyz"});
+    // Past the end goes before the line end, whichever kind it is
+    EXPECT_EQ(index.position(1, 4), 3);
+    EXPECT_EQ(index.position(1, 100), 3);
+    EXPECT_EQ(index.position(2, 4), 5 + 3);
+    EXPECT_EQ(index.position(2, 100), 5 + 3);
+    EXPECT_EQ(index.position(3, 5), 10);
+    EXPECT_EQ(index.position(4, 10), 12 + 3);
+    // And before the start goes to the start
+    EXPECT_EQ(index.position(2, 0), 5);
+    EXPECT_EQ(index.position(2, -3), 5);
+}
+
+TEST_F(Position_Index_Test, Fetches_Each_Line_Once_In_Line_Order)
+{
+    auto index = make_index({"a\xC3\xA9" "bc\n", "de\n"});
+    for (int column = 1; column <= 5; column += 1)
+    {
+        std::ignore = index.position(1, column);
+    }
+    EXPECT_EQ(fetches_, 1);
+    std::ignore = index.position(2, 1);
+    std::ignore = index.position(2, 2);
+    EXPECT_EQ(fetches_, 2);
+    std::ignore = index.position(1, 3);
+    EXPECT_EQ(fetches_, 3);
+}
+
+}    // namespace
+
+}    // namespace Linter
@@ -0,0 +1,103 @@
+#include "Relint_Delay.h"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <optional>
+
+namespace Linter
+{
+
+namespace
+{
+
+using Duration = Relint_Delay::Duration;
+
+/** A fake clock, starting at an arbitrary time */
+Relint_Delay::Clock::time_point at(int milliseconds)
+{
+    return Relint_Delay::Clock::time_point{} + std::chrono::hours{1}
+         + Duration{milliseconds};
+}
+
+TEST(Relint_Delay_Test, Uses_Minimum_With_Nothing_To_Go_On)
+{
+    Relint_Delay relint_delay;
+    relint_delay.set_limits(Duration{100}, Duration{2000});
+
+    EXPECT_EQ(relint_delay.delay(L".js"), Duration{100});
+    EXPECT_EQ(relint_delay.last_delay(), Duration{100});
+    EXPECT_EQ(relint_delay.typing_gap(), std::nullopt);
+}
+
+TEST(Relint_Delay_Test, Waits_Longer_Than_The_Typing_Gap)
+{
+    Relint_Delay relint_delay;
+    relint_delay.set_limits(Duration{100}, Duration{2000});
+    relint_delay.edited(at(0));
+    relint_delay.edited(at(200));
+    relint_delay.edited(at(400));
+
+    EXPECT_EQ(relint_delay.typing_gap(), Duration{200});
+    EXPECT_EQ(relint_delay.delay(L".js"), Duration{300});
+
+    // Recent gaps count for more than older ones.
+    relint_delay.edited(at(500));
+    EXPECT_EQ(relint_delay.typing_gap(), Duration{175});
+}
+
+TEST(Relint_Delay_Test, Treats_Close_Changes_As_One_Edit)
+{
+    Relint_Delay relint_delay;
+    relint_delay.edited(at(0));
+    relint_delay.edited(at(10));
+    relint_delay.edited(at(250));
+
+    EXPECT_EQ(relint_delay.typing_gap(), Duration{250});
+}
+
+TEST(Relint_Delay_Test, Ignores_Pauses_In_Typing)
+{
+    Relint_Delay relint_delay;
+    relint_delay.edited(at(0));
+    relint_delay.edited(at(5000));
+
+    EXPECT_EQ(relint_delay.typing_gap(), std::nullopt);
+
+    relint_delay.edited(at(5300));
+    EXPECT_EQ(relint_delay.typing_gap(), Duration{300});
+}
+
+TEST(Relint_Delay_Test, Waits_As_Long_As_The_Linters_Take)
+{
+    Relint_Delay relint_delay;
+    relint_delay.set_limits(Duration{100}, Duration{2000});
+    relint_delay.edited(at(0));
+    relint_delay.edited(at(200));
+    relint_delay.linted(L".js", Duration{800});
+
+    EXPECT_EQ(relint_delay.delay(L".js"), Duration{800});
+    EXPECT_EQ(relint_delay.delay(L".css"), Duration{300});
+    EXPECT_EQ(relint_delay.last_delay(), Duration{300});
+
+    relint_delay.linted(L".js", Duration{400});
+    EXPECT_EQ(relint_delay.delay(L".js"), Duration{700});
+}
+
+TEST(Relint_Delay_Test, Keeps_To_The_Limits)
+{
+    Relint_Delay relint_delay;
+    relint_delay.set_limits(Duration{50}, Duration{500});
+    relint_delay.linted(L".js", Duration{800});
+
+    EXPECT_EQ(relint_delay.delay(L".js"), Duration{500});
+    EXPECT_EQ(relint_delay.delay(L".css"), Duration{50});
+
+    // A maximum below the minimum is treated as the minimum.
+    relint_delay.set_limits(Duration{300}, Duration{200});
+    EXPECT_EQ(relint_delay.delay(L".js"), Duration{300});
+}
+
+}    // namespace
+
+}    // namespace Linter
@@ -0,0 +1,86 @@
+#include "Result_Cache.h"
+
+#include "Error_Info.h"
+#include "Error_Store.h"
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <tuple>
+
+namespace Linter
+{
+
+namespace
+{
+
+Result_Cache::Key make_key(std::string const &text)
+{
+    return Result_Cache::Key{
+        .text_hash = Result_Cache::hash(text),
+        .text_size = text.size(),
+        .path = L"C:\\file.js",
+        .command = L"linter.exe",
+        .settings_generation = 1
+    };
+}
+
+Error_Store make_errors(std::wstring const &message)
+{
+    Error_Store errors;
+    errors.add(Error_Info{.message_ = message, .mode_ = Error_Info::Standard});
+    return errors;
+}
+
+TEST(Result_Cache_Test, Hash_Is_64_Bit_FNV_1a)
+{
+    EXPECT_EQ(Result_Cache::hash(""), 0xcbf29ce484222325ULL);
+    EXPECT_EQ(Result_Cache::hash("a"), 0xaf63dc4c8601ec8cULL);
+    EXPECT_EQ(Result_Cache::hash("foobar"), 0x85944171f73967e8ULL);
+}
+
+TEST(Result_Cache_Test, Finds_Stored_Results)
+{
+    Result_Cache cache;
+    cache.set_budget(1 << 20);
+    cache.store(make_key("one"), make_errors(L"first"));
+
+    auto const found = cache.find(make_key("one"));
+    ASSERT_NE(found, nullptr);
+    EXPECT_EQ(found->message(0), L"first");
+    EXPECT_EQ(cache.find(make_key("two")), nullptr);
+
+    auto const statistics = cache.statistics();
+    EXPECT_EQ(statistics.hits, 1U);
+    EXPECT_EQ(statistics.misses, 1U);
+    EXPECT_EQ(statistics.entries, 1U);
+}
+
+TEST(Result_Cache_Test, Evicts_Least_Recently_Used)
+{
+    Result_Cache cache;
+    cache.set_budget(1 << 20);
+    cache.store(make_key("one"), make_errors(L"first"));
+    auto const one_entry = cache.statistics().bytes;
+    cache.set_budget(one_entry * 5 / 2);
+
+    cache.store(make_key("two"), make_errors(L"second"));
+    // Use the first one so the second is the oldest
+    std::ignore = cache.find(make_key("one"));
+    cache.store(make_key("six"), make_errors(L"third"));
+
+    EXPECT_NE(cache.find(make_key("one")), nullptr);
+    EXPECT_EQ(cache.find(make_key("two")), nullptr);
+    EXPECT_NE(cache.find(make_key("six")), nullptr);
+}
+
+TEST(Result_Cache_Test, Does_Nothing_Without_A_Budget)
+{
+    Result_Cache cache;
+    cache.store(make_key("one"), make_errors(L"first"));
+    EXPECT_EQ(cache.find(make_key("one")), nullptr);
+}
+
+}    // namespace
+
+}    // namespace Linter
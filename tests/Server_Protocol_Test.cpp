@@ -0,0 +1,205 @@
+#include "Server_Protocol.h"
+
+#include "Test_Process.h"
+
+#include <gtest/gtest.h>
+
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <array>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+namespace Linter
+{
+
+namespace
+{
+
+using Server_Protocol::Invalid_Reply;
+using Server_Protocol::take_reply;
+
+/** A server started with pipes to its stdin and stdout, as Linter_Server
+ * does on Windows.
+ */
+class Echo_Server
+{
+  public:
+    Echo_Server()
+    {
+        std::array<int, 2> input{};
+        std::array<int, 2> output{};
+        if (::pipe(input.data()) != 0 or ::pipe(output.data()) != 0)
+        {
+            throw std::runtime_error("Can't create pipes");
+        }
+        process_ = ::fork();
+        if (process_ == 0)
+        {
+            ::dup2(input[0], 0);
+            ::dup2(output[1], 1);
+            ::close(input[0]);
+            ::close(input[1]);
+            ::close(output[0]);
+            ::close(output[1]);
+            std::string const script{LINTERS_DIR "/echo_server.sh"};
+            ::execl("/bin/sh", "sh", script.c_str(), nullptr);
+            ::_exit(127);
+        }
+        ::close(input[0]);
+        ::close(output[1]);
+        input_ = input[1];
+        output_ = output[0];
+    }
+
+    Echo_Server(Echo_Server const &) = delete;
+    Echo_Server(Echo_Server &&) = delete;
+    Echo_Server &operator=(Echo_Server const &) = delete;
+    Echo_Server &operator=(Echo_Server &&) = delete;
+
+    ~Echo_Server()
+    {
+        if (input_ != -1)
+        {
+            ::close(input_);
+        }
+        ::close(output_);
+        wait();
+    }
+
+    void send(std::string const &path, std::string const &text) const
+    {
+        auto const request = Server_Protocol::request(path, text);
+        std::size_t written = 0;
+        while (written < request.size())
+        {
+            auto const count = ::write(
+                input_, request.data() + written, request.size() - written
+            );
+            if (count <= 0)
+            {
+                throw std::runtime_error("Can't write to server");
+            }
+            written += static_cast<std::size_t>(count);
+        }
+    }
+
+    /** Read the next reply, or an empty optional if the server exits */
+    std::optional<Server_Protocol::Reply> receive()
+    {
+        for (;;)
+        {
+            if (auto reply = take_reply(received_))
+            {
+                return reply;
+            }
+            std::array<char, 7> buffer{};    // Small, to split the replies
+            auto const count = ::read(output_, buffer.data(), buffer.size());
+            if (count <= 0)
+            {
+                return std::nullopt;
+            }
+            received_.append(buffer.data(), static_cast<std::size_t>(count));
+        }
+    }
+
+    /** Wait for the server to exit and get its exit status */
+    int wait()
+    {
+        if (process_ != -1)
+        {
+            int status = 0;
+            ::waitpid(std::exchange(process_, -1), &status, 0);
+            exit_status_ = WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+        }
+        return exit_status_;
+    }
+
+  private:
+    pid_t process_{-1};
+    int input_{-1};
+    int output_{-1};
+    int exit_status_{-1};
+    std::string received_;
+};
+
+TEST(Server_Protocol_Test, Makes_Requests)
+{
+    EXPECT_EQ(
+        Server_Protocol::request("C:\\dir\\file.js", "var a;\n"),
+        "C:\\dir\\file.js\n7\nvar a;\n"
+    );
+    EXPECT_EQ(Server_Protocol::request("empty.js", ""), "empty.js\n0\n");
+}
+
+TEST(Server_Protocol_Test, Takes_Replies_Once_They_Have_Arrived)
+{
+    std::string received{"5 3\nhel"};
+    EXPECT_EQ(take_reply(received), std::nullopt);
+    EXPECT_EQ(received, "5 3\nhel");
+
+    received += "lobad6 0\n";
+    auto const reply = take_reply(received);
+    ASSERT_TRUE(reply.has_value());
+    EXPECT_EQ(reply->output, "hello");
+    EXPECT_EQ(reply->error_output, "bad");
+    EXPECT_EQ(received, "6 0\n");
+
+    EXPECT_EQ(take_reply(received), std::nullopt);
+    received += "<xml/>";
+    EXPECT_EQ(take_reply(received)->output, "<xml/>");
+    EXPECT_TRUE(received.empty());
+}
+
+TEST(Server_Protocol_Test, Rejects_Bad_Headers)
+{
+    for (std::string received :
+         {"hello\n", "5\n", "5 \n", " 5 3\n", "5 3 \n", "5  3\n", "5 -3\n",
+          "99999999999999999999999 0\n", "18446744073709551615 1\n"})
+    {
+        EXPECT_THROW(take_reply(received), Invalid_Reply) << received;
+    }
+}
+
+TEST(Server_Protocol_Test, Talks_To_An_Echo_Server)
+{
+    Echo_Server server;
+    for (std::string const text :
+         {"var a = 1;\n", "", "line 1\nline 2\n\n", "\xc3\xa9\xf0\x9f\x98\x80"})
+    {
+        server.send("/dir/caf\xc3\xa9.js", text);
+        auto const reply = server.receive();
+        ASSERT_TRUE(reply.has_value());
+        EXPECT_EQ(reply->output, text);
+        EXPECT_EQ(reply->error_output, "/dir/caf\xc3\xa9.js");
+    }
+}
+
+TEST(Server_Protocol_Test, Replies_Can_Be_Waiting_For_Each_Other)
+{
+    // This is what happens when a request is cancelled and the reply has to
+    // be skipped.
+    Echo_Server server;
+    server.send("first.js", "1");
+    server.send("second.js", "22");
+    server.send("third.js", "333");
+    EXPECT_EQ(server.receive()->output, "1");
+    EXPECT_EQ(server.receive()->output, "22");
+    EXPECT_EQ(server.receive()->error_output, "third.js");
+}
+
+TEST(Server_Protocol_Test, Notices_When_The_Server_Dies)
+{
+    Echo_Server server;
+    server.send("exit", "");
+    EXPECT_EQ(server.receive(), std::nullopt);
+    EXPECT_EQ(server.wait(), 3);
+}
+
+}    // namespace
+
+}    // namespace Linter
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstdio>
+#include <stdexcept>
+#include <string>
+
+namespace Linter::Test_Process
+{
+
+/** Run a shell command and return what it writes to stdout */
+inline std::string run_command(std::string const &command)
+{
+    FILE *const pipe = ::popen(command.c_str(), "r");
+    if (pipe == nullptr)
+    {
+        throw std::runtime_error("Can't run " + command);
+    }
+    std::string output;
+    char buffer[4096];
+    for (;;)
+    {
+        auto const read = std::fread(&buffer[0], 1, sizeof(buffer), pipe);
+        if (read == 0)
+        {
+            break;
+        }
+        output.append(&buffer[0], read);
+    }
+    if (::pclose(pipe) != 0)
+    {
+        throw std::runtime_error(command + " failed");
+    }
+    return output;
+}
+
+/** Get the command line to run one of the stand-in linters */
+inline std::string linter_command(std::string const &linter)
+{
+    return std::string{"sh \""} + LINTERS_DIR + "/" + linter + "\"";
+}
+
+}    // namespace Linter::Test_Process
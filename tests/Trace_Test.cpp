@@ -0,0 +1,140 @@
+#include "Trace.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace Linter
+{
+
+namespace
+{
+
+/** Get the recorded events with the given name. The buffer is shared by the
+ * whole program, so each test uses its own names.
+ */
+std::vector<Trace::Event> events_named(std::string_view name)
+{
+    std::vector<Trace::Event> found;
+    for (auto const &event : Trace::events())
+    {
+        if (event.name == name)
+        {
+            found.push_back(event);
+        }
+    }
+    return found;
+}
+
+class Trace_Test : public testing::Test
+{
+  protected:
+    void SetUp() override
+    {
+        Trace::enable(true);
+    }
+
+    void TearDown() override
+    {
+        Trace::enable(false);
+    }
+};
+
+TEST_F(Trace_Test, Records_Nothing_When_Disabled)
+{
+    Trace::enable(false);
+    {
+        Trace::Span const span{"Disabled span"};
+    }
+    EXPECT_TRUE(events_named("Disabled span").empty());
+}
+
+TEST_F(Trace_Test, Nested_Spans_Lie_Inside_Each_Other)
+{
+    {
+        Trace::Span const outer{"Outer span"};
+        std::this_thread::sleep_for(std::chrono::milliseconds{2});
+        {
+            Trace::Span const inner{"Inner span"};
+            std::this_thread::sleep_for(std::chrono::milliseconds{2});
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds{2});
+    }
+
+    auto const outer = events_named("Outer span");
+    auto const inner = events_named("Inner span");
+    ASSERT_EQ(outer.size(), 1U);
+    ASSERT_EQ(inner.size(), 1U);
+    EXPECT_EQ(outer[0].thread, inner[0].thread);
+    EXPECT_GE(outer[0].duration, 6000);
+    EXPECT_GE(inner[0].duration, 2000);
+    EXPECT_GT(inner[0].start, outer[0].start);
+    EXPECT_LT(
+        inner[0].start + inner[0].duration, outer[0].start + outer[0].duration
+    );
+
+    // Events come out in the order they started, not the order they ended.
+    auto const events = Trace::events();
+    auto const position = [&events](std::string_view name)
+    {
+        return std::ranges::find_if(
+            events,
+            [name](Trace::Event const &event) { return event.name == name; }
+        );
+    };
+    EXPECT_LT(position("Outer span"), position("Inner span"));
+}
+
+TEST_F(Trace_Test, Threads_Are_Told_Apart)
+{
+    {
+        Trace::Span const span{"Main thread span"};
+    }
+    std::thread{[]() { Trace::Span const span{"Other thread span"}; }}.join();
+
+    auto const main = events_named("Main thread span");
+    auto const other = events_named("Other thread span");
+    ASSERT_EQ(main.size(), 1U);
+    ASSERT_EQ(other.size(), 1U);
+    EXPECT_NE(main[0].thread, other[0].thread);
+}
+
+TEST_F(Trace_Test, Keeps_The_Latest_Events_When_Full)
+{
+    for (int count = 0; count < 5000; count += 1)
+    {
+        Trace::Span const span{"Repeated span"};
+    }
+    {
+        Trace::Span const span{"Last span"};
+    }
+
+    auto const events = Trace::events();
+    EXPECT_LT(events.size(), 5000U);
+    EXPECT_EQ(events_named("Last span").size(), 1U);
+}
+
+TEST_F(Trace_Test, Exports_Complete_Events_As_Json)
+{
+    {
+        Trace::Span const span{"Exported span"};
+    }
+
+    auto const json = Trace::to_json();
+    EXPECT_TRUE(json.starts_with("{\"traceEvents\":["));
+    EXPECT_TRUE(json.ends_with("],\"displayTimeUnit\":\"ms\"}\n"));
+    EXPECT_NE(
+        json.find("{\"name\":\"Exported span\",\"cat\":\"lint\",\"ph\":\"X\""),
+        std::string::npos
+    );
+}
+
+}    // namespace
+
+}    // namespace Linter
@@ -0,0 +1,165 @@
+#include "Variable_Cache.h"
+
+#include "Test_Process.h"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstddef>
+#include <filesystem>
+#include <fstream>
+#include <optional>
+#include <string>
+
+namespace Linter
+{
+
+namespace
+{
+
+using Policy = Variable_Cache::Policy;
+
+class Variable_Cache_Test : public testing::Test
+{
+  protected:
+    void SetUp() override
+    {
+        auto const *const test =
+            testing::UnitTest::GetInstance()->current_test_info();
+        runs_file_ = std::filesystem::temp_directory_path()
+                   / (std::string{"Variable_Cache_Test."} + test->name());
+        std::filesystem::remove(runs_file_);
+    }
+
+    void TearDown() override
+    {
+        std::filesystem::remove(runs_file_);
+    }
+
+    /** Get the value of a variable the way File_Linter does: use the cached
+     * value if there is one, otherwise run the command and cache the output.
+     */
+    std::string get_value(
+        Policy const &policy, std::string const &value,
+        std::filesystem::path const &directory = "/project"
+    )
+    {
+        std::string const command = Test_Process::linter_command("variable.sh")
+                                  + " \"" + runs_file_.string() + "\" "
+                                  + value;
+        std::wstring const command_line{command.begin(), command.end()};
+        if (auto const cached =
+                cache_.find(L"VARIABLE", command_line, policy, directory))
+        {
+            return *cached;
+        }
+        auto output = Test_Process::run_command(command);
+        if (not output.empty() and output.back() == '\n')
+        {
+            output.pop_back();
+        }
+        cache_.store(L"VARIABLE", command_line, policy, directory, output);
+        return output;
+    }
+
+    /** Get the number of times the command has been run */
+    std::size_t runs() const
+    {
+        std::ifstream file{runs_file_};
+        std::size_t runs = 0;
+        for (std::string line; std::getline(file, line);)
+        {
+            runs += 1;
+        }
+        return runs;
+    }
+
+    Variable_Cache cache_;
+
+  private:
+    std::filesystem::path runs_file_;
+};
+
+}    // namespace
+
+TEST_F(Variable_Cache_Test, Runs_An_Uncached_Command_Every_Time)
+{
+    Policy const policy{.mode = Policy::Mode::None};
+
+    EXPECT_EQ(get_value(policy, "value"), "value");
+    EXPECT_EQ(get_value(policy, "value"), "value");
+
+    EXPECT_EQ(runs(), 2U);
+    EXPECT_EQ(cache_.statistics().hits, 0U);
+    EXPECT_EQ(cache_.statistics().misses, 0U);
+}
+
+TEST_F(Variable_Cache_Test, Runs_A_Session_Command_Once)
+{
+    Policy const policy{.mode = Policy::Mode::Session};
+
+    EXPECT_EQ(get_value(policy, "value", "/one"), "value");
+    EXPECT_EQ(get_value(policy, "value", "/two"), "value");
+    EXPECT_EQ(get_value(policy, "value", "/one"), "value");
+
+    EXPECT_EQ(runs(), 1U);
+    EXPECT_EQ(cache_.statistics().hits, 2U);
+    EXPECT_EQ(cache_.statistics().misses, 1U);
+}
+
+TEST_F(Variable_Cache_Test, Runs_A_Directory_Command_Once_Per_Directory)
+{
+    Policy const policy{.mode = Policy::Mode::Directory};
+
+    EXPECT_EQ(get_value(policy, "value", "/one"), "value");
+    EXPECT_EQ(get_value(policy, "value", "/two"), "value");
+    EXPECT_EQ(get_value(policy, "value", "/one"), "value");
+    EXPECT_EQ(get_value(policy, "value", "/two"), "value");
+
+    EXPECT_EQ(runs(), 2U);
+    EXPECT_EQ(cache_.statistics().hits, 2U);
+    EXPECT_EQ(cache_.statistics().misses, 2U);
+}
+
+TEST_F(Variable_Cache_Test, Reruns_A_Timed_Command_Once_It_Expires)
+{
+    Policy const expired{
+        .mode = Policy::Mode::Timed, .lifetime = std::chrono::seconds{0}
+    };
+    EXPECT_EQ(get_value(expired, "value"), "value");
+    EXPECT_EQ(get_value(expired, "value"), "value");
+    EXPECT_EQ(runs(), 2U);
+
+    Policy const current{
+        .mode = Policy::Mode::Timed, .lifetime = std::chrono::hours{1}
+    };
+    EXPECT_EQ(get_value(current, "value"), "value");
+    EXPECT_EQ(get_value(current, "value"), "value");
+    EXPECT_EQ(runs(), 3U);
+}
+
+TEST_F(Variable_Cache_Test, Reruns_A_Command_When_Its_Arguments_Change)
+{
+    // As happens when the arguments use %TARGET% and a different file is
+    // linted.
+    Policy const policy{.mode = Policy::Mode::Session};
+
+    EXPECT_EQ(get_value(policy, "first"), "first");
+    EXPECT_EQ(get_value(policy, "second"), "second");
+    EXPECT_EQ(get_value(policy, "first"), "first");
+
+    EXPECT_EQ(runs(), 2U);
+}
+
+TEST_F(Variable_Cache_Test, Forgets_Values_When_Cleared)
+{
+    Policy const policy{.mode = Policy::Mode::Session};
+
+    EXPECT_EQ(get_value(policy, "value"), "value");
+    cache_.clear();
+    EXPECT_EQ(get_value(policy, "value"), "value");
+
+    EXPECT_EQ(runs(), 2U);
+}
+
+}    // namespace Linter
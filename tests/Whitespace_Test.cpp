@@ -0,0 +1,32 @@
+#include "Whitespace.h"
+
+#include <gtest/gtest.h>
+
+namespace Linter
+{
+
+namespace
+{
+
+TEST(Whitespace_Test, Collapses_Runs_Of_Whitespace)
+{
+    EXPECT_EQ(Whitespace::collapse(L"a  b\t\tc\r\nd"), L"a b c d");
+}
+
+TEST(Whitespace_Test, Trims_The_Ends)
+{
+    EXPECT_EQ(Whitespace::collapse(L"\n   --quiet %%\n  "), L"--quiet %%");
+}
+
+TEST(Whitespace_Test, Leaves_Normal_Text_Alone)
+{
+    EXPECT_EQ(
+        Whitespace::collapse(L"--format checkstyle"), L"--format checkstyle"
+    );
+    EXPECT_EQ(Whitespace::collapse(L""), L"");
+    EXPECT_EQ(Whitespace::collapse(L" \t\r\n"), L"");
+}
+
+}    // namespace
+
+}    // namespace Linter
@@ -0,0 +1,65 @@
+#include "Checkstyle_Parser.h"
+
+#include "Error_Info.h"
+
+#include "Workloads.h"
+
+#include <benchmark/benchmark.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace Linter
+{
+
+namespace
+{
+
+void BM_Checkstyle_Get_Errors(benchmark::State &state)
+{
+    auto const errors = static_cast<std::size_t>(state.range(0));
+    auto const document = Workloads::checkstyle_document(errors, 5000);
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(Checkstyle_Parser::get_errors(document));
+    }
+    state.SetBytesProcessed(
+        static_cast<std::int64_t>(state.iterations() * document.size())
+    );
+    state.SetItemsProcessed(
+        static_cast<std::int64_t>(state.iterations() * errors)
+    );
+}
+
+void BM_Checkstyle_Get_Errors_Streamed(benchmark::State &state)
+{
+    auto const errors = static_cast<std::size_t>(state.range(0));
+    auto const document = Workloads::checkstyle_document(errors, 5000);
+    for (auto _ : state)
+    {
+        std::size_t found = 0;
+        Checkstyle_Parser::get_errors(
+            document, [&found](Error_Info &&) { found += 1; }
+        );
+        benchmark::DoNotOptimize(found);
+    }
+    state.SetBytesProcessed(
+        static_cast<std::int64_t>(state.iterations() * document.size())
+    );
+    state.SetItemsProcessed(
+        static_cast<std::int64_t>(state.iterations() * errors)
+    );
+}
+
+BENCHMARK(BM_Checkstyle_Get_Errors)
+    ->Arg(100)
+    ->Arg(100'000)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_Checkstyle_Get_Errors_Streamed)
+    ->Arg(100'000)
+    ->Unit(benchmark::kMillisecond);
+
+}    // namespace
+
+}    // namespace Linter
@@ -0,0 +1,95 @@
+#include "Encoding.h"
+
+#include "Workloads.h"
+
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <string>
+
+namespace Linter
+{
+
+namespace
+{
+
+/** Which text to convert */
+enum Text : std::int64_t
+{
+    Ascii,
+    Mixed,
+    Pathological
+};
+
+std::string make_text(benchmark::State const &state)
+{
+    auto const bytes = static_cast<std::size_t>(state.range(1));
+    switch (state.range(0))
+    {
+        case Ascii:
+            return Workloads::source_text(bytes, 0);
+
+        case Mixed:
+            return Workloads::source_text(bytes, 3);
+
+        default:
+            return Workloads::pathological_utf8(bytes);
+    }
+}
+
+void set_label(benchmark::State &state)
+{
+    static char const *const Labels[] = {"ascii", "mixed", "pathological"};
+    state.SetLabel(Labels[state.range(0)]);
+}
+
+void BM_UTF8_To_UTF16(benchmark::State &state)
+{
+    auto const text = make_text(state);
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(Encoding::convert(text));
+    }
+    state.SetBytesProcessed(
+        static_cast<std::int64_t>(state.iterations() * text.size())
+    );
+    set_label(state);
+}
+
+void BM_UTF16_To_UTF8(benchmark::State &state)
+{
+    auto const text = Encoding::convert(make_text(state));
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(Encoding::convert(text));
+    }
+    state.SetBytesProcessed(static_cast<std::int64_t>(
+        state.iterations() * text.size() * sizeof(wchar_t)
+    ));
+    set_label(state);
+}
+
+void BM_ASCII_Prefix_Length(benchmark::State &state)
+{
+    auto const text = Workloads::source_text(
+        static_cast<std::size_t>(state.range(0)), 0
+    );
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(Encoding::ascii_prefix_length(text));
+    }
+    state.SetBytesProcessed(
+        static_cast<std::int64_t>(state.iterations() * text.size())
+    );
+}
+
+// A typical buffer, and a large one, of each kind of text
+BENCHMARK(BM_UTF8_To_UTF16)
+    ->ArgsProduct({{Ascii, Mixed, Pathological}, {64 << 10, 16 << 20}});
+BENCHMARK(BM_UTF16_To_UTF8)
+    ->ArgsProduct({{Ascii, Mixed, Pathological}, {64 << 10, 16 << 20}});
+BENCHMARK(BM_ASCII_Prefix_Length)->Arg(80)->Arg(64 << 10);
+
+}    // namespace
+
+}    // namespace Linter
@@ -0,0 +1,115 @@
+#include "Error_Highlights.h"
+
+#include <benchmark/benchmark.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <random>
+
+namespace Linter
+{
+
+namespace
+{
+
+/** Counts the messages that would be sent to scintilla */
+class Counting_Editor : public Highlight_Editor
+{
+  public:
+    void clear(std::intptr_t /*position*/) override
+    {
+        messages_ += 1;
+    }
+
+    void set_colour(std::uint32_t /*colour*/) override
+    {
+        messages_ += 1;
+    }
+
+    void fill(std::intptr_t /*position*/) override
+    {
+        messages_ += 1;
+    }
+
+    std::size_t messages() const noexcept
+    {
+        return messages_;
+    }
+
+  private:
+    std::size_t messages_ = 0;
+};
+
+/** Indicators for errors scattered through a large file, in three colours */
+Error_Highlights scattered_errors(std::size_t errors, std::mt19937 &random)
+{
+    std::uniform_int_distribution<std::intptr_t> position{0, 50'000'000};
+    std::uniform_int_distribution<std::uint32_t> colour{0, 2};
+    Error_Highlights highlights;
+    while (highlights.size() < errors)
+    {
+        highlights.insert_or_assign(
+            position(random), Error_Highlight{.colour = colour(random)}
+        );
+    }
+    return highlights;
+}
+
+/** Relint a file with 10,000 errors, when the given number of errors out of
+ * every thousand have been fixed and replaced by new ones.
+ *
+ * messages is the number of messages sent to scintilla for each update, and
+ * repaint_messages is how many clearing and redrawing them all would take.
+ */
+void BM_Error_Highlights_Relint(benchmark::State &state)
+{
+    constexpr std::size_t Errors = 10'000;
+    auto const changed_per_thousand = static_cast<std::size_t>(state.range(0));
+
+    std::mt19937 random{1};
+    auto const shown = scattered_errors(Errors, random);
+    auto wanted = shown;
+    if (changed_per_thousand != 0)
+    {
+        std::size_t index = 0;
+        std::erase_if(
+            wanted,
+            [&index, changed_per_thousand](auto const &) noexcept
+            { return index++ % (1000 / changed_per_thousand) == 0; }
+        );
+        auto const replacements =
+            scattered_errors(Errors * changed_per_thousand / 1000, random);
+        wanted.insert(replacements.begin(), replacements.end());
+    }
+
+    Counting_Editor editor;
+    for (auto _ : state)
+    {
+        update_highlights(editor, shown, wanted, true);
+    }
+
+    Counting_Editor repaint;
+    update_highlights(repaint, {}, wanted, true);
+
+    state.SetItemsProcessed(
+        static_cast<std::int64_t>(state.iterations() * Errors)
+    );
+    state.counters["messages"] = benchmark::Counter(
+        static_cast<double>(editor.messages())
+        / static_cast<double>(state.iterations())
+    );
+    // The whole document is cleared with one message.
+    state.counters["repaint_messages"] =
+        benchmark::Counter(static_cast<double>(repaint.messages() + 1));
+}
+
+BENCHMARK(BM_Error_Highlights_Relint)
+    ->Arg(0)
+    ->Arg(10)
+    ->Arg(1000)
+    ->Unit(benchmark::kMicrosecond);
+
+}    // namespace
+
+}    // namespace Linter
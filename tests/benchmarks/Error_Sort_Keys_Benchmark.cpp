@@ -0,0 +1,88 @@
+#include "Error_Sort_Keys.h"
+
+#include "Checkstyle_Parser.h"
+#include "Error_Info.h"
+#include "Error_Store.h"
+
+#include "Workloads.h"
+
+#include <benchmark/benchmark.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <numeric>
+#include <vector>
+
+namespace Linter
+{
+
+namespace
+{
+
+using Field = Error_Sort_Keys::Field;
+
+/** Sort 100k errors by a column, as clicking on a column heading does */
+void BM_Error_Sort_Keys_Sort(benchmark::State &state)
+{
+    Error_Store errors;
+    Checkstyle_Parser::get_errors(
+        Workloads::checkstyle_document(100'000, 5000),
+        [&errors](Error_Info &&error) { errors.add(error); }
+    );
+    Error_Sort_Keys keys;
+    for (std::size_t row = 0; row < errors.size(); row += 1)
+    {
+        keys.add(errors, row);
+    }
+    std::vector<Error_Sort_Keys::Sort_Field> const fields{
+        {.field = static_cast<Field>(state.range(0)), .descending = false}
+    };
+
+    std::vector<int> rows(errors.size());
+    for (auto _ : state)
+    {
+        std::iota(rows.begin(), rows.end(), 0);
+        keys.sort(rows, fields, errors);
+        benchmark::DoNotOptimize(rows.data());
+    }
+    state.SetItemsProcessed(
+        static_cast<std::int64_t>(state.iterations() * rows.size())
+    );
+
+    static char const *const Labels[] = {"line", "column", "tool", "message"};
+    state.SetLabel(Labels[state.range(0)]);
+}
+
+/** Build the keys as the errors arrive */
+void BM_Error_Sort_Keys_Add(benchmark::State &state)
+{
+    Error_Store errors;
+    Checkstyle_Parser::get_errors(
+        Workloads::checkstyle_document(100'000, 5000),
+        [&errors](Error_Info &&error) { errors.add(error); }
+    );
+    for (auto _ : state)
+    {
+        Error_Sort_Keys keys;
+        for (std::size_t row = 0; row < errors.size(); row += 1)
+        {
+            keys.add(errors, row);
+        }
+        benchmark::DoNotOptimize(keys);
+    }
+    state.SetItemsProcessed(
+        static_cast<std::int64_t>(state.iterations() * errors.size())
+    );
+}
+
+BENCHMARK(BM_Error_Sort_Keys_Sort)
+    ->DenseRange(
+        static_cast<std::int64_t>(Field::Line),
+        static_cast<std::int64_t>(Field::Message)
+    )
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_Error_Sort_Keys_Add)->Unit(benchmark::kMillisecond);
+
+}    // namespace
+
+}    // namespace Linter
@@ -0,0 +1,93 @@
+#include "Error_Store.h"
+
+#include "Checkstyle_Parser.h"
+#include "Error_Info.h"
+
+#include "Workloads.h"
+
+#include <benchmark/benchmark.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace Linter
+{
+
+namespace
+{
+
+/** Heap memory used by a string, if it's too long to be stored inline */
+template <typename String>
+std::size_t heap_bytes(String const &string)
+{
+    if (string.capacity() <= String{}.capacity())
+    {
+        return 0;
+    }
+    return (string.capacity() + 1) * sizeof(typename String::value_type);
+}
+
+/** Approximate memory used by an Error_Info, as the errors used to be kept */
+std::size_t error_info_bytes(Error_Info const &error)
+{
+    return sizeof(Error_Info) + heap_bytes(error.message_)
+         + heap_bytes(error.severity_) + heap_bytes(error.tool_)
+         + heap_bytes(error.command_) + heap_bytes(error.stdout_)
+         + heap_bytes(error.stderr_);
+}
+
+/** Store 100k errors from a linter, as they are parsed.
+ *
+ * bytes_per_error is the memory used by the store for each error, and
+ * error_info_bytes_per_error is what keeping each one as an Error_Info took.
+ */
+void BM_Error_Store_Add(benchmark::State &state)
+{
+    std::vector<Error_Info> errors;
+    Checkstyle_Parser::get_errors(
+        Workloads::checkstyle_document(100'000, 5000),
+        [&errors](Error_Info &&error)
+        {
+            error.command_ = L"\"C:\\Program Files\\nodejs\\node.exe\" "
+                             L"eslint.js --format checkstyle --stdin";
+            errors.push_back(std::move(error));
+        }
+    );
+
+    std::size_t bytes = 0;
+    for (auto _ : state)
+    {
+        Error_Store store;
+        for (auto const &error : errors)
+        {
+            store.add(error);
+        }
+        bytes = store.bytes();
+        benchmark::DoNotOptimize(bytes);
+    }
+
+    std::size_t error_info_bytes_total = 0;
+    for (auto const &error : errors)
+    {
+        error_info_bytes_total += error_info_bytes(error);
+    }
+
+    auto const count = static_cast<double>(errors.size());
+    state.SetItemsProcessed(
+        static_cast<std::int64_t>(state.iterations() * errors.size())
+    );
+    state.counters["bytes_per_error"] =
+        benchmark::Counter(static_cast<double>(bytes) / count);
+    state.counters["error_info_bytes_per_error"] = benchmark::Counter(
+        static_cast<double>(error_info_bytes_total) / count
+    );
+}
+
+BENCHMARK(BM_Error_Store_Add)->Unit(benchmark::kMillisecond);
+
+}    // namespace
+
+}    // namespace Linter
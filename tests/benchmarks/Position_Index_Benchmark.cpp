@@ -0,0 +1,116 @@
+#include "Position_Index.h"
+
+#include "Workloads.h"
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace Linter
+{
+
+namespace
+{
+
+/** Editor positions for a set of lines, as Scintilla would give them */
+class Buffer
+{
+  public:
+    explicit Buffer(std::vector<std::string> lines) : lines_(std::move(lines))
+    {
+        std::intptr_t start = 0;
+        for (auto const &line : lines_)
+        {
+            starts_.push_back(start);
+            start += static_cast<std::intptr_t>(line.size());
+        }
+    }
+
+    Position_Index index() const
+    {
+        return Position_Index{
+            [this](int line)
+            { return starts_[static_cast<std::size_t>(line)]; },
+            [this](int line) { return lines_[static_cast<std::size_t>(line)]; }
+        };
+    }
+
+    int lines() const noexcept
+    {
+        return static_cast<int>(lines_.size());
+    }
+
+  private:
+    std::vector<std::string> lines_;
+    std::vector<std::intptr_t> starts_;
+};
+
+/** Map errors scattered through a large file, in line order, as happens
+ * when the results are shown.
+ */
+void BM_Position_Index_Errors(benchmark::State &state)
+{
+    Buffer const buffer{Workloads::source_lines(Workloads::source_text(
+        4 << 20, static_cast<std::size_t>(state.range(0))
+    ))};
+
+    std::mt19937 random{1};
+    std::uniform_int_distribution<int> line{1, buffer.lines()};
+    std::uniform_int_distribution<int> column{1, 60};
+    std::vector<std::pair<int, int>> errors(100'000);
+    for (auto &error : errors)
+    {
+        error = {line(random), column(random)};
+    }
+    std::ranges::sort(errors);
+
+    for (auto _ : state)
+    {
+        auto index = buffer.index();
+        for (auto const &[error_line, error_column] : errors)
+        {
+            benchmark::DoNotOptimize(index.position(error_line, error_column));
+        }
+    }
+    state.SetItemsProcessed(
+        static_cast<std::int64_t>(state.iterations() * errors.size())
+    );
+    state.SetLabel(state.range(0) == 0 ? "ascii" : "mixed");
+}
+
+/** Many errors on one very long line, as with minified files */
+void BM_Position_Index_Long_Line(benchmark::State &state)
+{
+    auto text = Workloads::pathological_utf8(1 << 20);
+    text += '\n';
+    Buffer const buffer{{text}};
+    auto const columns = static_cast<int>(text.size());
+
+    for (auto _ : state)
+    {
+        auto index = buffer.index();
+        for (int column = 1; column < columns; column += 97)
+        {
+            benchmark::DoNotOptimize(index.position(1, column));
+        }
+    }
+    state.SetItemsProcessed(
+        static_cast<std::int64_t>(state.iterations() * (columns / 97))
+    );
+}
+
+BENCHMARK(BM_Position_Index_Errors)
+    ->Arg(0)
+    ->Arg(3)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_Position_Index_Long_Line)->Unit(benchmark::kMillisecond);
+
+}    // namespace
+
+}    // namespace Linter
@@ -0,0 +1,37 @@
+#include "Whitespace.h"
+
+#include "Workloads.h"
+
+#include <benchmark/benchmark.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace Linter
+{
+
+namespace
+{
+
+/** Normalise the arguments of a command, as reading the settings does */
+void BM_Whitespace_Collapse(benchmark::State &state)
+{
+    auto const args = Workloads::command_arguments(
+        static_cast<std::size_t>(state.range(0))
+    );
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(Whitespace::collapse(args));
+    }
+    state.SetBytesProcessed(static_cast<std::int64_t>(
+        state.iterations() * args.size() * sizeof(wchar_t)
+    ));
+}
+
+// A typical command, and a silly one
+BENCHMARK(BM_Whitespace_Collapse)->Arg(1)->Arg(1000);
+
+}    // namespace
+
+}    // namespace Linter
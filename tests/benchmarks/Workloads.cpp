@@ -0,0 +1,149 @@
+#include "Workloads.h"
+
+#include <cstddef>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace Linter::Workloads
+{
+
+namespace
+{
+
+// Fixed so the workloads are the same from run to run
+constexpr unsigned int Seed = 12345;
+
+}    // namespace
+
+std::string source_text(std::size_t bytes, std::size_t non_ascii_every)
+{
+    static constexpr std::string_view Lines[] = {
+        "function example(value) {\n",
+        "    if (value === undefined) { return null; }\n",
+        "    const result = compute(value, options.threshold * 2);\n",
+        "    // Some explanation of what is going on here\n",
+        "    return result.map((item) => item.name).join(', ');\n",
+        "}\n",
+        "\n"
+    };
+    static constexpr std::string_view Non_Ascii_Line =
+        "    const label = 'caf\xC3\xA9 \xE6\x97\xA5\xE6\x9C\xAC "
+        "\xF0\x9F\x98\x80 na\xC3\xAFve'; // \xC3\xA9t\xC3\xA9\n";
+
+    std::string text;
+    text.reserve(bytes + Non_Ascii_Line.size());
+    for (std::size_t line = 0; text.size() < bytes; line += 1)
+    {
+        if (non_ascii_every != 0 and line % non_ascii_every == 0)
+        {
+            text += Non_Ascii_Line;
+        }
+        else
+        {
+            text += Lines[line % std::size(Lines)];
+        }
+    }
+    return text;
+}
+
+std::vector<std::string> source_lines(std::string const &text)
+{
+    std::vector<std::string> lines;
+    std::size_t start = 0;
+    while (start < text.size())
+    {
+        auto end = text.find('\n', start);
+        end = end == std::string::npos ? text.size() : end + 1;
+        lines.emplace_back(text.substr(start, end - start));
+        start = end;
+    }
+    return lines;
+}
+
+std::string checkstyle_document(std::size_t errors, int lines)
+{
+    static constexpr std::string_view Tools[] = {
+        "eslint.rules.no-unused-vars",
+        "eslint.rules.max-len",
+        "jshint.W101",
+        "jscs",
+        "stylelint.rules.indentation"
+    };
+    static constexpr std::string_view Messages[] = {
+        "'value' is defined but never used.",
+        "Line 12 exceeds the maximum line length of 80.",
+        "Expected &apos;===&apos; and instead saw &apos;==&apos;.",
+        "Missing &quot;use strict&quot; statement.",
+        "Unexpected character &lt;caf\xC3\xA9&gt; \xF0\x9F\x98\x80 in "
+        "identifier"
+    };
+    static constexpr std::string_view Severities[] = {
+        "error", "warning", "info"
+    };
+
+    std::mt19937 random{Seed};
+    std::uniform_int_distribution<int> line{1, lines};
+    std::uniform_int_distribution<int> column{1, 120};
+
+    std::string document{
+        "<?xml version=\"1.0\" encoding=\"utf-8\"?>\n"
+        "<checkstyle version=\"4.3\">\n"
+        "<file name=\"C:\\Users\\someone\\project\\src\\example.js\">\n"
+    };
+    document.reserve(errors * 180);
+    for (std::size_t error = 0; error < errors; error += 1)
+    {
+        document += "<error line=\"" + std::to_string(line(random))
+                  + "\" column=\"" + std::to_string(column(random))
+                  + "\" severity=\"";
+        document += Severities[error % std::size(Severities)];
+        document += "\" message=\"";
+        document += Messages[random() % std::size(Messages)];
+        document += "\" source=\"";
+        document += Tools[random() % std::size(Tools)];
+        document += "\" />\n";
+    }
+    document += "</file>\n</checkstyle>\n";
+    return document;
+}
+
+std::string pathological_utf8(std::size_t bytes)
+{
+    static constexpr std::string_view Pieces[] = {
+        "\xC3\xA9",            // 2 bytes
+        "\xE2\x82\xAC",        // 3 bytes
+        "\xF0\x9F\x98\x80",    // 4 bytes
+        "\x80",                // Lone continuation byte
+        "\xC0\xAF",            // Overlong
+        "\xED\xA0\x80",        // Encoded surrogate
+        "\xF4\x90\x80\x80",    // Past U+10FFFF
+        "\xE2\x82",            // Truncated
+        "\xFF",                // Never valid
+        "a"
+    };
+
+    std::mt19937 random{Seed};
+    std::string text;
+    text.reserve(bytes + 4);
+    while (text.size() < bytes)
+    {
+        text += Pieces[random() % std::size(Pieces)];
+    }
+    return text;
+}
+
+std::wstring command_arguments(std::size_t repeats)
+{
+    std::wstring args;
+    for (std::size_t repeat = 0; repeat < repeats; repeat += 1)
+    {
+        args += L"\n        --format checkstyle\r\n"
+                L"        --config \"%LINTER_DIR%\\.eslintrc.json\"\t\t\n"
+                L"        --rule   max-len:120    --quiet  ";
+    }
+    return args + L"\n    %%\n";
+}
+
+}    // namespace Linter::Workloads
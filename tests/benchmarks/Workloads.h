@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace Linter::Workloads
+{
+
+/** Source code like text of about the given size.
+ *
+ * One line in every non_ascii_every contains some accented letters, CJK and
+ * an emoji, so it can be used for mostly ASCII or mixed text. 0 gives pure
+ * ASCII.
+ */
+std::string source_text(std::size_t bytes, std::size_t non_ascii_every);
+
+/** The same text split into lines, each including its line end */
+std::vector<std::string> source_lines(std::string const &text);
+
+/** A checkstyle document with the given number of errors, spread over the
+ * given number of lines, with a mix of tools and messages and some entities
+ * and non-ASCII text in the messages.
+ */
+std::string checkstyle_document(std::size_t errors, int lines);
+
+/** UTF-8 which is as awkward as possible to convert: no runs of ASCII, every
+ * length of sequence, and invalid bytes, overlong forms, encoded surrogates
+ * and truncated sequences.
+ */
+std::string pathological_utf8(std::size_t bytes);
+
+/** Linter arguments as they might be laid out over several lines in the
+ * configuration file, repeated to make something long.
+ */
+std::wstring command_arguments(std::size_t repeats);
+
+}    // namespace Linter::Workloads
@@ -0,0 +1,18 @@
+#!/bin/sh
+# Stand-in persistent linter: for each request, replies with the text of the
+# file as the checkstyle output and the path as the error output. A path of
+# "exit" makes it exit with status 3 without replying.
+body=$(mktemp)
+trap 'rm -f "$body"' EXIT
+while IFS= read -r path
+do
+    IFS= read -r size
+    head -c "$size" > "$body"
+    if [ "$path" = exit ]
+    then
+        exit 3
+    fi
+    printf '%s %s\n' "$size" "$(($(printf '%s' "$path" | wc -c)))"
+    cat "$body"
+    printf '%s' "$path"
+done
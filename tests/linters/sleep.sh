@@ -0,0 +1,12 @@
+#!/bin/sh
+# Stand-in linter which takes a known time: sleeps for the number of seconds
+# given, then reports one error.
+sleep "$1"
+cat <<END
+<?xml version="1.0" encoding="UTF-8"?>
+<checkstyle version="4.3">
+<file name="test.js">
+<error line="1" column="1" severity="warning" message="Slept for $1 seconds" source="sleep"/>
+</file>
+</checkstyle>
+END
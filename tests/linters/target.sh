@@ -0,0 +1,5 @@
+#!/bin/sh
+# Stand-in linter which reads %LINTER_TARGET%: outputs the name of the file it
+# was given, then what the file contains.
+echo "$LINTER_TARGET"
+cat "$LINTER_TARGET"
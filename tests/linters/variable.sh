@@ -0,0 +1,5 @@
+#!/bin/sh
+# Stand-in <variable> command: notes that it has been run by adding a line to
+# the file given as the first argument, then outputs the second argument.
+echo run >> "$1"
+echo "$2"
@@ -0,0 +1,6 @@
+#pragma once
+
+// Just enough of the Windows headers for the portable parts of the plugin to
+// build on Linux.
+
+using DWORD = unsigned long;
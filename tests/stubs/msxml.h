@@ -0,0 +1,14 @@
+#pragma once
+
+#include <wtypes.h>
+
+// NOLINTNEXTLINE(cppcoreguidelines-virtual-class-destructor)
+struct IXMLDOMParseError
+{
+    virtual long get_errorCode(long *) = 0;
+    virtual long get_url(BSTR *) = 0;
+    virtual long get_reason(BSTR *) = 0;
+    virtual long get_srcText(BSTR *) = 0;
+    virtual long get_line(long *) = 0;
+    virtual long get_linepos(long *) = 0;
+};
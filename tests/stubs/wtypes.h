@@ -0,0 +1,3 @@
+#pragma once
+
+using BSTR = wchar_t *;